@@ -0,0 +1,1581 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "fe_api.h"
+#include "fe_core.h"
+#include "bch_wrapper.h"
+#include "fe_thread.h"
+#include "fe_timer.h"
+#include "fe_kdf.h"
+#include "fe_stats.h"
+#include "../lib/bch.h"
+
+#ifndef FE_BENCH_REV
+#define FE_BENCH_REV "unknown"
+#endif
+
+/* =================================================================
+ * [fe_bench] 재현 가능한 성능 측정 (커밋 간 회귀 추적용)
+ * - 단조 나노초 시계 또는 rdtsc (--clock)
+ * - 측정 전 워밍업, CPU 고정, 시행 횟수 지정
+ * - 에러 수별 reproduce 분포 + 단계별(BCH 복호 / 키 유도) 중앙값
+ * - 키 유도(SHA3-256) 단독 지연 / 처리량 + 알려진 답 검사, multi-buffer lane 수별 키당 시간
+ * - 난수는 자체 PRNG (플랫폼별 rand() 차이 없이 같은 seed = 같은 입력)
+ * - FE_STATS 빌드면 --stats로 reproduce 단계별 히스토그램 출력
+ * - 복구 실패 경로(타인 probe, 오류 > t) 지연은 조기 거절 / 전체 근 찾기 별도 출력
+ * - --leakage N: dudect 방식 타이밍 누설 검정 (고정 / 무작위 오류 수 클래스, Welch t)
+ * - fe_bench MODE: bitsliced / ct / stream / multi / gallery / store / tables 비교 측정
+ * ================================================================= */
+
+typedef struct {
+    int trials;
+    int warmup;
+    int min_errors;
+    int max_errors;
+    int cpu;            // -1: 고정 안 함
+    int use_tsc;
+    uint64_t seed;
+    const char *stats_path;     // 계측 히스토그램 출력 ("-" = stderr)
+    long long leakage;          // 누설 검정 반복 수 (0 = 일반 측정)
+    int leak_fixed;             // 고정 클래스 오류 수
+    fe_ctx_params params;
+} bench_opts;
+
+typedef struct {
+    double mean, median, p05, p95, stddev;
+} bench_stats;
+
+/* ===== [PRNG] splitmix64 ===== */
+static uint64_t rng_state;
+
+static uint64_t rng_next(void) {
+    uint64_t z = (rng_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void rng_fill(uint8_t *buf, size_t len) {
+    for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)rng_next();
+}
+
+// 서로 다른 위치 error_cnt개 비트 반전 (부분 Fisher-Yates)
+static void flip_random_bits(uint8_t *data, int len, int error_cnt) {
+    static int idx[FE_MULTI_MAX_BLOCKS * FE_DATA_BYTES * 8];   // multi: 템플릿 전체
+    int total_bits = len * 8;
+    for (int i = 0; i < total_bits; i++) idx[i] = i;
+    for (int i = 0; i < error_cnt && i < total_bits; i++) {
+        int j = i + (int)(rng_next() % (uint64_t)(total_bits - i));
+        int t = idx[i]; idx[i] = idx[j]; idx[j] = t;
+        data[idx[i] / 8] ^= (uint8_t)(1 << (idx[i] % 8));
+    }
+}
+
+/* ===== [Clock] ns 또는 TSC ===== */
+static int clock_tsc = 0;
+static double tsc_per_us = 1000.0;
+
+static inline uint64_t bench_now(void) {
+    return clock_tsc ? fe_cycles() : fe_time_ns();
+}
+
+static inline double bench_us(uint64_t start, uint64_t end) {
+    return (double)(end - start) / tsc_per_us;
+}
+
+// TSC 주파수 추정 (단조 시계 기준 50ms)
+static void calibrate_tsc(void) {
+    uint64_t t0 = fe_time_ns(), c0 = fe_cycles(), t1, c1;
+    do {
+        t1 = fe_time_ns();
+    } while (t1 - t0 < 50000000ull);
+    c1 = fe_cycles();
+    tsc_per_us = (double)(c1 - c0) * 1000.0 / (double)(t1 - t0);
+}
+
+/* ===== [Stats] ===== */
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+static void summarize(double *times, int n, bench_stats *st) {
+    double sum = 0.0, var = 0.0;
+    qsort(times, n, sizeof(double), compare_doubles);
+    for (int i = 0; i < n; i++) sum += times[i];
+    st->mean = sum / n;
+    st->median = times[n / 2];
+    st->p05 = times[(int)(n * 0.05)];
+    st->p95 = times[(int)(n * 0.95)];
+    for (int i = 0; i < n; i++) var += (times[i] - st->mean) * (times[i] - st->mean);
+    st->stddev = sqrt(var / n);
+}
+
+static double median_of(double *times, int n) {
+    qsort(times, n, sizeof(double), compare_doubles);
+    return times[n / 2];
+}
+
+/* ===== [Options] ===== */
+static void usage(const char *prog) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "       %s MODE [args]\n"
+        "  --trials N        측정 시행 수 (에러 수마다, 기본 1000)\n"
+        "  --warmup N        측정 전 버리는 시행 수 (기본 100)\n"
+        "  --errors A[:B]    에러 수 범위 (기본 0:%d)\n"
+        "  --cpu K           K번 코어에 고정 (-1: 고정 안 함, 기본 0)\n"
+        "  --clock ns|tsc    시계 (기본 ns)\n"
+        "  --seed S          PRNG seed (기본 12345)\n"
+        "  --roots auto|bta|chien\n"
+        "  --encoder auto|table|clmul\n"
+        "  --slice 4|8|16    테이블 인코더 폭\n"
+        "  --kernel auto|generic  m=13,t=64 특화 커널 / 범용 경로\n"
+        "  --reject early|full    오류 > t 조기 거절 / 근 찾기 끝까지 수행\n"
+        "  --tables PATH     미리 만든 테이블 파일 매핑 (fe_bench tables write, 맞지 않으면 계산)\n"
+        "  --stats PATH      단계별 계측 히스토그램 출력 (- = stderr, FE_STATS 빌드)\n"
+        "  --leakage N       일반 측정 대신 타이밍 누설 검정 N회 (scalar / 상수 시간 디코더)\n"
+        "  --leak-fixed W    누설 검정 고정 클래스 오류 수 (기본 0, 무작위 클래스는 0..%d)\n"
+        "modes:\n"
+        "  bitsliced [N]     에러 수별 scalar vs bitsliced 배치 디코더 처리량 (N: 워커 수, 기본 1)\n"
+        "  ct [N]            에러 수별 scalar vs 상수 시간 디코더 단건 분포 (N: 에러 수당 시행, 기본 200)\n"
+        "  stream            조각 크기별 스트리밍 enroll 지연\n"
+        "  multi [T]         8 / 16 / 32 kbit 다중 블록 reproduce, 버스트 복원율 (T: 워커 수)\n"
+        "  gallery [E] [N] [M]  1:N 식별, 갤러리 E건, 워커 N, prescreen 차수 상한 M\n"
+        "  store [E] [PATH]  등록 저장소 파일 E건: 쓰기 / 열기 / 배치 reproduce / 갤러리\n"
+        "  tables write PATH [CFG]  미리 만든 BCH 테이블 파일 저장 (auto / table4 / table8 / table16 / clmul)\n"
+        "  tables bench PATH [CFG]  컨텍스트 생성 시간: 테이블 계산 vs 파일 매핑\n",
+        prog, prog, SYS_T, SYS_T);
+}
+
+static int parse_opts(int argc, char **argv, bench_opts *o) {
+    o->trials = 1000;
+    o->warmup = 100;
+    o->min_errors = 0;
+    o->max_errors = SYS_T;
+    o->cpu = 0;
+    o->use_tsc = 0;
+    o->seed = 12345;
+    o->stats_path = NULL;
+    o->leakage = 0;
+    o->leak_fixed = 0;
+    fe_ctx_params_default(&o->params);
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!v) return -1;
+        i++;
+        if (strcmp(a, "--trials") == 0) {
+            o->trials = atoi(v);
+        } else if (strcmp(a, "--warmup") == 0) {
+            o->warmup = atoi(v);
+        } else if (strcmp(a, "--errors") == 0) {
+            const char *c = strchr(v, ':');
+            o->min_errors = atoi(v);
+            o->max_errors = c ? atoi(c + 1) : o->min_errors;
+        } else if (strcmp(a, "--cpu") == 0) {
+            o->cpu = atoi(v);
+        } else if (strcmp(a, "--clock") == 0) {
+            if (strcmp(v, "tsc") == 0) o->use_tsc = 1;
+            else if (strcmp(v, "ns") == 0) o->use_tsc = 0;
+            else return -1;
+        } else if (strcmp(a, "--seed") == 0) {
+            o->seed = strtoull(v, NULL, 10);
+        } else if (strcmp(a, "--roots") == 0) {
+            if (strcmp(v, "auto") == 0) o->params.root_finder = FE_ROOTS_AUTO;
+            else if (strcmp(v, "bta") == 0) o->params.root_finder = FE_ROOTS_BTA;
+            else if (strcmp(v, "chien") == 0) o->params.root_finder = FE_ROOTS_CHIEN;
+            else return -1;
+        } else if (strcmp(a, "--encoder") == 0) {
+            if (strcmp(v, "auto") == 0) o->params.encoder = FE_ENC_AUTO;
+            else if (strcmp(v, "table") == 0) o->params.encoder = FE_ENC_TABLE;
+            else if (strcmp(v, "clmul") == 0) o->params.encoder = FE_ENC_CLMUL;
+            else return -1;
+        } else if (strcmp(a, "--kernel") == 0) {
+            if (strcmp(v, "auto") == 0) o->params.kernel = FE_KERNEL_AUTO;
+            else if (strcmp(v, "generic") == 0) o->params.kernel = FE_KERNEL_GENERIC;
+            else return -1;
+        } else if (strcmp(a, "--reject") == 0) {
+            if (strcmp(v, "early") == 0) o->params.reject = FE_REJECT_EARLY;
+            else if (strcmp(v, "full") == 0) o->params.reject = FE_REJECT_FULL;
+            else return -1;
+        } else if (strcmp(a, "--tables") == 0) {
+            o->params.tables_path = v;
+        } else if (strcmp(a, "--stats") == 0) {
+            o->stats_path = v;
+        } else if (strcmp(a, "--leakage") == 0) {
+            o->leakage = atoll(v);
+        } else if (strcmp(a, "--leak-fixed") == 0) {
+            o->leak_fixed = atoi(v);
+        } else if (strcmp(a, "--slice") == 0) {
+            o->params.slice_bytes = atoi(v);
+        } else {
+            return -1;
+        }
+    }
+    if (o->trials < 1 || o->warmup < 0) return -1;
+    if (o->leakage < 0 || o->leak_fixed < 0 || o->leak_fixed > SYS_T) return -1;
+    if (o->min_errors < 0 || o->max_errors > FE_DATA_BYTES * 8 || o->min_errors > o->max_errors) return -1;
+    return 0;
+}
+
+static const char *encoder_name(const struct bch_control *bch) {
+    return (bch->encoder == BCH_ENC_CLMUL) ? "clmul" : "table";
+}
+
+/* ===== [Enroll] 전체 / BCH 인코딩 / 키 유도 ===== */
+static void bench_enroll(fe_ctx *ctx, struct bch_workspace *ws, const bench_opts *o) {
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key[FE_KEY_LEN];
+    size_t h_len, k_len;
+    FE_Key fk;
+    double *total = (double *)malloc(o->trials * sizeof(double));
+    double *encode = (double *)malloc(o->trials * sizeof(double));
+    double *kdf = (double *)malloc(o->trials * sizeof(double));
+    bench_stats st;
+
+    if (!total || !encode || !kdf) {
+        printf("# allocation failed!\n");
+        goto out;
+    }
+
+    for (int t = -o->warmup; t < o->trials; t++) {
+        uint64_t t0, t1;
+        rng_fill(input, FE_DATA_BYTES);
+
+        h_len = FE_HELPER_BYTES;
+        k_len = FE_KEY_LEN;
+        t0 = bench_now();
+        fe_enroll_ctx(ctx, input, FE_DATA_BYTES, helper, &h_len, key, &k_len);
+        t1 = bench_now();
+        if (t < 0) continue;
+        total[t] = bench_us(t0, t1);
+
+        t0 = bench_now();
+        fe_bch_encode(ctx->bch, ws, input, helper);
+        t1 = bench_now();
+        encode[t] = bench_us(t0, t1);
+
+        t0 = bench_now();
+        FE_Derive_Key(input, helper + FE_ECC_BYTES, &fk);
+        t1 = bench_now();
+        kdf[t] = bench_us(t0, t1);
+    }
+
+    summarize(total, o->trials, &st);
+    printf("# enroll,attempts=%d,mean_us=%.3f,median_us=%.3f,p05_us=%.3f,p95_us=%.3f,stddev_us=%.3f,"
+           "throughput_per_sec=%.1f,encode_median_us=%.3f,kdf_median_us=%.3f\n",
+           o->trials, st.mean, st.median, st.p05, st.p95, st.stddev, 1e6 / st.mean,
+           median_of(encode, o->trials), median_of(kdf, o->trials));
+
+out:
+    free(kdf);
+    free(encode);
+    free(total);
+}
+
+/* ===== [KDF] multi-buffer: 64건을 lane 수(1/4/8)씩 묶어 처리, 키당 시간 ===== */
+#define KDF_MULTI_N  64
+
+static void bench_kdf_multi(const bench_opts *o, double *times) {
+    static const unsigned int lanes[] = { 1, 4, 8 };
+    uint8_t *data = (uint8_t *)malloc(KDF_MULTI_N * FE_DATA_BYTES);
+    uint8_t *salt = (uint8_t *)malloc(KDF_MULTI_N * FE_SALT_BYTES);
+    uint8_t *keys = (uint8_t *)malloc(KDF_MULTI_N * FE_KEY_LEN);
+    const uint8_t *dp[KDF_MULTI_N], *sp[KDF_MULTI_N];
+    uint8_t *kp[KDF_MULTI_N];
+    bench_stats st;
+
+    if (!data || !salt || !keys) {
+        printf("# allocation failed!\n");
+        goto out;
+    }
+    for (int i = 0; i < KDF_MULTI_N; i++) {
+        dp[i] = data + i * FE_DATA_BYTES;
+        sp[i] = salt + i * FE_SALT_BYTES;
+        kp[i] = keys + i * FE_KEY_LEN;
+    }
+
+    double base = 0.0;
+    for (size_t l = 0; l < sizeof(lanes) / sizeof(lanes[0]); l++) {
+        if (fe_sha3_lanes(lanes[l]) != lanes[l]) {
+            printf("# kdf_multi,lanes=%u,not supported on this CPU\n", lanes[l]);
+            continue;
+        }
+        int mismatch = 0;
+        for (int t = -o->warmup; t < o->trials; t++) {
+            rng_fill(data, KDF_MULTI_N * FE_DATA_BYTES);
+            rng_fill(salt, KDF_MULTI_N * FE_SALT_BYTES);
+            uint64_t t0 = bench_now();
+            fe_sha3_256_multi(lanes[l], KDF_MULTI_N, sp, FE_SALT_BYTES, dp, FE_DATA_BYTES, kp);
+            uint64_t t1 = bench_now();
+            if (t < 0) continue;
+            times[t] = bench_us(t0, t1) / KDF_MULTI_N;
+
+            // 첫 시행만 단건 경로와 비교
+            if (t == 0) {
+                FE_Key fk;
+                for (int i = 0; i < KDF_MULTI_N; i++) {
+                    FE_Derive_Key(dp[i], sp[i], &fk);
+                    if (memcmp(fk.key, kp[i], FE_KEY_LEN) != 0) mismatch++;
+                }
+            }
+        }
+        summarize(times, o->trials, &st);
+        if (lanes[l] == 1) base = st.median;
+        printf("# kdf_multi,lanes=%u,keys=%d,median_us_per_key=%.3f,p05_us=%.3f,p95_us=%.3f,"
+               "keys_per_sec=%.1f,speedup=%.2f,mismatch=%d\n",
+               lanes[l], KDF_MULTI_N, st.median, st.p05, st.p95, 1e6 / st.median,
+               base > 0.0 ? base / st.median : 0.0, mismatch);
+    }
+
+out:
+    free(keys);
+    free(salt);
+    free(data);
+}
+
+/* ===== [KDF] SHA3-256(salt || data) 단독 ===== */
+static void bench_kdf(const bench_opts *o) {
+    // FIPS 202 SHA3-256("abc")
+    static const uint8_t kat_abc[FE_SHA3_256_BYTES] = {
+        0x3a, 0x98, 0x5d, 0xa7, 0x4f, 0xe2, 0x25, 0xb2, 0x04, 0x5c, 0x17, 0x2d, 0x6b, 0xd3, 0x90, 0xbd,
+        0x85, 0x5f, 0x08, 0x6e, 0x3e, 0x9d, 0x52, 0x5b, 0x46, 0xbf, 0xe2, 0x45, 0x11, 0x43, 0x15, 0x32,
+    };
+    uint8_t data[FE_DATA_BYTES];
+    uint8_t salt[FE_SALT_BYTES];
+    uint8_t digest[FE_SHA3_256_BYTES];
+    FE_Key fk;
+    double *kdf = (double *)malloc(o->trials * sizeof(double));
+    bench_stats st;
+
+    if (!kdf) {
+        printf("# allocation failed!\n");
+        return;
+    }
+    fe_sha3_256((const uint8_t *)"abc", 3, digest);
+    int kat_ok = memcmp(digest, kat_abc, sizeof(kat_abc)) == 0;
+
+    rng_fill(salt, FE_SALT_BYTES);
+    for (int t = -o->warmup; t < o->trials; t++) {
+        rng_fill(data, FE_DATA_BYTES);
+        uint64_t t0 = bench_now();
+        FE_Derive_Key(data, salt, &fk);
+        uint64_t t1 = bench_now();
+        if (t >= 0) kdf[t] = bench_us(t0, t1);
+    }
+
+    summarize(kdf, o->trials, &st);
+    printf("# kdf,impl=sha3-256,bytes=%d,kat=%s,mean_us=%.3f,median_us=%.3f,p05_us=%.3f,p95_us=%.3f,"
+           "mb_per_sec=%.1f\n",
+           FE_SALT_BYTES + FE_DATA_BYTES, kat_ok ? "ok" : "FAIL", st.mean, st.median, st.p05, st.p95,
+           (FE_SALT_BYTES + FE_DATA_BYTES) / st.median);
+    bench_kdf_multi(o, kdf);
+    free(kdf);
+}
+
+/* ===== [Reproduce] 에러 수별 분포 + 단계별 중앙값 ===== */
+static void bench_reproduce(fe_ctx *ctx, struct bch_workspace *ws, const bench_opts *o) {
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t noisy[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    unsigned int errloc[SYS_T];
+    size_t h_len, k_len, nflip;
+    FE_Key fk;
+    double *total = (double *)malloc(o->trials * sizeof(double));
+    double *decode = (double *)malloc(o->trials * sizeof(double));
+    double *kdf = (double *)malloc(o->trials * sizeof(double));
+    bench_stats st;
+
+    if (!total || !decode || !kdf) {
+        printf("# allocation failed!\n");
+        goto out;
+    }
+
+    printf("errors,attempts,success_rate,mean_us,median_us,p05_us,p95_us,stddev_us,"
+           "throughput_per_sec,decode_median_us,kdf_median_us\n");
+
+    for (int err = o->min_errors; err <= o->max_errors; err++) {
+        int success = 0;
+
+        for (int t = -o->warmup; t < o->trials; t++) {
+            uint64_t t0, t1;
+
+            // 1. 매 시행 새 입력 등록 + 노이즈 주입 (측정 제외)
+            rng_fill(input, FE_DATA_BYTES);
+            h_len = FE_HELPER_BYTES;
+            k_len = FE_KEY_LEN;
+            fe_enroll_ctx(ctx, input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len);
+            memcpy(noisy, input, FE_DATA_BYTES);
+            flip_random_bits(noisy, FE_DATA_BYTES, err);
+
+            // 2. 전체 reproduce (입력을 수정하지 않으므로 같은 noisy를 계속 사용)
+            k_len = FE_KEY_LEN;
+            t0 = bench_now();
+            int ret = fe_reproduce_ctx(ctx, noisy, FE_DATA_BYTES, helper, h_len, key_rec, &k_len);
+            t1 = bench_now();
+            if (t < 0) continue;
+            total[t] = bench_us(t0, t1);
+            if (ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0) success++;
+
+            // 3. 단계별: BCH 복호 (재인코딩, 신드롬, BM, 근 찾기) / 키 유도 (정정 포함)
+            t0 = bench_now();
+            fe_bch_locate(ctx->bch, ws, noisy, helper, errloc, &nflip);
+            t1 = bench_now();
+            decode[t] = bench_us(t0, t1);
+
+            t0 = bench_now();
+            FE_Derive_Key_Flip(noisy, errloc, nflip, helper + FE_ECC_BYTES, &fk);
+            t1 = bench_now();
+            kdf[t] = bench_us(t0, t1);
+        }
+
+        summarize(total, o->trials, &st);
+        printf("%d,%d,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.3f,%.3f\n",
+               err, o->trials, (double)success / o->trials,
+               st.mean, st.median, st.p05, st.p95, st.stddev, 1e6 / st.mean,
+               median_of(decode, o->trials), median_of(kdf, o->trials));
+        fflush(stdout);
+    }
+
+out:
+    free(kdf);
+    free(decode);
+    free(total);
+}
+
+/* ===== [Reject] 복구 실패 경로 지연 (조기 거절 / 전체 근 찾기) ===== */
+#define REJECT_IMPOSTOR  (-1)   // 다른 사람 입력 (등록 입력과 무관한 난수 probe)
+
+static void bench_reject_case(fe_ctx *ctx, struct bch_workspace *ws, const bench_opts *o,
+                              int errors, uint64_t seed) {
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t probe[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key[FE_KEY_LEN];
+    unsigned int errloc[SYS_T];
+    size_t h_len, k_len, nflip;
+    double *total = (double *)malloc(o->trials * sizeof(double));
+    double *decode = (double *)malloc(o->trials * sizeof(double));
+    bench_stats st;
+    int rejected = 0;
+
+    if (!total || !decode) {
+        printf("# allocation failed!\n");
+        goto out;
+    }
+
+    // 두 모드가 같은 probe를 받도록 seed 고정
+    rng_state = seed;
+    for (int t = -o->warmup; t < o->trials; t++) {
+        uint64_t t0, t1;
+
+        // 1. 등록 + 실패할 probe 생성 (측정 제외)
+        rng_fill(input, FE_DATA_BYTES);
+        h_len = FE_HELPER_BYTES;
+        k_len = FE_KEY_LEN;
+        fe_enroll_ctx(ctx, input, FE_DATA_BYTES, helper, &h_len, key, &k_len);
+        if (errors == REJECT_IMPOSTOR) {
+            rng_fill(probe, FE_DATA_BYTES);
+        } else {
+            memcpy(probe, input, FE_DATA_BYTES);
+            flip_random_bits(probe, FE_DATA_BYTES, errors);
+        }
+
+        // 2. 전체 reproduce
+        k_len = FE_KEY_LEN;
+        t0 = bench_now();
+        int ret = fe_reproduce_ctx(ctx, probe, FE_DATA_BYTES, helper, h_len, key, &k_len);
+        t1 = bench_now();
+        if (t < 0) continue;
+        total[t] = bench_us(t0, t1);
+        if (ret != FE_SUCCESS) rejected++;
+
+        // 3. BCH 복호만
+        t0 = bench_now();
+        fe_bch_locate(ctx->bch, ws, probe, helper, errloc, &nflip);
+        t1 = bench_now();
+        decode[t] = bench_us(t0, t1);
+    }
+
+    summarize(total, o->trials, &st);
+    printf("# reject,mode=%s,probe=", (ctx->bch->reject == BCH_REJECT_FULL) ? "full" : "early");
+    if (errors == REJECT_IMPOSTOR) printf("impostor");
+    else printf("errors_%d", errors);
+    printf(",attempts=%d,reject_rate=%.2f,mean_us=%.3f,median_us=%.3f,p05_us=%.3f,p95_us=%.3f,"
+           "stddev_us=%.3f,decode_median_us=%.3f\n",
+           o->trials, (double)rejected / o->trials, st.mean, st.median, st.p05, st.p95,
+           st.stddev, median_of(decode, o->trials));
+    fflush(stdout);
+
+out:
+    free(decode);
+    free(total);
+}
+
+static void bench_reject(fe_ctx *ctx, struct bch_workspace *ws, const bench_opts *o) {
+    static const int cases[] = { REJECT_IMPOSTOR, SYS_T + 1, SYS_T + 8, 2 * SYS_T };
+    fe_ctx_params alt = o->params;
+    alt.reject = (o->params.reject == FE_REJECT_FULL) ? FE_REJECT_EARLY : FE_REJECT_FULL;
+    fe_ctx *actx = fe_ctx_create_ex(&alt);
+    struct bch_workspace *aws = actx ? fe_bch_ws_create(actx->bch) : NULL;
+    uint64_t saved = rng_state;
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        uint64_t seed = saved + c;
+        bench_reject_case(ctx, ws, o, cases[c], seed);
+        if (aws) bench_reject_case(actx, aws, o, cases[c], seed);
+    }
+    rng_state = saved;
+    fe_bch_ws_destroy(aws);
+    fe_ctx_destroy(actx);
+}
+
+/* ===== [Leakage] dudect 방식 타이밍 누설 검정 =====
+ * 매 반복 난수로 클래스를 고름: 고정(오류 --leak-fixed개) / 무작위(0..t개), 위치는 매번 새로.
+ * scalar와 상수 시간(FE_DEC_CONSTTIME) 컨텍스트에 같은 probe 순서를 따로 넣어 fe_reproduce_ctx
+ * 전체 시간과 (FE_STATS 빌드면) 단계별 사이클을 잼. 클래스별 평균 / 분산은 Welford로
+ * 누적하므로 반복 수와 관계없이 메모리가 일정하고, Welch t 값이 |t| > 10이면 누설,
+ * 4.5 초과면 의심으로 표시. 큰 값 쪽 잡음(인터럽트 등)을 줄이려고 앞부분 반복으로 정한
+ * 백분위 기준(50 / 90 / 99%)보다 큰 측정을 버린 검정도 함께 수행 (dudect의 cropping).
+ * 백분위 추정에 쓴 앞부분 반복은 검정에서 제외 */
+#define LEAK_PREP       10000
+#define LEAK_CROPS      3
+#define LEAK_TESTS      (1 + LEAK_CROPS)    // 자르지 않음 + 백분위별
+#ifdef FE_STATS
+#define LEAK_METRICS    (1 + FE_STAGE_MAX)  // 전체 + 단계별
+#else
+#define LEAK_METRICS    1
+#endif
+#define LEAK_T_LEAK     10.0
+#define LEAK_T_MAYBE    4.5
+#define LEAK_REPORTS    10                  // 중간 요약 횟수
+#define LEAK_BATCH      64                  // 미리 만들어 두는 probe 수
+
+static const double leak_crop_pct[LEAK_CROPS] = { 0.50, 0.90, 0.99 };
+static const char *leak_crop_names[LEAK_TESTS] = { "none", "p50", "p90", "p99" };
+#ifdef FE_STATS
+static const char *leak_metric_names[LEAK_METRICS] = {
+    "total", "encode", "syndrome", "bm", "roots", "correct", "hash"
+};
+#else
+static const char *leak_metric_names[LEAK_METRICS] = { "total" };
+#endif
+
+// 온라인 평균 / 분산 (Welford)
+typedef struct {
+    double n, mean, m2;
+} leak_acc;
+
+static void leak_push(leak_acc *a, double x) {
+    double d = x - a->mean;
+    a->n += 1.0;
+    a->mean += d / a->n;
+    a->m2 += d * (x - a->mean);
+}
+
+// Welch t: 두 클래스 평균 차 / 합성 표준오차
+static double leak_t(const leak_acc *a, const leak_acc *b) {
+    if (a->n < 2.0 || b->n < 2.0) return 0.0;
+    double se = a->m2 / (a->n - 1.0) / a->n + b->m2 / (b->n - 1.0) / b->n;
+    return (se > 0.0) ? (a->mean - b->mean) / sqrt(se) : 0.0;
+}
+
+static const char *leak_verdict(double t) {
+    t = fabs(t);
+    return (t > LEAK_T_LEAK) ? "leak" : (t > LEAK_T_MAYBE) ? "maybe" : "ok";
+}
+
+typedef struct {
+    fe_ctx *ctx;
+    const char *name;
+    double *prep;                               // [LEAK_METRICS][prep]
+    double crop[LEAK_METRICS][LEAK_CROPS];
+    leak_acc acc[LEAK_METRICS][LEAK_TESTS][2];  // [지표][자르기][클래스: 0 고정, 1 무작위]
+    leak_acc total_all;                         // 클래스 무관 전체 시간 (비용 비교)
+    long long failed;                           // 키가 복원되지 않은 건수
+} leak_target;
+
+// 한 번 측정: x[0] = 전체 시간(us), x[1..] = 단계별 사이클 (FE_STATS 누적 집계의 증가분)
+static int leak_measure(leak_target *lt, const uint8_t *probe, const uint8_t *helper,
+                        const uint8_t *key_org, double *x) {
+    uint8_t key[FE_KEY_LEN];
+    size_t k_len = FE_KEY_LEN;
+#ifdef FE_STATS
+    fe_stats before, after;
+    fe_stats_snapshot(&before);
+#endif
+    uint64_t t0 = bench_now();
+    int ret = fe_reproduce_ctx(lt->ctx, probe, FE_DATA_BYTES, helper, FE_HELPER_BYTES, key, &k_len);
+    uint64_t t1 = bench_now();
+    x[0] = bench_us(t0, t1);
+#ifdef FE_STATS
+    fe_stats_snapshot(&after);
+    for (int s = 0; s < FE_STAGE_MAX; s++)
+        x[1 + s] = (double)(after.cycle_sum[s] - before.cycle_sum[s]);
+#endif
+    return ret == FE_SUCCESS && memcmp(key, key_org, FE_KEY_LEN) == 0;
+}
+
+static void leak_summary(const leak_target *lt, long long iter) {
+    double worst = 0.0;
+    int wm = 0, wc = 0;
+    for (int m = 0; m < LEAK_METRICS; m++) {
+        for (int c = 0; c < LEAK_TESTS; c++) {
+            double t = fabs(leak_t(&lt->acc[m][c][0], &lt->acc[m][c][1]));
+            if (t > worst) {
+                worst = t;
+                wm = m;
+                wc = c;
+            }
+        }
+    }
+    printf("# leakage,decoder=%s,iterations=%lld,mean_us=%.3f,max_abs_t=%.2f,worst=%s/%s,"
+           "verdict=%s,failed=%lld\n",
+           lt->name, iter, lt->total_all.mean, worst, leak_metric_names[wm], leak_crop_names[wc],
+           leak_verdict(worst), lt->failed);
+    fflush(stdout);
+}
+
+// 한 디코더 검정 (probe는 LEAK_BATCH건씩 미리 만들어 두고 측정 구간에는 reproduce만)
+static void leak_run(leak_target *lt, const bench_opts *o, long long prep, const uint8_t *input,
+                     const uint8_t *helper, const uint8_t *key_org, uint8_t *probes, double *sorted) {
+    int cls[LEAK_BATCH];
+    double x[LEAK_METRICS];
+    long long report = (o->leakage + LEAK_REPORTS - 1) / LEAK_REPORTS;
+
+    for (int t = -o->warmup; t < 0; t++) {
+        memcpy(probes, input, FE_DATA_BYTES);
+        flip_random_bits(probes, FE_DATA_BYTES, (int)(rng_next() % (SYS_T + 1)));
+        leak_measure(lt, probes, helper, key_org, x);
+    }
+
+    for (long long base = 0; base < prep + o->leakage; base += LEAK_BATCH) {
+        int cnt = (prep + o->leakage - base < LEAK_BATCH) ? (int)(prep + o->leakage - base) : LEAK_BATCH;
+
+        // 1. 클래스를 무작위로 섞은 probe 묶음 (측정 제외)
+        for (int k = 0; k < cnt; k++) {
+            uint8_t *probe = probes + (size_t)k * FE_DATA_BYTES;
+            cls[k] = (int)(rng_next() & 1);
+            memcpy(probe, input, FE_DATA_BYTES);
+            flip_random_bits(probe, FE_DATA_BYTES,
+                             (cls[k] == 0) ? o->leak_fixed : (int)(rng_next() % (SYS_T + 1)));
+        }
+
+        // 2. 측정 (앞부분 prep회는 자르기 기준 추정용)
+        for (int k = 0; k < cnt; k++) {
+            long long it = base + k;
+            if (!leak_measure(lt, probes + (size_t)k * FE_DATA_BYTES, helper, key_org, x)) lt->failed++;
+            if (it < prep) {
+                for (int m = 0; m < LEAK_METRICS; m++) lt->prep[m * prep + it] = x[m];
+                if (it + 1 < prep) continue;
+                for (int m = 0; m < LEAK_METRICS; m++) {
+                    memcpy(sorted, lt->prep + m * prep, prep * sizeof(double));
+                    qsort(sorted, prep, sizeof(double), compare_doubles);
+                    for (int c = 0; c < LEAK_CROPS; c++)
+                        lt->crop[m][c] = sorted[(long long)(prep * leak_crop_pct[c])];
+                }
+                continue;
+            }
+            leak_push(&lt->total_all, x[0]);
+            for (int m = 0; m < LEAK_METRICS; m++) {
+                leak_push(&lt->acc[m][0][cls[k]], x[m]);
+                for (int c = 0; c < LEAK_CROPS; c++) {
+                    if (x[m] <= lt->crop[m][c]) leak_push(&lt->acc[m][1 + c][cls[k]], x[m]);
+                }
+            }
+            long long done = it + 1 - prep;
+            if (done % report == 0 && done < o->leakage) leak_summary(lt, done);
+        }
+    }
+}
+
+static void bench_leakage(fe_ctx *ctx, const bench_opts *o) {
+    enum { NT = 2 };
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    size_t h_len = FE_HELPER_BYTES, k_len = FE_KEY_LEN;
+    long long prep = o->leakage / 10;
+    fe_ctx_params ct_params = o->params;
+    leak_target *lt = (leak_target *)calloc(NT, sizeof(leak_target));
+    uint8_t *probes = (uint8_t *)malloc(LEAK_BATCH * FE_DATA_BYTES);
+    double *sorted = NULL;
+
+    if (prep > LEAK_PREP) prep = LEAK_PREP;
+    if (prep < 1) prep = 1;
+    ct_params.decoder = FE_DEC_CONSTTIME;
+    if (!lt || !probes) {
+        printf("# allocation failed!\n");
+        free(probes);
+        free(lt);
+        return;
+    }
+    lt[0].ctx = ctx;
+    lt[0].name = "scalar";
+    lt[1].ctx = fe_ctx_create_ex(&ct_params);
+    lt[1].name = "consttime";
+    sorted = (double *)malloc(prep * sizeof(double));
+    for (int d = 0; d < NT; d++) lt[d].prep = (double *)malloc(LEAK_METRICS * prep * sizeof(double));
+    if (!lt[1].ctx || !sorted || !lt[0].prep || !lt[1].prep) {
+        printf("# fe_ctx_create_ex / allocation failed!\n");
+        goto out;
+    }
+    printf("# leakage,iterations=%lld,prep=%lld,fixed_errors=%d,random_errors=0..%d,"
+           "stage_cycles=%s,ct_chien_width=%u\n",
+           o->leakage, prep, o->leak_fixed, SYS_T, (LEAK_METRICS > 1) ? "on" : "off (FE_STATS=OFF)",
+           bch_ct_width(lt[1].ctx->ct));
+
+    // 1. 등록 1건 (모든 probe가 같은 helper를 씀)
+    rng_fill(input, FE_DATA_BYTES);
+    fe_enroll_ctx(ctx, input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len);
+
+    // 2. 디코더마다 따로 (앞 호출의 시간이 클래스에 따라 달라 다음 측정에 섞이지 않도록),
+    //    seed를 되돌려 같은 클래스 / probe 순서로
+    uint64_t saved = rng_state;
+    for (int d = 0; d < NT; d++) {
+        rng_state = saved;
+        leak_run(&lt[d], o, prep, input, helper, key_org, probes, sorted);
+    }
+
+    // 3. 지표 / 자르기별 결과 + 최종 요약
+    printf("decoder,metric,unit,crop,n_fixed,n_random,mean_fixed,mean_random,t,verdict\n");
+    for (int d = 0; d < NT; d++) {
+        for (int m = 0; m < LEAK_METRICS; m++) {
+            for (int c = 0; c < LEAK_TESTS; c++) {
+                const leak_acc *a = &lt[d].acc[m][c][0], *b = &lt[d].acc[m][c][1];
+                double t = leak_t(a, b);
+                printf("%s,%s,%s,%s,%.0f,%.0f,%.3f,%.3f,%.2f,%s\n", lt[d].name, leak_metric_names[m],
+                       (m == 0) ? "us" : "cycles", leak_crop_names[c], a->n, b->n, a->mean, b->mean,
+                       t, leak_verdict(t));
+            }
+        }
+    }
+    for (int d = 0; d < NT; d++) leak_summary(&lt[d], o->leakage);
+    if (lt[0].total_all.mean > 0.0)
+        printf("# leakage_cost,consttime_over_scalar=%.2f\n", lt[1].total_all.mean / lt[0].total_all.mean);
+
+out:
+    for (int d = 0; d < NT; d++) free(lt[d].prep);
+    free(sorted);
+    free(probes);
+    fe_ctx_destroy(lt[1].ctx);
+    free(lt);
+}
+
+/* =================================================================
+ * [Modes] 하위 명령 (fe_bench MODE [인자...]): 디코더 / API별 비교 측정
+ * 옵션 측정과 같은 PRNG (seed 12345)와 단조 나노초 시계를 씀
+ * ================================================================= */
+static uint64_t timer_start;
+
+static void timer_tic(void) {
+    timer_start = bench_now();
+}
+
+static double timer_toc(void) {
+    return bench_us(timer_start, bench_now());   // 마이크로초(us) 단위
+}
+
+/* ===== [Stream] fe_bench stream ===== */
+// 스트리밍 enroll: 조각 크기별 마지막 조각 도착 후 지연(update + final) vs 한 번에 enroll
+// 앞 조각들의 인코딩/해시는 캡처 중에 끝나므로 마지막 조각분만 남음
+#define STREAM_TRIALS  200
+
+static void bench_stream(void) {
+    static const int chunks[] = { 1, 16, 64, 109, FE_DATA_BYTES };
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t helper_ref[FE_HELPER_BYTES];
+    uint8_t key[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t h_len, k_len;
+    double total[STREAM_TRIALS], tail[STREAM_TRIALS], oneshot[STREAM_TRIALS];
+    bench_stats st_total, st_tail, st_one;
+    fe_ctx *ctx = fe_ctx_create();
+    if (!ctx) {
+        printf("fe_ctx_create failed!\n");
+        return;
+    }
+
+    printf("chunk_bytes,chunks,trials,total_median_us,tail_median_us,oneshot_median_us,mismatch\n");
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        int mismatch = 0;
+        for (int t = 0; t < STREAM_TRIALS; t++) {
+            for (int i = 0; i < FE_DATA_BYTES; i++) input[i] = (uint8_t)rng_next();
+
+            // 기준: 전체를 모은 뒤 한 번에 enroll
+            timer_tic();
+            fe_enroll_ctx(ctx, input, FE_DATA_BYTES, helper_ref, &h_len, key, &k_len);
+            oneshot[t] = timer_toc();
+
+            // 조각 단위 enroll (마지막 조각 직전 시각을 기록)
+            fe_enroll_stream stream;
+            double before_last = 0.0;
+            timer_tic();
+            fe_enroll_stream_init(ctx, &stream);
+            for (int off = 0; off < FE_DATA_BYTES; off += chunks[c]) {
+                int n = (FE_DATA_BYTES - off < chunks[c]) ? FE_DATA_BYTES - off : chunks[c];
+                if (off + n == FE_DATA_BYTES) before_last = timer_toc();
+                fe_enroll_stream_update(&stream, input + off, n);
+            }
+            int ret = fe_enroll_stream_final(&stream, helper, &h_len, key, &k_len);
+            total[t] = timer_toc();
+            tail[t] = total[t] - before_last;
+
+            // ECC는 한 번에 인코딩한 것과 같고(salt는 다름), 같은 입력으로 키가 복원되어야 함
+            if (ret != FE_SUCCESS || memcmp(helper, helper_ref, FE_ECC_BYTES) != 0 ||
+                fe_reproduce_ctx(ctx, input, FE_DATA_BYTES, helper, h_len, key_rec, &k_len) != FE_SUCCESS ||
+                memcmp(key, key_rec, FE_KEY_LEN) != 0)
+                mismatch++;
+        }
+        summarize(total, STREAM_TRIALS, &st_total);
+        summarize(tail, STREAM_TRIALS, &st_tail);
+        summarize(oneshot, STREAM_TRIALS, &st_one);
+        printf("%d,%d,%d,%.3f,%.3f,%.3f,%d\n", chunks[c], (FE_DATA_BYTES + chunks[c] - 1) / chunks[c],
+               STREAM_TRIALS, st_total.median, st_tail.median, st_one.median, mismatch);
+    }
+    fe_ctx_destroy(ctx);
+}
+
+/* ===== [Bitsliced] fe_bench bitsliced ===== */
+// bitsliced 배치 디코더: 에러 수별 scalar vs bitsliced (Chien 구간 1 / 4 / 8)
+// 에러 수마다 같은 probe 집합을 모든 디코더로 처리하고 키 일치를 확인
+#define BS_PROBES      1024
+#define BS_ROUNDS      2
+
+static void bench_bitsliced(int threads) {
+    static const int err_counts[] = { 0, 8, 16, 24, 32, 48, 64 };
+    static const int widths[] = { 1, 4, 8 };
+    uint8_t *inputs = (uint8_t *)malloc(BS_PROBES * FE_DATA_BYTES);
+    uint8_t *noisy = (uint8_t *)malloc(BS_PROBES * FE_DATA_BYTES);
+    uint8_t *helpers = (uint8_t *)malloc(BS_PROBES * FE_HELPER_BYTES);
+    uint8_t *keys_org = (uint8_t *)malloc(BS_PROBES * FE_KEY_LEN);
+    uint8_t *keys = (uint8_t *)malloc(BS_PROBES * FE_KEY_LEN);
+    int *status = (int *)malloc(BS_PROBES * sizeof(int));
+    fe_ctx *ctx[4] = { NULL, NULL, NULL, NULL };
+    int nctx = 1;
+
+    if (!inputs || !noisy || !helpers || !keys_org || !keys || !status) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+
+    // ctx[0] = scalar, 이후 지원되는 width별 bitsliced
+    for (int d = 0; d < 4; d++) {
+        fe_ctx_params params;
+        fe_ctx_params_default(&params);
+        params.num_threads = threads;
+        if (d > 0) {
+            params.decoder = FE_DEC_BITSLICED;
+            params.bs_width = widths[d - 1];
+        }
+        ctx[d] = fe_ctx_create_ex(&params);
+        if (!ctx[d]) {
+            printf("fe_ctx_create_ex failed!\n");
+            goto out;
+        }
+        if (d > 0 && bch_bs64_width(ctx[d]->bs) != (unsigned int)widths[d - 1]) {
+            printf("# bitsliced w%d: not supported on this CPU\n", widths[d - 1]);
+            fe_ctx_destroy(ctx[d]);
+            ctx[d] = NULL;
+            break;
+        }
+        nctx = d + 1;
+    }
+
+    for (int i = 0; i < BS_PROBES * FE_DATA_BYTES; i++) inputs[i] = (uint8_t)rng_next();
+    fe_enroll_batch(ctx[0], inputs, BS_PROBES, helpers, keys_org, status);
+
+    printf("errors,threads,decoder,probes,elapsed_us,probes_per_sec,speedup,key_mismatch\n");
+    for (size_t e = 0; e < sizeof(err_counts) / sizeof(err_counts[0]); e++) {
+        double base_rate = 0.0;
+        memcpy(noisy, inputs, BS_PROBES * FE_DATA_BYTES);
+        for (int p = 0; p < BS_PROBES; p++)
+            flip_random_bits(noisy + p * FE_DATA_BYTES, FE_DATA_BYTES, err_counts[e]);
+
+        for (int d = 0; d < nctx; d++) {
+            int success = 0;
+            timer_tic();
+            for (int r = 0; r < BS_ROUNDS; r++)
+                success += fe_reproduce_batch(ctx[d], noisy, helpers, BS_PROBES, keys, status);
+            double elapsed_us = timer_toc();
+
+            int mismatch = 0;
+            for (int p = 0; p < BS_PROBES; p++) {
+                if (status[p] != FE_SUCCESS ||
+                    memcmp(keys + p * FE_KEY_LEN, keys_org + p * FE_KEY_LEN, FE_KEY_LEN) != 0)
+                    mismatch++;
+            }
+            double rate = (double)BS_ROUNDS * BS_PROBES / (elapsed_us / 1e6);
+            if (d == 0) base_rate = rate;
+            char name[16];
+            if (d == 0) snprintf(name, sizeof(name), "scalar");
+            else snprintf(name, sizeof(name), "bs64-w%d", widths[d - 1]);
+            if (success != BS_ROUNDS * BS_PROBES)
+                printf("# warning: %d probes failed\n", BS_ROUNDS * BS_PROBES - success);
+            printf("%d,%d,%s,%d,%.1f,%.1f,%.2f,%d\n", err_counts[e], threads, name,
+                   BS_ROUNDS * BS_PROBES, elapsed_us, rate, rate / base_rate, mismatch);
+        }
+    }
+
+out:
+    for (int d = 0; d < 4; d++) fe_ctx_destroy(ctx[d]);
+    free(status);
+    free(keys);
+    free(keys_org);
+    free(helpers);
+    free(noisy);
+    free(inputs);
+}
+
+/* ===== [CT] fe_bench ct ===== */
+// 상수 시간 디코더: 에러 수(0 ~ 64, 실패 72)별 단건 reproduce 시간 분포
+// scalar(기본) 컨텍스트와 FE_DEC_CONSTTIME 컨텍스트를 같은 probe로 번갈아 측정
+#define CT_MAX_ERRORS  64
+#define CT_FAIL_ERRORS 72
+
+static void bench_ct(int trials) {
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t h_len = FE_HELPER_BYTES;
+    size_t k_len = FE_KEY_LEN;
+    uint8_t *noisy = (uint8_t *)malloc((size_t)trials * FE_DATA_BYTES);
+    double *times[2] = { (double *)malloc(trials * sizeof(double)),
+                         (double *)malloc(trials * sizeof(double)) };
+    double med_min[2] = { 1e30, 1e30 }, med_max[2] = { 0.0, 0.0 };
+    double sum_us[2] = { 0.0, 0.0 };
+    double med_sum[2] = { 0.0, 0.0 }, med_sq[2] = { 0.0, 0.0 };
+    long calls = 0;
+    int mismatch[2] = { 0, 0 };
+    static const char *names[2] = { "scalar", "consttime" };
+    fe_ctx *ctx[2] = { NULL, NULL };
+    fe_ctx_params params;
+    bench_stats st;
+
+    if (!noisy || !times[0] || !times[1]) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+    fe_ctx_params_default(&params);
+    ctx[0] = fe_ctx_create_ex(&params);
+    params.decoder = FE_DEC_CONSTTIME;
+    ctx[1] = fe_ctx_create_ex(&params);
+    if (!ctx[0] || !ctx[1]) {
+        printf("fe_ctx_create_ex failed!\n");
+        goto out;
+    }
+    printf("# ct chien_width=%u trials=%d\n", bch_ct_width(ctx[1]->ct), trials);
+
+    for (int i = 0; i < FE_DATA_BYTES; i++) input[i] = (uint8_t)rng_next();
+    fe_enroll_ctx(ctx[0], input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len);
+
+    printf("errors,decoder,calls,mean_us,median_us,p05_us,p95_us,stddev_us,key_mismatch\n");
+    for (int e = 0; e <= CT_MAX_ERRORS + 1; e++) {
+        int errors = (e > CT_MAX_ERRORS) ? CT_FAIL_ERRORS : e;
+        int bad[2] = { 0, 0 };
+        for (int r = 0; r < trials; r++) {
+            memcpy(noisy + (size_t)r * FE_DATA_BYTES, input, FE_DATA_BYTES);
+            flip_random_bits(noisy + (size_t)r * FE_DATA_BYTES, FE_DATA_BYTES, errors);
+        }
+        // 두 디코더를 번갈아 호출해 시스템 잡음이 양쪽에 고르게 섞이도록
+        for (int r = 0; r < trials; r++) {
+            for (int d = 0; d < 2; d++) {
+                timer_tic();
+                int ret = fe_reproduce_ctx(ctx[d], noisy + (size_t)r * FE_DATA_BYTES, FE_DATA_BYTES,
+                                           helper, h_len, key_rec, &k_len);
+                times[d][r] = timer_toc();
+                int ok = (ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0);
+                if (ok != (errors <= CT_MAX_ERRORS)) bad[d]++;
+            }
+        }
+        for (int d = 0; d < 2; d++) {
+            summarize(times[d], trials, &st);
+            printf("%d,%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%d\n", errors, names[d], trials,
+                   st.mean, st.median, st.p05, st.p95, st.stddev, bad[d]);
+            mismatch[d] += bad[d];
+            if (errors > CT_MAX_ERRORS) continue;
+            if (st.median < med_min[d]) med_min[d] = st.median;
+            if (st.median > med_max[d]) med_max[d] = st.median;
+            sum_us[d] += st.mean * trials;
+            med_sum[d] += st.median;
+            med_sq[d] += st.median * st.median;
+        }
+        if (errors <= CT_MAX_ERRORS) calls += trials;
+    }
+
+    // 에러 수별 중앙값의 폭과 표준편차 (0 ~ 64): 상수 시간이면 측정 잡음 수준
+    printf("# ct_summary,decoder,median_min_us,median_max_us,spread_us,spread_pct,"
+           "median_stddev_us,probes_per_sec,key_mismatch\n");
+    for (int d = 0; d < 2; d++) {
+        double mean = sum_us[d] / calls;
+        double m = med_sum[d] / (CT_MAX_ERRORS + 1);
+        double sd = sqrt(fabs(med_sq[d] / (CT_MAX_ERRORS + 1) - m * m));
+        printf("# ct_summary,%s,%.3f,%.3f,%.3f,%.1f,%.3f,%.1f,%d\n", names[d], med_min[d], med_max[d],
+               med_max[d] - med_min[d], 100.0 * (med_max[d] - med_min[d]) / mean, sd, 1e6 / mean,
+               mismatch[d]);
+    }
+
+out:
+    fe_ctx_destroy(ctx[1]);
+    fe_ctx_destroy(ctx[0]);
+    free(times[1]);
+    free(times[0]);
+    free(noisy);
+}
+
+/* ===== [Multi] fe_bench multi ===== */
+// 다중 블록 템플릿 (8 / 16 / 32 kbit): 디코더 / 스레드별 reproduce 지연을 단일 블록과 비교,
+// 버스트 오류에서 연속 분할과 인터리브 분할의 복원율 비교
+#define MB_TRIALS        100
+#define MB_ERRORS        24     // 블록당 평균 오류 수 (템플릿 전체에 고르게)
+#define MB_BURST_BITS    256    // 버스트 길이 (연속 비트, 가려진 영역처럼 난수로 덮음)
+#define MB_BURST_NOISE   8      // 버스트 외 블록당 평균 오류 수
+
+static void bench_multi(int threads) {
+    static const int kbits[] = { 8, 16, 32 };
+    static const char *names[] = { "scalar", "scalar", "bs64", "consttime" };
+    uint8_t single_in[FE_DATA_BYTES], single_noisy[FE_DATA_BYTES], single_helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN], key_rec[FE_KEY_LEN];
+    size_t h_len = FE_HELPER_BYTES, k_len = FE_KEY_LEN;
+    size_t max_len = 32 * 1024 / 8;
+    uint8_t *input = (uint8_t *)malloc(max_len);
+    uint8_t *noisy = (uint8_t *)malloc(max_len);
+    uint8_t *record = (uint8_t *)malloc(fe_multi_record_bytes(max_len));
+    double times[MB_TRIALS];
+    fe_ctx *ctx[4] = { NULL, NULL, NULL, NULL };
+    bench_stats st;
+
+    if (!input || !noisy || !record) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+    // ctx[0] = scalar 1스레드, 1 = scalar 워커 threads개, 2 = bitsliced, 3 = 상수 시간 (워커 threads개)
+    for (int d = 0; d < 4; d++) {
+        fe_ctx_params params;
+        fe_ctx_params_default(&params);
+        if (d == 1 || d == 3) params.num_threads = threads;
+        if (d == 2) params.decoder = FE_DEC_BITSLICED;
+        if (d == 3) params.decoder = FE_DEC_CONSTTIME;
+        ctx[d] = fe_ctx_create_ex(&params);
+        if (!ctx[d]) {
+            printf("fe_ctx_create_ex failed!\n");
+            goto out;
+        }
+    }
+
+    // 기준: 단일 블록 (3488비트) scalar reproduce
+    for (int t = 0; t < MB_TRIALS; t++) {
+        for (int i = 0; i < FE_DATA_BYTES; i++) single_in[i] = (uint8_t)rng_next();
+        fe_enroll_ctx(ctx[0], single_in, FE_DATA_BYTES, single_helper, &h_len, key_org, &k_len);
+        memcpy(single_noisy, single_in, FE_DATA_BYTES);
+        flip_random_bits(single_noisy, FE_DATA_BYTES, MB_ERRORS);
+        timer_tic();
+        fe_reproduce_ctx(ctx[0], single_noisy, FE_DATA_BYTES, single_helper, h_len, key_rec, &k_len);
+        times[t] = timer_toc();
+    }
+    summarize(times, MB_TRIALS, &st);
+    double single_us = st.median;
+    printf("# multi,single_block_median_us=%.3f,errors=%d\n", single_us, MB_ERRORS);
+
+    printf("kbits,blocks,decoder,threads,errors,median_us,p95_us,vs_single,success_rate\n");
+    for (size_t s = 0; s < sizeof(kbits) / sizeof(kbits[0]); s++) {
+        size_t len = (size_t)kbits[s] * 1024 / 8;
+        size_t n = fe_multi_blocks(len);
+        for (int d = 0; d < 4; d++) {
+            int success = 0;
+            for (int t = 0; t < MB_TRIALS; t++) {
+                size_t r_len = fe_multi_record_bytes(len);
+                for (size_t i = 0; i < len; i++) input[i] = (uint8_t)rng_next();
+                fe_enroll_multi(ctx[d], input, len, FE_MULTI_INTERLEAVE, record, &r_len, key_org, &k_len);
+                memcpy(noisy, input, len);
+                flip_random_bits(noisy, (int)len, (int)(MB_ERRORS * n));
+                timer_tic();
+                int ret = fe_reproduce_multi(ctx[d], noisy, len, record, r_len, key_rec, &k_len);
+                times[t] = timer_toc();
+                if (ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0) success++;
+            }
+            summarize(times, MB_TRIALS, &st);
+            printf("%d,%zu,%s,%d,%d,%.3f,%.3f,%.2f,%.2f\n", kbits[s], n, names[d],
+                   (d == 1 || d == 3) ? threads : 1, (int)(MB_ERRORS * n), st.median, st.p95,
+                   st.median / single_us, (double)success / MB_TRIALS);
+        }
+    }
+
+    // 버스트: 임의 위치의 연속 MB_BURST_BITS비트를 난수로 덮음 (약 절반이 뒤집힘) + 고른 잡음
+    for (size_t s = 0; s < sizeof(kbits) / sizeof(kbits[0]); s++) {
+        size_t len = (size_t)kbits[s] * 1024 / 8;
+        size_t n = fe_multi_blocks(len);
+        for (int flags = 0; flags <= FE_MULTI_INTERLEAVE; flags++) {
+            int success = 0;
+            for (int t = 0; t < MB_TRIALS; t++) {
+                size_t r_len = fe_multi_record_bytes(len);
+                for (size_t i = 0; i < len; i++) input[i] = (uint8_t)rng_next();
+                fe_enroll_multi(ctx[0], input, len, flags, record, &r_len, key_org, &k_len);
+                memcpy(noisy, input, len);
+                flip_random_bits(noisy, (int)len, (int)(MB_BURST_NOISE * n));
+                size_t start = (size_t)(rng_next() % (len * 8 - MB_BURST_BITS));
+                for (size_t b = start; b < start + MB_BURST_BITS; b++) noisy[b / 8] ^= (uint8_t)((rng_next() & 1) << (b % 8));
+                int ret = fe_reproduce_multi(ctx[0], noisy, len, record, r_len, key_rec, &k_len);
+                if (ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0) success++;
+            }
+            printf("# burst,kbits=%d,blocks=%zu,burst_bits=%d,noise=%d,layout=%s,success_rate=%.2f\n",
+                   kbits[s], n, MB_BURST_BITS, (int)(MB_BURST_NOISE * n),
+                   flags ? "interleave" : "contiguous", (double)success / MB_TRIALS);
+        }
+    }
+
+out:
+    for (int d = 0; d < 4; d++) fe_ctx_destroy(ctx[d]);
+    free(record);
+    free(noisy);
+    free(input);
+}
+
+/* ===== [Tables] fe_bench tables ===== */
+// 테이블 파일: write = 미리 만든 테이블 저장, bench = 컨텍스트 생성 시간 (계산 vs 매핑)
+// 설정 이름은 fe_system encode와 같음 (table4 / table8 / table16 / clmul, 기본 auto)
+#define TABLES_TRIALS  50
+
+static int tables_config(const char *name, fe_ctx_params *params, struct bch_config *cfg) {
+    fe_ctx_params_default(params);
+    memset(cfg, 0, sizeof(*cfg));
+    if (!name || strcmp(name, "auto") == 0) return 0;
+    if (strcmp(name, "clmul") == 0) {
+        params->encoder = FE_ENC_CLMUL;
+        cfg->encoder = BCH_ENC_CLMUL;
+        return 0;
+    }
+    if (strncmp(name, "table", 5) != 0) return -1;
+    params->encoder = FE_ENC_TABLE;
+    params->slice_bytes = atoi(name + 5);
+    cfg->encoder = BCH_ENC_TABLE;
+    cfg->slice_bytes = params->slice_bytes;
+    return 0;
+}
+
+static int tables_write(const char *path, const char *name) {
+    fe_ctx_params params;
+    struct bch_config cfg;
+    if (tables_config(name, &params, &cfg) != 0) {
+        printf("unknown config: %s\n", name);
+        return 2;
+    }
+    struct bch_control *bch = fe_bch_create(&cfg);
+    if (!bch) {
+        printf("fe_bch_create failed!\n");
+        return 1;
+    }
+    int ret = fe_tables_save(bch, path);
+    if (ret == 0)
+        printf("# tables,path=%s,encoder=%s,slice_bytes=%u,bytes=%zu\n", path,
+               (bch->encoder == BCH_ENC_CLMUL) ? "clmul" : "table", bch->slice_bytes,
+               bch_image_size(bch));
+    else
+        printf("cannot write %s\n", path);
+    fe_bch_destroy(bch);
+    return ret ? 1 : 0;
+}
+
+static void bench_tables(const char *path, const char *name) {
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t noisy[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t h_len, k_len;
+    double times[TABLES_TRIALS];
+    fe_ctx_params params;
+    struct bch_config cfg;
+
+    if (tables_config(name, &params, &cfg) != 0) {
+        printf("unknown config: %s\n", name);
+        return;
+    }
+    for (int i = 0; i < FE_DATA_BYTES; i++) input[i] = (uint8_t)rng_next();
+    memcpy(noisy, input, FE_DATA_BYTES);
+    flip_random_bits(noisy, FE_DATA_BYTES, SYS_T);
+
+    // 계산한 컨텍스트로 등록, 각 모드의 컨텍스트로 복원해 키 비교
+    fe_ctx *ref = fe_ctx_create_ex(&params);
+    if (!ref || fe_enroll_ctx(ref, input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len) != FE_SUCCESS) {
+        printf("fe_enroll_ctx failed!\n");
+        fe_ctx_destroy(ref);
+        return;
+    }
+    fe_ctx_destroy(ref);
+
+    printf("mode,trials,create_median_us,create_p95_us,mapped,key_mismatch\n");
+    for (int mode = 0; mode < 2; mode++) {
+        int mapped = 0, mismatch = 0;
+        params.tables_path = mode ? path : NULL;
+        for (int t = 0; t < TABLES_TRIALS; t++) {
+            timer_tic();
+            fe_ctx *ctx = fe_ctx_create_ex(&params);
+            times[t] = timer_toc();
+            if (!ctx) {
+                printf("fe_ctx_create_ex failed!\n");
+                return;
+            }
+            mapped += fe_ctx_tables_mapped(ctx);
+            if (fe_reproduce_ctx(ctx, noisy, FE_DATA_BYTES, helper, h_len, key_rec, &k_len) != FE_SUCCESS ||
+                memcmp(key_rec, key_org, FE_KEY_LEN) != 0)
+                mismatch++;
+            fe_ctx_destroy(ctx);
+        }
+        qsort(times, TABLES_TRIALS, sizeof(double), compare_doubles);
+        printf("%s,%d,%.1f,%.1f,%d,%d\n", mode ? "mapped" : "built", TABLES_TRIALS,
+               times[TABLES_TRIALS / 2], times[(int)(TABLES_TRIALS * 0.95)], mapped, mismatch);
+    }
+}
+
+/* ===== [Store] fe_bench store ===== */
+// 등록 저장소: 레코드 N건 -> 열 단위 파일, 매핑 후 배치 reproduce / 갤러리를 메모리 배열과 비교
+// step별 elapsed_us, mismatch = 메모리 배열 경로와 결과(상태 / 키 / 식별 인덱스)가 다른 건수
+#define STORE_ERRORS   40
+#define STORE_PROBES   16     // 갤러리 식별 probe 수
+
+static void bench_store(int entries, const char *path) {
+    size_t n = (size_t)entries;
+    uint8_t *inputs = (uint8_t *)malloc(n * FE_DATA_BYTES);
+    uint8_t *noisy = (uint8_t *)malloc(n * FE_DATA_BYTES);
+    uint8_t *helpers = (uint8_t *)malloc(n * FE_HELPER_BYTES);
+    uint8_t *records = (uint8_t *)malloc(n * FE_RECORD_BYTES);
+    uint8_t *keys_org = (uint8_t *)malloc(n * FE_KEY_LEN);
+    uint8_t *keys = (uint8_t *)malloc(n * FE_KEY_LEN);
+    uint8_t *keys_store = (uint8_t *)malloc(n * FE_KEY_LEN);
+    int *status = (int *)malloc(n * sizeof(int));
+    int *status_store = (int *)malloc(n * sizeof(int));
+    uint8_t commit[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t r_len, k_len;
+    fe_ctx *ctx = fe_ctx_create();
+    fe_store *store = NULL;
+    fe_gallery *g_mem = NULL, *g_map = NULL;
+    int mismatch = 0;
+
+    if (!inputs || !noisy || !helpers || !records || !keys_org || !keys || !keys_store ||
+        !status || !status_store || !ctx) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+    for (size_t i = 0; i < n * FE_DATA_BYTES; i++) inputs[i] = (uint8_t)rng_next();
+    memcpy(noisy, inputs, n * FE_DATA_BYTES);
+    for (size_t i = 0; i < n; i++)
+        flip_random_bits(noisy + i * FE_DATA_BYTES, FE_DATA_BYTES, (int)(rng_next() % (STORE_ERRORS + 1)));
+
+    // 1. 등록 -> 레코드 -> 저장소 파일
+    fe_enroll_batch(ctx, inputs, n, helpers, keys_org, status);
+    for (size_t i = 0; i < n; i++) {
+        fe_key_commit(keys_org + i * FE_KEY_LEN, commit);
+        fe_record_pack(helpers + i * FE_HELPER_BYTES, FE_HELPER_BYTES, commit, FE_KEY_LEN,
+                       records + i * FE_RECORD_BYTES, &r_len);
+    }
+    printf("step,items,elapsed_us,us_per_item,mismatch\n");
+    timer_tic();
+    int ret = fe_store_write(ctx, path, records, n);
+    double write_us = timer_toc();
+    printf("write,%zu,%.1f,%.3f,%d\n", n, write_us, write_us / n, ret != FE_SUCCESS);
+
+    timer_tic();
+    store = fe_store_open(path);
+    double open_us = timer_toc();
+    if (!store || fe_store_count(store) != n) {
+        printf("fe_store_open failed!\n");
+        goto out;
+    }
+    printf("open,%zu,%.1f,%.3f,0\n", n, open_us, open_us / n);
+
+    // 2. 배치 reproduce: 메모리 helper 배열 vs 매핑된 열 (+ 키 커밋 대조)
+    timer_tic();
+    fe_reproduce_batch(ctx, noisy, helpers, n, keys, status);
+    double mem_us = timer_toc();
+    timer_tic();
+    fe_reproduce_batch_store(ctx, store, 0, noisy, n, keys_store, status_store);
+    double map_us = timer_toc();
+    mismatch = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (status[i] != status_store[i] || status[i] != FE_SUCCESS ||
+            memcmp(keys_store + i * FE_KEY_LEN, keys_org + i * FE_KEY_LEN, FE_KEY_LEN) != 0)
+            mismatch++;
+    }
+    printf("batch_mem,%zu,%.1f,%.3f,0\n", n, mem_us, mem_us / n);
+    printf("batch_store,%zu,%.1f,%.3f,%d\n", n, map_us, map_us / n, mismatch);
+
+    // 타인 probe: 커밋 대조까지 통과하면 안 됨 (실패 경로 비용)
+    for (size_t i = 0; i < n * FE_DATA_BYTES; i++) noisy[i] = (uint8_t)rng_next();
+    timer_tic();
+    fe_reproduce_batch_store(ctx, store, 0, noisy, n, keys_store, status_store);
+    double imp_us = timer_toc();
+    mismatch = 0;
+    for (size_t i = 0; i < n; i++) mismatch += (status_store[i] == FE_SUCCESS);
+    printf("batch_store_impostor,%zu,%.1f,%.3f,%d\n", n, imp_us, imp_us / n, mismatch);
+
+    // 단건 레코드 API
+    mismatch = 0;
+    timer_tic();
+    for (size_t i = 0; i < n; i++) {
+        if (fe_reproduce_record(ctx, inputs + i * FE_DATA_BYTES, FE_DATA_BYTES,
+                                records + i * FE_RECORD_BYTES, FE_RECORD_BYTES, key_rec, &k_len) != FE_SUCCESS ||
+            memcmp(key_rec, keys_org + i * FE_KEY_LEN, FE_KEY_LEN) != 0)
+            mismatch++;
+    }
+    double rec_us = timer_toc();
+    printf("record,%zu,%.1f,%.3f,%d\n", n, rec_us, rec_us / n, mismatch);
+
+    // 3. 갤러리: 항목 추가(신드롬 계산) vs 저장소 열 그대로 연결
+    timer_tic();
+    g_mem = fe_gallery_create(ctx, n, 0);
+    for (size_t i = 0; g_mem && i < n; i++) {
+        const uint8_t *h, *c;
+        fe_record_parse(records + i * FE_RECORD_BYTES, FE_RECORD_BYTES, &h, &c);
+        fe_gallery_add(g_mem, h, FE_HELPER_BYTES, c, FE_KEY_LEN, NULL);
+    }
+    double build_us = timer_toc();
+    timer_tic();
+    g_map = fe_gallery_open(ctx, store, 0);
+    double gopen_us = timer_toc();
+    if (!g_mem || !g_map) {
+        printf("gallery failed!\n");
+        goto out;
+    }
+    mismatch = 0;
+    for (int p = 0; p < STORE_PROBES; p++) {
+        size_t target = (size_t)(rng_next() % n);
+        fe_gallery_result r_mem, r_map;
+        uint8_t probe[FE_DATA_BYTES];
+        memcpy(probe, inputs + target * FE_DATA_BYTES, FE_DATA_BYTES);
+        flip_random_bits(probe, FE_DATA_BYTES, (int)(rng_next() % (STORE_ERRORS + 1)));
+        fe_gallery_identify(g_mem, probe, FE_DATA_BYTES, NULL, &r_mem);
+        fe_gallery_identify(g_map, probe, FE_DATA_BYTES, key_rec, &r_map);
+        if (r_mem.index != r_map.index || r_map.index != (long)target ||
+            memcmp(key_rec, keys_org + target * FE_KEY_LEN, FE_KEY_LEN) != 0)
+            mismatch++;
+    }
+    printf("gallery_build,%zu,%.1f,%.3f,0\n", n, build_us, build_us / n);
+    printf("gallery_open,%zu,%.1f,%.3f,%d\n", n, gopen_us, gopen_us / n, mismatch);
+
+out:
+    fe_gallery_destroy(g_map);
+    fe_gallery_destroy(g_mem);
+    fe_store_close(store);
+    fe_ctx_destroy(ctx);
+    free(status_store);
+    free(status);
+    free(keys_store);
+    free(keys);
+    free(keys_org);
+    free(records);
+    free(helpers);
+    free(noisy);
+    free(inputs);
+}
+
+/* ===== [Gallery] fe_bench gallery ===== */
+// 1:N 식별: 갤러리 N건에 대해 본인 probe(에러 0..GAL_ERRORS) / 타인 probe 검색
+// candidates_per_sec = 초당 검사한 갤러리 항목 수, prescreen_pass = probe당 근 찾기까지 간 항목 수
+#define GAL_PROBES     8      // 종류(본인 / 타인)별 probe 수
+#define GAL_ERRORS     40
+
+static void bench_gallery(int entries, int threads, int max_errors) {
+    static const int default_limits[] = { 48, FE_GALLERY_MAX_ERRORS };
+    const int *limits = default_limits;
+    int nlimits = 2;
+    uint8_t *inputs = (uint8_t *)malloc((size_t)entries * FE_DATA_BYTES);
+    uint8_t *keys = (uint8_t *)malloc((size_t)entries * FE_KEY_LEN);
+    uint8_t probe[FE_DATA_BYTES];
+    uint8_t key_rec[FE_KEY_LEN];
+    fe_ctx_params params;
+    fe_ctx *ctx = NULL;
+
+    if (max_errors > 0) {
+        limits = &max_errors;
+        nlimits = 1;
+    }
+    fe_ctx_params_default(&params);
+    params.num_threads = threads;
+    ctx = fe_ctx_create_ex(&params);
+    if (!inputs || !keys || !ctx) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+    for (size_t i = 0; i < (size_t)entries * FE_DATA_BYTES; i++) inputs[i] = (uint8_t)rng_next();
+
+    printf("max_errors,threads,entries,probe,probes,elapsed_us,candidates_per_sec,prescreen_pass,correct\n");
+    for (int l = 0; l < nlimits; l++) {
+        fe_gallery *g = fe_gallery_create(ctx, entries, limits[l]);
+        if (!g) {
+            printf("fe_gallery_create failed!\n");
+            goto out;
+        }
+        for (int i = 0; i < entries; i++)
+            fe_gallery_enroll(g, inputs + (size_t)i * FE_DATA_BYTES, FE_DATA_BYTES,
+                              keys + (size_t)i * FE_KEY_LEN, NULL);
+
+        // kind 0: 본인 (등록 데이터 + 노이즈), kind 1: 타인 (무작위 입력)
+        for (int kind = 0; kind < 2; kind++) {
+            size_t pass = 0;
+            int correct = 0;
+            double elapsed_us = 0.0;
+            for (int p = 0; p < GAL_PROBES; p++) {
+                int target = (int)(rng_next() % (uint64_t)entries);
+                fe_gallery_result res;
+                if (kind == 0) {
+                    memcpy(probe, inputs + (size_t)target * FE_DATA_BYTES, FE_DATA_BYTES);
+                    flip_random_bits(probe, FE_DATA_BYTES, (int)(rng_next() % (GAL_ERRORS + 1)));
+                } else {
+                    for (int i = 0; i < FE_DATA_BYTES; i++) probe[i] = (uint8_t)rng_next();
+                }
+                timer_tic();
+                int ret = fe_gallery_identify(g, probe, FE_DATA_BYTES, key_rec, &res);
+                elapsed_us += timer_toc();
+                pass += res.candidates;
+                if (kind == 0)
+                    correct += (ret == FE_SUCCESS && res.index == target &&
+                                memcmp(key_rec, keys + (size_t)target * FE_KEY_LEN, FE_KEY_LEN) == 0);
+                else
+                    correct += (ret == FE_FAIL_DECODE);
+            }
+            printf("%d,%d,%d,%s,%d,%.1f,%.1f,%.2f,%d\n", limits[l], threads, entries,
+                   kind ? "impostor" : "genuine", GAL_PROBES, elapsed_us,
+                   (double)GAL_PROBES * entries / (elapsed_us / 1e6),
+                   (double)pass / GAL_PROBES, correct);
+        }
+        fe_gallery_destroy(g);
+    }
+
+out:
+    fe_ctx_destroy(ctx);
+    free(keys);
+    free(inputs);
+}
+
+// 하위 명령 실행 (argv[0] = MODE), 알 수 없는 명령 / 인자면 -1
+static int run_mode(int argc, char **argv) {
+    const char *mode = argv[0];
+    rng_state = 12345;
+    if (strcmp(mode, "stream") == 0) {
+        bench_stream();
+        return 0;
+    }
+    if (strcmp(mode, "bitsliced") == 0) {
+        int threads = (argc > 1) ? atoi(argv[1]) : 1;
+        if (threads < 1) threads = 1;
+        bench_bitsliced(threads);
+        return 0;
+    }
+    if (strcmp(mode, "ct") == 0) {
+        int trials = (argc > 1) ? atoi(argv[1]) : 200;
+        if (trials < 1) trials = 1;
+        bench_ct(trials);
+        return 0;
+    }
+    if (strcmp(mode, "multi") == 0) {
+        int threads = (argc > 1) ? atoi(argv[1]) : fe_cpu_count();
+        if (threads < 1) threads = 1;
+        bench_multi(threads);
+        return 0;
+    }
+    if (strcmp(mode, "gallery") == 0) {
+        int entries = (argc > 1) ? atoi(argv[1]) : 10000;
+        int threads = (argc > 2) ? atoi(argv[2]) : fe_cpu_count();
+        int max_errors = (argc > 3) ? atoi(argv[3]) : 0;
+        if (entries < 1) entries = 1;
+        if (threads < 1) threads = 1;
+        bench_gallery(entries, threads, max_errors);
+        return 0;
+    }
+    if (strcmp(mode, "store") == 0) {
+        int entries = (argc > 1) ? atoi(argv[1]) : 10000;
+        if (entries < 1) entries = 1;
+        bench_store(entries, (argc > 2) ? argv[2] : "fe_store.bin");
+        return 0;
+    }
+    if (argc > 2 && strcmp(mode, "tables") == 0) {
+        const char *cfg = (argc > 3) ? argv[3] : NULL;
+        if (strcmp(argv[1], "write") == 0) return tables_write(argv[2], cfg);
+        if (strcmp(argv[1], "bench") == 0) {
+            bench_tables(argv[2], cfg);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    bench_opts o;
+    if (argc > 1 && argv[1][0] != '-') {
+        int ret = run_mode(argc - 1, argv + 1);
+        if (ret < 0) usage(argv[0]);
+        return (ret < 0) ? 2 : ret;
+    }
+    if (parse_opts(argc, argv, &o) != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // 1. 실행 환경 고정
+    int pinned = (o.cpu >= 0) && fe_thread_pin(o.cpu) == 0;
+    if (o.use_tsc && !FE_HAVE_TSC) o.use_tsc = 0;
+    clock_tsc = o.use_tsc;
+    if (clock_tsc) calibrate_tsc();
+    rng_state = o.seed;
+
+    fe_ctx *ctx = fe_ctx_create_ex(&o.params);
+    struct bch_workspace *ws = ctx ? fe_bch_ws_create(ctx->bch) : NULL;
+    if (!ctx || !ws) {
+        printf("# fe_ctx_create_ex failed!\n");
+        fe_ctx_destroy(ctx);
+        return 1;
+    }
+
+    // 2. 측정 조건 (결과 비교 시 같은 조건인지 확인용)
+    printf("# fe_bench rev=%s clock=%s", FE_BENCH_REV, clock_tsc ? "tsc" : "ns");
+    if (clock_tsc) printf(" tsc_mhz=%.1f", tsc_per_us);
+    printf(" trials=%d warmup=%d cpu=%d pinned=%d seed=%llu\n",
+           o.trials, o.warmup, o.cpu, pinned, (unsigned long long)o.seed);
+    printf("# encoder=%s slice_bytes=%u root_finder=%d kernel=%s reject=%s table_bytes=%zu tables=%s\n",
+           encoder_name(ctx->bch), ctx->bch->slice_bytes, o.params.root_finder,
+           (ctx->bch->kernel == BCH_KERNEL_M13T64) ? "m13t64" : "generic",
+           (ctx->bch->reject == BCH_REJECT_FULL) ? "full" : "early",
+           fe_ctx_table_bytes(&o.params), fe_ctx_tables_mapped(ctx) ? "mapped" : "built");
+
+    // 3. 측정 (--leakage면 누설 검정만)
+    if (o.leakage > 0) {
+        bench_leakage(ctx, &o);
+        fe_bch_ws_destroy(ws);
+        fe_ctx_destroy(ctx);
+        return 0;
+    }
+    bench_enroll(ctx, ws, &o);
+    bench_kdf(&o);
+    fe_stats_reset();
+    bench_reproduce(ctx, ws, &o);
+
+    // 4. 계측 히스토그램 (reproduce 전체 구간 누적)
+    if (o.stats_path) {
+        FILE *fp = strcmp(o.stats_path, "-") == 0 ? stderr : fopen(o.stats_path, "w");
+        if (fp) {
+            fe_stats_dump(fp);
+            if (fp != stderr) fclose(fp);
+        } else {
+            printf("# cannot open %s\n", o.stats_path);
+        }
+    }
+
+    // 5. 복구 실패 경로 (히스토그램에는 포함하지 않음)
+    bench_reject(ctx, ws, &o);
+
+    fe_bch_ws_destroy(ws);
+    fe_ctx_destroy(ctx);
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "fe_timer.h"
+#include "fe_pool.h"
+#include "../lib/gf.h"
+
+/* =================================================================
+ * [gf_bench] GF(2^13) 연산 백엔드별 마이크로벤치
+ * - 스칼라 테이블 (mul / sqr / div / inv)
+ * - SIMD 배열 곱 (테이블 / AVX2 / AVX-512)
+ * - bitsliced 32 / 64 레인 곱, 64 레인 pack / unpack
+ * 모든 결과를 스칼라 테이블 곱과 비교해 불일치 개수를 함께 출력합니다.
+ * 사용법: gf_bench [--len N] [--rounds R] [--cpu K]
+ * ================================================================= */
+
+#define BS_LANES 64
+
+static struct gf_tab g_tab;
+static uint16_t *g_a, *g_b, *g_r, *g_ref;
+static int g_len = 4096;
+static int g_rounds = 2000;
+static volatile unsigned int g_sink;
+
+/* ===== [PRNG] splitmix64 ===== */
+static uint64_t rng_state = 12345;
+
+static uint64_t rng_next(void) {
+    uint64_t z = (rng_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static int count_mismatch(const uint16_t *x, const uint16_t *y, int n) {
+    int bad = 0;
+    for (int i = 0; i < n; i++) bad += (x[i] != y[i]);
+    return bad;
+}
+
+static void report(const char *prim, const char *backend, uint64_t ns, int mismatch) {
+    double per = (double)ns / ((double)g_rounds * g_len);
+    printf("%s,%s,%d,%.3f,%.1f,%d\n", prim, backend, g_len, per, 1000.0 / per, mismatch);
+}
+
+/* ===== [Scalar] 테이블 조회 ===== */
+static void bench_scalar(void) {
+    uint64_t t0;
+    unsigned int acc = 0;
+
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int i = 0; i < g_len; i++) g_r[i] = (uint16_t)gf_tab_mul(&g_tab, g_a[i], g_b[i]);
+    report("mul", "table", fe_time_ns() - t0, 0);
+    memcpy(g_ref, g_r, g_len * sizeof(*g_r));
+
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int i = 0; i < g_len; i++) g_r[i] = (uint16_t)gf_tab_sqr(&g_tab, g_a[i]);
+    uint64_t ns = fe_time_ns() - t0;
+    int bad = 0;
+    for (int i = 0; i < g_len; i++) bad += (g_r[i] != gf_tab_mul(&g_tab, g_a[i], g_a[i]));
+    report("sqr", "table", ns, bad);
+
+    // b != 0 (입력 생성 시 보장)
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int i = 0; i < g_len; i++) g_r[i] = (uint16_t)gf_tab_div(&g_tab, g_a[i], g_b[i]);
+    ns = fe_time_ns() - t0;
+    bad = 0;
+    for (int i = 0; i < g_len; i++) bad += (gf_tab_mul(&g_tab, g_r[i], g_b[i]) != g_a[i]);
+    report("div", "table", ns, bad);
+
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int i = 0; i < g_len; i++) g_r[i] = (uint16_t)gf_tab_inv(&g_tab, g_b[i]);
+    ns = fe_time_ns() - t0;
+    bad = 0;
+    for (int i = 0; i < g_len; i++) bad += (gf_tab_mul(&g_tab, g_r[i], g_b[i]) != 1);
+    report("inv", "table", ns, bad);
+
+    for (int i = 0; i < g_len; i++) acc ^= g_r[i];
+    g_sink = acc;
+}
+
+/* ===== [SIMD] 배열 곱 ===== */
+static void bench_vec(void) {
+    static const char *names[] = { "vec-table", "avx2", "avx512" };
+    int top = gf13_simd_level();
+    for (int level = GF13_SIMD_NONE; level <= GF13_SIMD_AVX512; level++) {
+        if (level > top) {
+            printf("# mul,%s: not supported on this CPU\n", names[level]);
+            continue;
+        }
+        uint64_t t0 = fe_time_ns();
+        for (int r = 0; r < g_rounds; r++)
+            gf13_mul_vec_level(level, &g_tab, g_r, g_a, g_b, g_len);
+        uint64_t ns = fe_time_ns() - t0;
+        report("mul", names[level], ns, count_mismatch(g_r, g_ref, g_len));
+    }
+}
+
+/* ===== [Bitsliced] 32 / 64 레인 ===== */
+static void bench_bitsliced(void) {
+    int groups = g_len / BS_LANES;
+    uint64_t *a64 = (uint64_t *)malloc(groups * GF13_M * sizeof(uint64_t));
+    uint64_t *b64 = (uint64_t *)malloc(groups * GF13_M * sizeof(uint64_t));
+    uint64_t *r64 = (uint64_t *)malloc(groups * GF13_M * sizeof(uint64_t));
+    uint32_t *a32 = (uint32_t *)malloc(2 * groups * GF13_M * sizeof(uint32_t));
+    uint32_t *b32 = (uint32_t *)malloc(2 * groups * GF13_M * sizeof(uint32_t));
+    uint32_t *r32 = (uint32_t *)malloc(2 * groups * GF13_M * sizeof(uint32_t));
+    if (!a64 || !b64 || !r64 || !a32 || !b32 || !r32 || groups == 0) {
+        printf("# bitsliced: allocation failed or --len < %d\n", BS_LANES);
+        goto out;
+    }
+
+    // 1. pack / unpack (원소 단위 비용)
+    uint64_t t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int g = 0; g < groups; g++) gf13_bs64_pack(a64 + g * GF13_M, g_a + g * BS_LANES);
+    report("pack", "bs64", fe_time_ns() - t0, 0);
+    for (int g = 0; g < groups; g++) {
+        gf13_bs64_pack(b64 + g * GF13_M, g_b + g * BS_LANES);
+        gf13_bs32_pack(a32 + 2 * g * GF13_M, g_a + g * BS_LANES);
+        gf13_bs32_pack(a32 + (2 * g + 1) * GF13_M, g_a + g * BS_LANES + 32);
+        gf13_bs32_pack(b32 + 2 * g * GF13_M, g_b + g * BS_LANES);
+        gf13_bs32_pack(b32 + (2 * g + 1) * GF13_M, g_b + g * BS_LANES + 32);
+    }
+
+    // 2. 곱
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int g = 0; g < groups; g++)
+            gf13_bs64_mul(r64 + g * GF13_M, a64 + g * GF13_M, b64 + g * GF13_M);
+    uint64_t ns = fe_time_ns() - t0;
+
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int g = 0; g < groups; g++) gf13_bs64_unpack(g_r + g * BS_LANES, r64 + g * GF13_M);
+    uint64_t ns_unpack = fe_time_ns() - t0;
+    report("mul", "bs64", ns, count_mismatch(g_r, g_ref, groups * BS_LANES));
+    report("unpack", "bs64", ns_unpack, 0);
+
+    t0 = fe_time_ns();
+    for (int r = 0; r < g_rounds; r++)
+        for (int g = 0; g < 2 * groups; g++)
+            gf13_bs32_mul(r32 + g * GF13_M, a32 + g * GF13_M, b32 + g * GF13_M);
+    ns = fe_time_ns() - t0;
+    for (int g = 0; g < 2 * groups; g++) gf13_bs32_unpack(g_r + g * 32, r32 + g * GF13_M);
+    report("mul", "bs32", ns, count_mismatch(g_r, g_ref, groups * BS_LANES));
+
+out:
+    free(a64); free(b64); free(r64);
+    free(a32); free(b32); free(r32);
+}
+
+int main(int argc, char **argv) {
+    int cpu = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--len") == 0) g_len = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--rounds") == 0) g_rounds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--cpu") == 0) cpu = atoi(argv[i + 1]);
+        else {
+            fprintf(stderr, "usage: %s [--len N] [--rounds R] [--cpu K]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (g_len < 1 || g_rounds < 1) return 1;
+    if (cpu >= 0) fe_thread_pin(cpu);
+
+    if (gf_tab_init(&g_tab, GF13_M, GF13_POLY)) {
+        printf("# gf_tab_init failed!\n");
+        return 1;
+    }
+    g_a = (uint16_t *)malloc(g_len * sizeof(uint16_t));
+    g_b = (uint16_t *)malloc(g_len * sizeof(uint16_t));
+    g_r = (uint16_t *)malloc(g_len * sizeof(uint16_t));
+    g_ref = (uint16_t *)malloc(g_len * sizeof(uint16_t));
+    if (!g_a || !g_b || !g_r || !g_ref) {
+        printf("# allocation failed!\n");
+        return 1;
+    }
+    // a는 0 포함, b는 0 제외 (div / inv 입력)
+    for (int i = 0; i < g_len; i++) {
+        g_a[i] = (uint16_t)(rng_next() % (GF13_N + 1));
+        g_b[i] = (uint16_t)(1 + rng_next() % GF13_N);
+    }
+
+    printf("# gf_bench len=%d rounds=%d simd_level=%d table_bytes=%zu\n",
+           g_len, g_rounds, gf13_simd_level(), gf_tab_bytes(GF13_M));
+    printf("primitive,backend,elements,ns_per_elem,melem_per_sec,mismatch\n");
+    bench_scalar();
+    bench_vec();
+    bench_bitsliced();
+
+    free(g_a); free(g_b); free(g_r); free(g_ref);
+    gf_tab_free(&g_tab);
+    return 0;
+}
@@ -5,6 +5,16 @@
 #include <errno.h>
 #include <stdint.h>
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define BCH_HAVE_CLMUL
+#define BCH_TARGET_CLMUL __attribute__((target("pclmul,sse4.1")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define BCH_HAVE_CLMUL
+#define BCH_TARGET_CLMUL
+#endif
+
 #define kzalloc(size, flags) calloc(1, size)
 #define KERN_ERR "" 
 #define printk printf
@@ -15,10 +25,27 @@
 #define GF_T(_p)               ((_p)->t)
 #define GF_N(_p)               ((_p)->n)
 #endif
+#ifndef GF_ECC_BITS
+#define GF_ECC_BITS(_p)        ((_p)->ecc_bits)
+#endif
+
+/* bch_m13t64.c: word loops have constant trip counts, unroll them fully */
+#if defined(BCH_SPECIALIZED) && defined(__GNUC__)
+#define BCH_UNROLL             _Pragma("GCC unroll 32")
+#else
+#define BCH_UNROLL
+#endif
 
 #define BCH_ECC_WORDS(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 32)
 #define BCH_ECC_BYTES(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 8)
 
+#define BCH_CHIEN_BLOCK        64
+#define BCH_CLMUL_WORDS(_p)    DIV_ROUND_UP(GF_ECC_BITS(_p), 64)
+#define BCH_CLMUL_CHUNK        16
+
+/* per odd syndrome: byte evaluation[256], x*c low byte[256], x*c high bits */
+#define BCH_SYN_TAB_STRIDE(_p) (512+(1u << ((GF_M(_p) > 8) ? GF_M(_p)-8 : 0)))
+
 #ifndef DIV_ROUND_UP
 #define DIV_ROUND_UP(n,d) (((n) + (d) - 1) / (d))
 #endif
@@ -35,7 +62,7 @@ struct gf_poly_deg1 {
     unsigned int   c[2];
 };
 
-static void encode_bch_unaligned(struct bch_control *bch,
+static void encode_bch_unaligned(const struct bch_control *bch,
                  const unsigned char *data, unsigned int len,
                  uint32_t *ecc)
 {
@@ -45,28 +72,31 @@ static void encode_bch_unaligned(struct bch_control *bch,
 
     while (len--) {
         p = bch->mod8_tab + (l+1)*(((ecc[0] >> 24)^(*data++)) & 0xff);
+        BCH_UNROLL
         for (i = 0; i < l; i++)
             ecc[i] = ((ecc[i] << 8)|(ecc[i+1] >> 24))^(*p++);
         ecc[l] = (ecc[l] << 8)^(*p);
     }
 }
 
-static void load_ecc8(struct bch_control *bch, uint32_t *dst,
+static void load_ecc8(const struct bch_control *bch, uint32_t *dst,
               const uint8_t *src)
 {
     uint8_t pad[4] = {0, 0, 0, 0};
     unsigned int i, nwords = BCH_ECC_WORDS(bch)-1;
+    BCH_UNROLL
     for (i = 0; i < nwords; i++, src += 4)
         dst[i] = (src[0] << 24)|(src[1] << 16)|(src[2] << 8)|src[3];
     memcpy(pad, src, BCH_ECC_BYTES(bch)-4*nwords);
     dst[nwords] = (pad[0] << 24)|(pad[1] << 16)|(pad[2] << 8)|pad[3];
 }
 
-static void store_ecc8(struct bch_control *bch, uint8_t *dst,
+static void store_ecc8(const struct bch_control *bch, uint8_t *dst,
                const uint32_t *src)
 {
     uint8_t pad[4];
     unsigned int i, nwords = BCH_ECC_WORDS(bch)-1;
+    BCH_UNROLL
     for (i = 0; i < nwords; i++) {
         *dst++ = (src[i] >> 24);
         *dst++ = (src[i] >> 16) & 0xff;
@@ -80,8 +110,179 @@ static void store_ecc8(struct bch_control *bch, uint8_t *dst,
     memcpy(dst, pad, BCH_ECC_BYTES(bch)-4*nwords);
 }
 
-void encode_bch(struct bch_control *bch, const uint8_t *data,
-        unsigned int len, uint8_t *ecc)
+#ifdef BCH_HAVE_CLMUL
+#ifndef BCH_SPECIALIZED
+static int cpu_has_clmul(void)
+{
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 1);
+    return (r[2] >> 1) & 1;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul");
+#endif
+}
+#endif
+
+static inline uint64_t load_be64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    int i;
+    for (i = 0; i < 8; i++)
+        v = (v << 8)|p[i];
+    return v;
+}
+
+/*
+ * One 64-bit step of the Barrett fold (see encode_bch_clmul). The
+ * register is split in two halves of 128-bit lanes: e[j] holds words
+ * (2j, 2j+1) and o[j] words (2j-1, 2j), most significant word in the
+ * high half; the value is e ^ o. Shifting the register by 64 bits only
+ * swaps the roles of e and o, so the step needs no lane shuffles.
+ */
+BCH_TARGET_CLMUL
+static inline void clmul_step(__m128i *e, __m128i *o, const __m128i *gp,
+                  unsigned int w, __m128i mu, const uint8_t *data)
+{
+    unsigned int j;
+    __m128i v;
+
+    v = _mm_xor_si128(e[0], _mm_slli_si128(o[0], 8));
+    v = _mm_xor_si128(v, _mm_set_epi64x((long long)load_be64(data), 0));
+    /* high lane of v becomes q */
+    v = _mm_xor_si128(v, _mm_clmulepi64_si128(v, mu, 0x01));
+    BCH_UNROLL
+    for (j = 0; j < w; j++) {
+        e[j] = _mm_xor_si128(e[j], _mm_clmulepi64_si128(v, gp[j], 0x11));
+        o[j+1] = _mm_xor_si128(o[j+1], _mm_clmulepi64_si128(v, gp[j], 0x01));
+    }
+}
+
+/*
+ * Fold nblocks 64-bit data words into the remainder register r (the
+ * layout of ws->ecc_buf), using Barrett reduction by g:
+ *   q = floor(v*mu/x^64), v = top 64 bits of r ^ data, mu = x^(E+64)/g
+ *   r = (r << 64) ^ (q*g mod x^E)
+ * Every two steps the register moves one lane up in e/o; it is moved
+ * back to the start every BCH_CLMUL_CHUNK double steps.
+ */
+BCH_TARGET_CLMUL
+static void encode_bch_clmul(const struct bch_control *bch, uint32_t *r,
+                 const uint8_t *data, unsigned int nblocks)
+{
+    const unsigned int l = BCH_ECC_WORDS(bch);
+    const unsigned int w = DIV_ROUND_UP(BCH_CLMUL_WORDS(bch), 2);
+    const unsigned int size = BCH_CLMUL_CHUNK+w+1;
+    const uint64_t *g = bch->clmul_tab+1;
+    const __m128i mu = _mm_cvtsi64_si128((long long)bch->clmul_tab[0]);
+    unsigned int i, j, k;
+    uint32_t x[4];
+    __m128i e[size], o[size], gp[w], *pe, *po, t;
+
+    for (j = 0; j < w; j++) {
+        for (i = 0; i < 4; i++)
+            x[i] = (4*j+i < l) ? r[4*j+i] : 0;
+        e[j] = _mm_set_epi32((int)x[0], (int)x[1], (int)x[2], (int)x[3]);
+        gp[j] = _mm_set_epi64x((long long)g[2*j],
+                       (2*j+1 < BCH_CLMUL_WORDS(bch)) ?
+                       (long long)g[2*j+1] : 0);
+    }
+    for (j = w; j < size; j++)
+        e[j] = _mm_setzero_si128();
+    for (j = 0; j < size; j++)
+        o[j] = _mm_setzero_si128();
+
+    k = 0;
+    while (nblocks >= 2) {
+        clmul_step(e+k, o+k, gp, w, mu, data);
+        clmul_step(o+k+1, e+k, gp, w, mu, data+8);
+        data += 16;
+        nblocks -= 2;
+        if (++k == BCH_CLMUL_CHUNK) {
+            memmove(e, e+k, (w+1)*sizeof(*e));
+            memmove(o, o+k, (w+1)*sizeof(*o));
+            for (j = w+1; j < size; j++)
+                e[j] = o[j] = _mm_setzero_si128();
+            k = 0;
+        }
+    }
+    pe = e+k;
+    po = o+k;
+    if (nblocks) {
+        clmul_step(pe, po, gp, w, mu, data);
+        pe = o+k+1;
+        po = e+k;
+    }
+
+    BCH_UNROLL
+    for (j = 0; j < w; j++) {
+        t = _mm_xor_si128(pe[j], _mm_slli_si128(po[j], 8));
+        t = _mm_xor_si128(t, _mm_srli_si128(po[j+1], 8));
+        x[0] = (uint32_t)_mm_extract_epi32(t, 3);
+        x[1] = (uint32_t)_mm_extract_epi32(t, 2);
+        x[2] = (uint32_t)_mm_extract_epi32(t, 1);
+        x[3] = (uint32_t)_mm_extract_epi32(t, 0);
+        for (i = 0; i < 4; i++)
+            if (4*j+i < l)
+                r[4*j+i] = x[i];
+    }
+}
+#endif
+
+/*
+ * Slicing-by-4k: consume k 32-bit words per step. Table b holds the
+ * remainders of i*x^(8b) shifted through the register, so the first
+ * four tables are the ones used by the 4-byte loop in encode_bch_ws.
+ * The register is updated with eight tables (two words) per pass.
+ */
+static inline void encode_bch_wide(const struct bch_control *bch,
+                   uint32_t *r, const uint32_t *pdata,
+                   unsigned int nsteps, const unsigned int k)
+{
+    const unsigned int l = BCH_ECC_WORDS(bch)-1;
+    const unsigned int tsz = 256*(l+1);
+    unsigned int i, c;
+    uint32_t w[4], lo, hi;
+    const uint32_t *tab, *p0, *p1, *p2, *p3, *p4, *p5, *p6, *p7;
+
+    while (nsteps--) {
+        for (c = 0; c < k; c++)
+            w[c] = ((c <= l) ? r[c] : 0)^cpu_to_be32(*pdata++);
+        for (c = 0; c < k; c += 2) {
+            /* w[c+1] uses tables 4(k-2-c)..+3, w[c] the next four */
+            tab = bch->mod8_tab+4*(k-2-c)*tsz;
+            lo = w[c+1];
+            hi = w[c];
+            p0 = tab + (l+1)*((lo >>  0) & 0xff);
+            p1 = tab + tsz + (l+1)*((lo >>  8) & 0xff);
+            p2 = tab + 2*tsz + (l+1)*((lo >> 16) & 0xff);
+            p3 = tab + 3*tsz + (l+1)*((lo >> 24) & 0xff);
+            p4 = tab + 4*tsz + (l+1)*((hi >>  0) & 0xff);
+            p5 = tab + 5*tsz + (l+1)*((hi >>  8) & 0xff);
+            p6 = tab + 6*tsz + (l+1)*((hi >> 16) & 0xff);
+            p7 = tab + 7*tsz + (l+1)*((hi >> 24) & 0xff);
+            if (c == 0) {
+                /* first pass also shifts the register by k words */
+                BCH_UNROLL
+                for (i = 0; i+k <= l; i++)
+                    r[i] = r[i+k]^p0[i]^p1[i]^p2[i]^p3[i]^
+                        p4[i]^p5[i]^p6[i]^p7[i];
+                for (; i <= l; i++)
+                    r[i] = p0[i]^p1[i]^p2[i]^p3[i]^
+                        p4[i]^p5[i]^p6[i]^p7[i];
+            } else {
+                BCH_UNROLL
+                for (i = 0; i <= l; i++)
+                    r[i] ^= p0[i]^p1[i]^p2[i]^p3[i]^
+                        p4[i]^p5[i]^p6[i]^p7[i];
+            }
+        }
+    }
+}
+
+void encode_bch_ws(const struct bch_control *bch, struct bch_workspace *ws,
+           const uint8_t *data, unsigned int len, uint8_t *ecc)
 {
     const unsigned int l = BCH_ECC_WORDS(bch)-1;
     unsigned int i, mlen;
@@ -93,25 +294,55 @@ void encode_bch(struct bch_control *bch, const uint8_t *data,
     const uint32_t * const tab3 = tab2 + 256*(l+1);
     const uint32_t *pdata, *p0, *p1, *p2, *p3;
 
+#ifndef BCH_SPECIALIZED
+    if (bch->kernel == BCH_KERNEL_M13T64) {
+        encode_bch_ws_m13t64(bch, ws, data, len, ecc);
+        return;
+    }
+#endif
     if (ecc) {
-        load_ecc8(bch, bch->ecc_buf, ecc);
+        load_ecc8(bch, ws->ecc_buf, ecc);
     } else {
-        memset(bch->ecc_buf, 0, sizeof(r));
+        memset(ws->ecc_buf, 0, sizeof(r));
     }
 
+#ifdef BCH_HAVE_CLMUL
+    if (bch->encoder == BCH_ENC_CLMUL) {
+        mlen = len/8;
+        encode_bch_clmul(bch, ws->ecc_buf, data, mlen);
+        data += 8*mlen;
+        len  -= 8*mlen;
+        if (len)
+            encode_bch_unaligned(bch, data, len, ws->ecc_buf);
+        if (ecc)
+            store_ecc8(bch, ecc, ws->ecc_buf);
+        return;
+    }
+#endif
+
     m = ((uintptr_t)data) & 3;
     if (m) {
         mlen = (len < (4-m)) ? len : 4-m;
-        encode_bch_unaligned(bch, data, mlen, bch->ecc_buf);
+        encode_bch_unaligned(bch, data, mlen, ws->ecc_buf);
         data += mlen;
         len  -= mlen;
     }
 
     pdata = (uint32_t *)data;
+    memcpy(r, ws->ecc_buf, sizeof(r));
+    if (bch->slice_bytes > 4) {
+        mlen = len/bch->slice_bytes;
+        if (bch->slice_bytes == 8)
+            encode_bch_wide(bch, r, pdata, mlen, 2);
+        else
+            encode_bch_wide(bch, r, pdata, mlen, 4);
+        pdata += mlen*(bch->slice_bytes/4);
+        data  += mlen*bch->slice_bytes;
+        len   -= mlen*bch->slice_bytes;
+    }
     mlen  = len/4;
     data += 4*mlen;
     len  -= 4*mlen;
-    memcpy(r, bch->ecc_buf, sizeof(r));
 
     while (mlen--) {
         w = r[0]^cpu_to_be32(*pdata++);
@@ -119,19 +350,75 @@ void encode_bch(struct bch_control *bch, const uint8_t *data,
         p1 = tab1 + (l+1)*((w >>  8) & 0xff);
         p2 = tab2 + (l+1)*((w >> 16) & 0xff);
         p3 = tab3 + (l+1)*((w >> 24) & 0xff);
+        BCH_UNROLL
         for (i = 0; i < l; i++)
             r[i] = r[i+1]^p0[i]^p1[i]^p2[i]^p3[i];
         r[l] = p0[l]^p1[l]^p2[l]^p3[l];
     }
-    memcpy(bch->ecc_buf, r, sizeof(r));
+    memcpy(ws->ecc_buf, r, sizeof(r));
 
     if (len)
-        encode_bch_unaligned(bch, data, len, bch->ecc_buf);
+        encode_bch_unaligned(bch, data, len, ws->ecc_buf);
     if (ecc)
-        store_ecc8(bch, ecc, bch->ecc_buf);
+        store_ecc8(bch, ecc, ws->ecc_buf);
 }
 
-static inline int modulo(struct bch_control *bch, unsigned int v)
+#ifndef BCH_SPECIALIZED
+void encode_bch(struct bch_control *bch, const uint8_t *data,
+        unsigned int len, uint8_t *ecc)
+{
+    encode_bch_ws(bch, bch->ws, data, len, ecc);
+}
+
+/*
+ * Remainder in a time independent of the data, for the constant-time
+ * decoder. The CLMUL fold is data-independent for whole 64-bit words, so
+ * the data is front-padded with zero bytes (leading zeros do not change
+ * the remainder) and no byte goes through the table tail. Without CLMUL
+ * every byte is folded with the eight single-bit rows of the byte table,
+ * selected by masks instead of a lookup indexed by the data.
+ */
+void encode_bch_ct(const struct bch_control *bch, const uint8_t *data,
+           unsigned int len, uint8_t *ecc)
+{
+    const unsigned int l = BCH_ECC_WORDS(bch)-1;
+    unsigned int i, b;
+    uint32_t r[l+1], v, mask;
+    const uint32_t *row;
+
+    memset(r, 0, sizeof(r));
+#ifdef BCH_HAVE_CLMUL
+    if (bch->encoder == BCH_ENC_CLMUL) {
+        const unsigned int head = len%8;
+        uint8_t first[8];
+
+        if (head) {
+            memset(first, 0, sizeof(first));
+            memcpy(first+8-head, data, head);
+            encode_bch_clmul(bch, r, first, 1);
+        }
+        encode_bch_clmul(bch, r, data+head, len/8);
+        store_ecc8(bch, ecc, r);
+        return;
+    }
+#endif
+    while (len--) {
+        v = (r[0] >> 24)^(*data++);
+        for (i = 0; i < l; i++)
+            r[i] = (r[i] << 8)|(r[i+1] >> 24);
+        r[l] <<= 8;
+        for (b = 0; b < 8; b++) {
+            mask = 0-((v >> b) & 1);
+            row = bch->mod8_tab+(l+1)*(1u << b);
+            for (i = 0; i <= l; i++)
+                r[i] ^= row[i] & mask;
+        }
+    }
+    store_ecc8(bch, ecc, r);
+}
+#endif
+
+static inline int modulo(const struct bch_control *bch, unsigned int v)
 {
     const unsigned int n = GF_N(bch);
     while (v >= n) {
@@ -141,7 +428,7 @@ static inline int modulo(struct bch_control *bch, unsigned int v)
     return v;
 }
 
-static inline int mod_s(struct bch_control *bch, unsigned int v)
+static inline int mod_s(const struct bch_control *bch, unsigned int v)
 {
     const unsigned int n = GF_N(bch);
     return (v < n) ? v : v-n;
@@ -160,67 +447,100 @@ static inline int parity(unsigned int x)
     return (x >> 28) & 1;
 }
 
-static inline unsigned int gf_mul(struct bch_control *bch, unsigned int a,
+static inline unsigned int gf_mul(const struct bch_control *bch, unsigned int a,
                   unsigned int b)
 {
-    return (a && b) ? bch->a_pow_tab[mod_s(bch, bch->a_log_tab[a]+
-                           bch->a_log_tab[b])] : 0;
+    return gf_tab_mul(&bch->gf, a, b);
 }
 
-static inline unsigned int gf_sqr(struct bch_control *bch, unsigned int a)
+static inline unsigned int gf_sqr(const struct bch_control *bch, unsigned int a)
 {
-    return a ? bch->a_pow_tab[mod_s(bch, 2*bch->a_log_tab[a])] : 0;
+    return gf_tab_sqr(&bch->gf, a);
 }
 
-static inline unsigned int gf_div(struct bch_control *bch, unsigned int a,
+static inline unsigned int gf_div(const struct bch_control *bch, unsigned int a,
                   unsigned int b)
 {
-    return a ? bch->a_pow_tab[mod_s(bch, bch->a_log_tab[a]+
-                     GF_N(bch)-bch->a_log_tab[b])] : 0;
+    return gf_tab_div(&bch->gf, a, b);
 }
 
-static inline unsigned int gf_inv(struct bch_control *bch, unsigned int a)
+static inline unsigned int gf_inv(const struct bch_control *bch, unsigned int a)
 {
-    return bch->a_pow_tab[GF_N(bch)-bch->a_log_tab[a]];
+    return gf_tab_inv(&bch->gf, a);
 }
 
-static inline unsigned int a_pow(struct bch_control *bch, int i)
+static inline unsigned int a_pow(const struct bch_control *bch, int i)
 {
     return bch->a_pow_tab[modulo(bch, i)];
 }
 
-static inline int a_log(struct bch_control *bch, unsigned int x)
+static inline int a_log(const struct bch_control *bch, unsigned int x)
 {
     return bch->a_log_tab[x];
 }
 
-static inline int a_ilog(struct bch_control *bch, unsigned int x)
+static inline int a_ilog(const struct bch_control *bch, unsigned int x)
 {
     return mod_s(bch, GF_N(bch)-bch->a_log_tab[x]);
 }
 
-static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
+static void compute_syndromes(const struct bch_control *bch, uint32_t *ecc,
                   unsigned int *syn)
 {
-    int i, j, s;
-    unsigned int m;
-    uint32_t poly;
-    const int t = GF_T(bch);
-    s = bch->ecc_bits;
-    m = ((unsigned int)s) & 31;
-    if (m)
-        ecc[s/32] &= ~((1u << (32-m))-1);
-    memset(syn, 0, 2*t*sizeof(*syn));
-    do {
-        poly = *ecc++;
-        s -= 32;
-        while (poly) {
-            i = deg(poly);
-            for (j = 0; j < 2*t; j += 2)
-                syn[j] ^= a_pow(bch, (j+1)*(i+s));
-            poly ^= (1 << i);
-        }
-    } while (s > 0);
+    const unsigned int t = GF_T(bch);
+    const unsigned int words = BCH_ECC_WORDS(bch);
+    const unsigned int nbytes = 4*words;
+    const unsigned int pad = 32*words-GF_ECC_BITS(bch);
+    const unsigned int stride = BCH_SYN_TAB_STRIDE(bch);
+    const uint16_t *tab;
+    unsigned int i, j, k, e, s0, s1, s2, s3;
+    uint8_t r[nbytes];
+
+    if (pad)
+        ecc[words-1] &= ~((1u << pad)-1);
+    BCH_UNROLL
+    for (i = 0; i < words; i++) {
+        r[4*i+0] = ecc[i] >> 24;
+        r[4*i+1] = ecc[i] >> 16;
+        r[4*i+2] = ecc[i] >> 8;
+        r[4*i+3] = ecc[i];
+    }
+    /*
+     * Horner evaluation of the remainder at alpha^(2j+1), one byte per
+     * step: s = s*alpha^(8(2j+1)) + byte(alpha^(2j+1)). Four syndromes
+     * are carried together to hide the table lookup latency.
+     */
+    for (j = 0; j+4 <= t; j += 4) {
+        const uint16_t *t0 = bch->syn_tab+j*stride;
+        const uint16_t *t1 = t0+stride, *t2 = t1+stride, *t3 = t2+stride;
+        s0 = s1 = s2 = s3 = 0;
+        for (k = 0; k < nbytes; k++) {
+            s0 = t0[256+(s0 & 0xff)]^t0[512+(s0 >> 8)]^t0[r[k]];
+            s1 = t1[256+(s1 & 0xff)]^t1[512+(s1 >> 8)]^t1[r[k]];
+            s2 = t2[256+(s2 & 0xff)]^t2[512+(s2 >> 8)]^t2[r[k]];
+            s3 = t3[256+(s3 & 0xff)]^t3[512+(s3 >> 8)]^t3[r[k]];
+        }
+        syn[2*j+0] = s0;
+        syn[2*j+2] = s1;
+        syn[2*j+4] = s2;
+        syn[2*j+6] = s3;
+    }
+    for (; j < t; j++) {
+        tab = bch->syn_tab+j*stride;
+        s0 = 0;
+        for (k = 0; k < nbytes; k++)
+            s0 = tab[256+(s0 & 0xff)]^tab[512+(s0 >> 8)]^tab[r[k]];
+        syn[2*j] = s0;
+    }
+    /* the last byte was evaluated pad positions too high */
+    if (pad) {
+        for (j = 0; j < t; j++) {
+            e = (2*j+1)*pad;
+            if (syn[2*j])
+                syn[2*j] = a_pow(bch, a_log(bch, syn[2*j])+
+                         GF_N(bch)-modulo(bch, e));
+        }
+    }
     for (j = 0; j < t; j++)
         syn[2*j+1] = gf_sqr(bch, syn[j]);
 }
@@ -230,54 +550,98 @@ static void gf_poly_copy(struct gf_poly *dst, struct gf_poly *src)
     memcpy(dst, src, GF_POLY_SZ(src->deg));
 }
 
-static int compute_error_locator_polynomial(struct bch_control *bch,
-                        const unsigned int *syn)
+/*
+ * Berlekamp-Massey for binary codes (odd steps skipped) on flat arrays.
+ * Each coefficient of sigma is kept next to its log, zero mapping to the
+ * 2n sentinel of the gf tables, so every product is one lookup with
+ * no zero test and no modulo. This is the classic BM, not the
+ * inversionless one: d/pd is still a division, done as a log
+ * subtraction. It also branches on d == 0 and on a length change, and
+ * the work follows the current degree, so its timing depends on the
+ * error count. The previous polynomial B is kept unshifted with its x^s
+ * offset: a length change swaps buffers instead of copying gf_poly
+ * structs. The constant-time decoder does not use this function; it has
+ * its own fixed-round inversionless BM with masked updates (ct_bm_* in
+ * bch_bs64.c).
+ */
+static int compute_error_locator_polynomial(const struct bch_control *bch,
+                        struct bch_workspace *ws,
+                        const unsigned int *syn,
+                        unsigned int max_deg)
 {
     const unsigned int t = GF_T(bch);
     const unsigned int n = GF_N(bch);
-    unsigned int i, j, tmp, l, pd = 1, d = syn[0];
-    
-    struct gf_poly *elp = (struct gf_poly *)bch->elp;
-    struct gf_poly *pelp = (struct gf_poly *)bch->poly_2t[0];
-    struct gf_poly *elp_copy = (struct gf_poly *)bch->poly_2t[1];
-    
-    int k, pp = -1;
-    memset(pelp, 0, GF_POLY_SZ(2*t));
-    memset(elp, 0, GF_POLY_SZ(2*t));
-    pelp->deg = 0;
-    pelp->c[0] = 1;
-    elp->deg = 0;
-    elp->c[0] = 1;
-
-    for (i = 0; (i < t) && (elp->deg <= t); i++) {
+    const unsigned int nc = 2*t+8;
+    const unsigned int zero = 2*n;
+    const uint16_t *lg = bch->gf.log;
+    const uint16_t *ex = bch->gf.exp;
+    struct gf_poly *elp = (struct gf_poly *)ws->elp;
+    unsigned int buf[6][nc], rsyn[3*t+8];
+    unsigned int *lam = buf[0], *llam = buf[1], *pb = buf[2], *lpb = buf[3];
+    unsigned int *nl = buf[4], *nll = buf[5], *tmp;
+    unsigned int i, j, c, d, ldeg = 0, pdeg = 0, s = 1, lpd = 0;
+    int e;
+
+    for (j = 0; j < nc; j++) {
+        lam[j] = pb[j] = nl[j] = 0;
+        llam[j] = lpb[j] = nll[j] = zero;
+    }
+    lam[0] = pb[0] = 1;
+    llam[0] = lpb[0] = 0;
+    /* rsyn[2t-1-k] = log S(k+1), so S(2i+3-j) is rsyn[2t-3-2i+j] */
+    for (j = 0; j < 2*t; j++)
+        rsyn[2*t-1-j] = lg[syn[j]];
+    for (j = 2*t; j < 3*t+8; j++)
+        rsyn[j] = zero;
+
+    d = syn[0];
+    for (i = 0; (i < t) && (ldeg <= max_deg); i++, s += 2) {
         if (d) {
-            k = 2*i-pp;
-            gf_poly_copy(elp_copy, elp);
-            tmp = a_log(bch, d)+n-a_log(bch, pd);
-            for (j = 0; j <= pelp->deg; j++) {
-                if (pelp->c[j]) {
-                    l = a_log(bch, pelp->c[j]);
-                    elp->c[j+k] ^= a_pow(bch, tmp+l);
+            /* sigma += (d/pd) x^s B, c = log(d/pd) in [0, n) */
+            e = (int)lg[d]-(int)lpd;
+            c = (unsigned int)(e+((e >> 31) & (int)n));
+            if (pdeg+s > ldeg) {
+                if (pdeg+s > 2*t+1) return -1;
+                /* spare holds old B: overwrite up to the larger degree */
+                for (j = 0; j <= ((ldeg > pdeg) ? ldeg : pdeg); j++) {
+                    nl[j] = lam[j];
+                    nll[j] = llam[j];
+                }
+                for (j = 0; j <= pdeg; j++) {
+                    nl[j+s] ^= ex[c+lpb[j]];
+                    nll[j+s] = lg[nl[j+s]];
+                }
+                /* B <- old sigma, sigma <- new, spare <- old B */
+                tmp = pb;  pb = lam;  lam = nl;  nl = tmp;
+                tmp = lpb; lpb = llam; llam = nll; nll = tmp;
+                j = ldeg;
+                ldeg = pdeg+s;
+                pdeg = j;
+                lpd = lg[d];
+                s = 0;
+            } else {
+                for (j = 0; j <= pdeg; j++) {
+                    lam[j+s] ^= ex[c+lpb[j]];
+                    llam[j+s] = lg[lam[j+s]];
                 }
-            }
-            tmp = pelp->deg+k;
-            if (tmp > elp->deg) {
-                elp->deg = tmp;
-                gf_poly_copy(pelp, elp_copy);
-                pd = d;
-                pp = 2*i;
             }
         }
         if (i < t-1) {
-            d = syn[2*i+2];
-            for (j = 1; j <= elp->deg; j++)
-                d ^= gf_mul(bch, elp->c[j], syn[2*i+2-j]);
+            /* d = sum_{j=0..deg} sigma_j S(2i+3-j), sigma_0 = 1 */
+            const unsigned int *ls = rsyn+2*t-3-2*i;
+            d = 0;
+            for (j = 0; j <= ldeg; j++)
+                d ^= ex[llam[j]+ls[j]];
         }
     }
-    return (elp->deg > t) ? -1 : (int)elp->deg;
+    elp->deg = ldeg;
+    if (ldeg > max_deg)
+        return -1;
+    memcpy(elp->c, lam, (ldeg+1)*sizeof(*lam));
+    return (int)ldeg;
 }
 
-static int solve_linear_system(struct bch_control *bch, unsigned int *rows,
+static int solve_linear_system(const struct bch_control *bch, unsigned int *rows,
                    unsigned int *sol, int nsol)
 {
     const int m = GF_M(bch);
@@ -334,7 +698,7 @@ static int solve_linear_system(struct bch_control *bch, unsigned int *rows,
     return nsol;
 }
 
-static int find_affine4_roots(struct bch_control *bch, unsigned int a,
+static int find_affine4_roots(const struct bch_control *bch, unsigned int a,
                   unsigned int b, unsigned int c,
                   unsigned int *roots)
 {
@@ -361,7 +725,7 @@ static int find_affine4_roots(struct bch_control *bch, unsigned int a,
     return solve_linear_system(bch, rows, roots, 4);
 }
 
-static int find_poly_deg1_roots(struct bch_control *bch, struct gf_poly *poly,
+static int find_poly_deg1_roots(const struct bch_control *bch, struct gf_poly *poly,
                 unsigned int *roots)
 {
     int n = 0;
@@ -371,7 +735,7 @@ static int find_poly_deg1_roots(struct bch_control *bch, struct gf_poly *poly,
     return n;
 }
 
-static int find_poly_deg2_roots(struct bch_control *bch, struct gf_poly *poly,
+static int find_poly_deg2_roots(const struct bch_control *bch, struct gf_poly *poly,
                 unsigned int *roots)
 {
     int n = 0, i, l0, l1, l2;
@@ -398,7 +762,7 @@ static int find_poly_deg2_roots(struct bch_control *bch, struct gf_poly *poly,
     return n;
 }
 
-static int find_poly_deg3_roots(struct bch_control *bch, struct gf_poly *poly,
+static int find_poly_deg3_roots(const struct bch_control *bch, struct gf_poly *poly,
                 unsigned int *roots)
 {
     int i, n = 0;
@@ -421,7 +785,7 @@ static int find_poly_deg3_roots(struct bch_control *bch, struct gf_poly *poly,
     return n;
 }
 
-static int find_poly_deg4_roots(struct bch_control *bch, struct gf_poly *poly,
+static int find_poly_deg4_roots(const struct bch_control *bch, struct gf_poly *poly,
                 unsigned int *roots)
 {
     int i, l, n = 0;
@@ -460,7 +824,7 @@ static int find_poly_deg4_roots(struct bch_control *bch, struct gf_poly *poly,
     return n;
 }
 
-static void gf_poly_logrep(struct bch_control *bch,
+static void gf_poly_logrep(const struct bch_control *bch,
                const struct gf_poly *a, int *rep)
 {
     int i, d = a->deg, l = GF_N(bch)-a_log(bch, a->c[a->deg]);
@@ -468,15 +832,15 @@ static void gf_poly_logrep(struct bch_control *bch,
         rep[i] = a->c[i] ? mod_s(bch, a_log(bch, a->c[i])+l) : -1;
 }
 
-static void gf_poly_mod(struct bch_control *bch, struct gf_poly *a,
-            const struct gf_poly *b, int *rep)
+static void gf_poly_mod(const struct bch_control *bch, struct bch_workspace *ws,
+            struct gf_poly *a, const struct gf_poly *b, int *rep)
 {
     int la, p, m;
     unsigned int i, j, *c = a->c;
     const unsigned int d = b->deg;
     if (a->deg < d) return;
     if (!rep) {
-        rep = bch->cache;
+        rep = ws->cache;
         gf_poly_logrep(bch, b, rep);
     }
     for (j = a->deg; j >= d; j--) {
@@ -494,12 +858,13 @@ static void gf_poly_mod(struct bch_control *bch, struct gf_poly *a,
     while (!c[a->deg] && a->deg) a->deg--;
 }
 
-static void gf_poly_div(struct bch_control *bch, struct gf_poly *a,
-            const struct gf_poly *b, struct gf_poly *q)
+static void gf_poly_div(const struct bch_control *bch, struct bch_workspace *ws,
+            struct gf_poly *a, const struct gf_poly *b,
+            struct gf_poly *q)
 {
     if (a->deg >= b->deg) {
         q->deg = a->deg-b->deg;
-        gf_poly_mod(bch, a, b, NULL);
+        gf_poly_mod(bch, ws, a, b, NULL);
         memcpy(q->c, &a->c[b->deg], (1+q->deg)*sizeof(unsigned int));
     } else {
         q->deg = 0;
@@ -507,8 +872,9 @@ static void gf_poly_div(struct bch_control *bch, struct gf_poly *a,
     }
 }
 
-static struct gf_poly *gf_poly_gcd(struct bch_control *bch, struct gf_poly *a,
-                   struct gf_poly *b)
+static struct gf_poly *gf_poly_gcd(const struct bch_control *bch,
+                   struct bch_workspace *ws,
+                   struct gf_poly *a, struct gf_poly *b)
 {
     struct gf_poly *tmp;
     if (a->deg < b->deg) {
@@ -517,7 +883,7 @@ static struct gf_poly *gf_poly_gcd(struct bch_control *bch, struct gf_poly *a,
         a = tmp;
     }
     while (b->deg > 0) {
-        gf_poly_mod(bch, a, b, NULL);
+        gf_poly_mod(bch, ws, a, b, NULL);
         tmp = b;
         b = a;
         a = tmp;
@@ -525,9 +891,16 @@ static struct gf_poly *gf_poly_gcd(struct bch_control *bch, struct gf_poly *a,
     return a;
 }
 
-static void compute_trace_bk_mod(struct bch_control *bch, int k,
-                 const struct gf_poly *f, struct gf_poly *z,
-                 struct gf_poly *out)
+/*
+ * Tr(alpha^k x) mod f by m squarings. With check set, one more squaring
+ * gives alpha^k x^(2^m) mod f, which equals alpha^k x iff f divides
+ * x^(2^m)-x, i.e. f splits into distinct roots of GF(2^m): a locator
+ * that fails this cannot have deg roots and the decode is rejected here.
+ */
+static int compute_trace_bk_mod(const struct bch_control *bch,
+                struct bch_workspace *ws, int k,
+                const struct gf_poly *f, struct gf_poly *z,
+                struct gf_poly *out, int check)
 {
     const int m = GF_M(bch);
     int i, j;
@@ -536,7 +909,7 @@ static void compute_trace_bk_mod(struct bch_control *bch, int k,
     z->c[1] = bch->a_pow_tab[k];
     out->deg = 0;
     memset(out, 0, GF_POLY_SZ(f->deg));
-    gf_poly_logrep(bch, f, bch->cache);
+    gf_poly_logrep(bch, f, ws->cache);
     for (i = 0; i < m; i++) {
         for (j = z->deg; j >= 0; j--) {
             out->c[j] ^= z->c[j];
@@ -545,42 +918,50 @@ static void compute_trace_bk_mod(struct bch_control *bch, int k,
         }
         if (z->deg > out->deg)
             out->deg = z->deg;
-        if (i < m-1) {
+        if ((i < m-1) || check) {
             z->deg *= 2;
-            gf_poly_mod(bch, z, f, bch->cache);
+            gf_poly_mod(bch, ws, z, f, ws->cache);
         }
     }
     while (!out->c[out->deg] && out->deg) out->deg--;
+    if (check && ((z->deg != 1) || z->c[0] || (z->c[1] != bch->a_pow_tab[k])))
+        return -1;
+    return 0;
 }
 
-static void factor_polynomial(struct bch_control *bch, int k, struct gf_poly *f,
-                  struct gf_poly **g, struct gf_poly **h)
+static int factor_polynomial(const struct bch_control *bch,
+                 struct bch_workspace *ws, int k, struct gf_poly *f,
+                 struct gf_poly **g, struct gf_poly **h, int check)
 {
-    struct gf_poly *f2 = (struct gf_poly *)bch->poly_2t[0];
-    struct gf_poly *q  = (struct gf_poly *)bch->poly_2t[1];
-    struct gf_poly *tk = (struct gf_poly *)bch->poly_2t[2];
-    struct gf_poly *z  = (struct gf_poly *)bch->poly_2t[3];
+    struct gf_poly *f2 = (struct gf_poly *)ws->poly_2t[0];
+    struct gf_poly *q  = (struct gf_poly *)ws->poly_2t[1];
+    struct gf_poly *tk = (struct gf_poly *)ws->poly_2t[2];
+    struct gf_poly *z  = (struct gf_poly *)ws->poly_2t[3];
     struct gf_poly *gcd;
     *g = f;
     *h = NULL;
-    compute_trace_bk_mod(bch, k, f, z, tk);
+    if (compute_trace_bk_mod(bch, ws, k, f, z, tk, check))
+        return -1;
     if (tk->deg > 0) {
         gf_poly_copy(f2, f);
-        gcd = gf_poly_gcd(bch, f2, tk);
+        gcd = gf_poly_gcd(bch, ws, f2, tk);
         if (gcd->deg < f->deg) {
-            gf_poly_div(bch, f, gcd, q);
+            gf_poly_div(bch, ws, f, gcd, q);
             *h = &((struct gf_poly_deg1 *)f)[gcd->deg].poly;
             gf_poly_copy(*g, gcd);
             gf_poly_copy(*h, q);
         }
     }
+    return 0;
 }
 
-static int find_poly_roots(struct bch_control *bch, unsigned int k,
+static int find_poly_roots(const struct bch_control *bch,
+               struct bch_workspace *ws, unsigned int k,
                struct gf_poly *poly, unsigned int *roots)
 {
     int cnt;
     struct gf_poly *f1, *f2;
+    BCH_TRACE_MAX(ws, depth, k);
     switch (poly->deg) {
     case 1: cnt = find_poly_deg1_roots(bch, poly, roots); break;
     case 2: cnt = find_poly_deg2_roots(bch, poly, roots); break;
@@ -589,49 +970,145 @@ static int find_poly_roots(struct bch_control *bch, unsigned int k,
     default:
         cnt = 0;
         if (poly->deg && (k <= GF_M(bch))) {
-            factor_polynomial(bch, k, poly, &f1, &f2);
-            if (f1) cnt += find_poly_roots(bch, k+1, f1, roots);
-            if (f2) cnt += find_poly_roots(bch, k+1, f2, roots+cnt);
+            /* the split test runs once, on the full locator */
+            if (factor_polynomial(bch, ws, k, poly, &f1, &f2,
+                          (k == 1) && (bch->reject == BCH_REJECT_EARLY)))
+                return 0;
+            if (f1) cnt += find_poly_roots(bch, ws, k+1, f1, roots);
+            if (f2) cnt += find_poly_roots(bch, ws, k+1, f2, roots+cnt);
         }
         break;
     }
     return cnt;
 }
 
-int decode_bch(struct bch_control *bch, const uint8_t *data, unsigned int len,
-           const uint8_t *recv_ecc, const uint8_t *calc_ecc,
-           const unsigned int *syn, unsigned int *errloc)
+static int chien_search(const struct bch_control *bch, struct bch_workspace *ws,
+            const struct gf_poly *poly, unsigned int nbits,
+            unsigned int *roots)
+{
+    const unsigned int n = GF_N(bch);
+    const unsigned int d = poly->deg;
+    unsigned int i, k, p, p0, nb, blk, x, cnt = 0;
+    unsigned int acc[BCH_CHIEN_BLOCK];
+    const uint16_t *pow2;
+    int *lg = ws->cache;
+    /*
+     * Evaluate sigma(alpha^-p) for the nbits valid positions only,
+     * BCH_CHIEN_BLOCK positions at a time, and stop once deg roots are
+     * found. Within a block the exponent of term i only decreases by
+     * i per position; starting it in [n, 2n) and reading the doubled
+     * antilog table keeps every lookup independent and branch-free.
+     * That needs d*(blk-1) < n, so small fields get shorter blocks.
+     */
+    blk = n/d;
+    if (blk > BCH_CHIEN_BLOCK)
+        blk = BCH_CHIEN_BLOCK;
+    for (i = 1; i <= d; i++)
+        lg[i] = poly->c[i] ? a_log(bch, poly->c[i]) : -1;
+    for (p0 = 0; (p0 < nbits) && (cnt < d); p0 += blk) {
+        nb = (nbits-p0 < blk) ? nbits-p0 : blk;
+        for (k = 0; k < nb; k++)
+            acc[k] = poly->c[0];
+        for (i = 1; i <= d; i++) {
+            if (lg[i] < 0)
+                continue;
+            x = mod_s(bch, lg[i]+n-modulo(bch, i*p0))+n;
+            pow2 = bch->a_pow_tab+x;
+            for (k = 0; k < nb; k++)
+                acc[k] ^= pow2[-(int)(i*k)];
+        }
+        for (k = 0; k < nb; k++) {
+            if (!acc[k]) {
+                p = p0+k;
+                if (cnt < d)
+                    roots[cnt] = p;
+                cnt++;
+            }
+        }
+        /* remaining positions can no longer hold the missing roots */
+        if ((bch->reject == BCH_REJECT_EARLY) &&
+            (cnt < d) && (d-cnt > nbits-p0-nb))
+            break;
+    }
+    return cnt;
+}
+
+/*
+ * Chien has no factoring step to piggyback on, so in early reject mode
+ * the locator is checked to split over GF(2^m) before the search.
+ */
+static int locator_splits(const struct bch_control *bch,
+              struct bch_workspace *ws, const struct gf_poly *f)
+{
+    struct gf_poly *z  = (struct gf_poly *)ws->poly_2t[0];
+    struct gf_poly *tk = (struct gf_poly *)ws->poly_2t[1];
+    return !compute_trace_bk_mod(bch, ws, 1, f, z, tk, 1);
+}
+
+static int use_chien(const struct bch_control *bch, unsigned int deg)
+{
+    switch (bch->root_finder) {
+    case BCH_ROOTS_BTA:   return 0;
+    case BCH_ROOTS_CHIEN: return 1;
+    default:
+        return (deg >= bch->chien_min_deg) && (deg <= bch->chien_max_deg);
+    }
+}
+
+int decode_bch_ws(const struct bch_control *bch, struct bch_workspace *ws,
+          const uint8_t *data, unsigned int len,
+          const uint8_t *recv_ecc, const uint8_t *calc_ecc,
+          const unsigned int *syn, unsigned int *errloc)
 {
     const unsigned int ecc_words = BCH_ECC_WORDS(bch);
-    unsigned int nbits;
+    const unsigned int nbits = (len*8)+GF_ECC_BITS(bch);
     int i, err, nroots;
     uint32_t sum;
-    if (8*len > (bch->n-bch->ecc_bits)) return -EINVAL;
+#ifndef BCH_SPECIALIZED
+    if (bch->kernel == BCH_KERNEL_M13T64)
+        return decode_bch_ws_m13t64(bch, ws, data, len, recv_ecc, calc_ecc,
+                        syn, errloc);
+#endif
+    if (8*len > (GF_N(bch)-GF_ECC_BITS(bch))) return -EINVAL;
+    BCH_TRACE_BEGIN(ws);
     if (!syn) {
         if (!calc_ecc) {
             if (!data || !recv_ecc) return -EINVAL;
-            encode_bch(bch, data, len, NULL);
+            encode_bch_ws(bch, ws, data, len, NULL);
         } else {
-            load_ecc8(bch, bch->ecc_buf, calc_ecc);
+            load_ecc8(bch, ws->ecc_buf, calc_ecc);
         }
         if (recv_ecc) {
-            load_ecc8(bch, bch->ecc_buf2, recv_ecc);
+            load_ecc8(bch, ws->ecc_buf2, recv_ecc);
+            BCH_UNROLL
             for (i = 0, sum = 0; i < (int)ecc_words; i++) {
-                bch->ecc_buf[i] ^= bch->ecc_buf2[i];
-                sum |= bch->ecc_buf[i];
+                ws->ecc_buf[i] ^= ws->ecc_buf2[i];
+                sum |= ws->ecc_buf[i];
             }
+            BCH_TRACE_STAGE(ws, BCH_STAGE_ENCODE);
             if (!sum) return 0;
         }
-        compute_syndromes(bch, bch->ecc_buf, bch->syn);
-        syn = bch->syn;
+        compute_syndromes(bch, ws->ecc_buf, ws->syn);
+        syn = ws->syn;
+        BCH_TRACE_STAGE(ws, BCH_STAGE_SYNDROME);
     }
-    err = compute_error_locator_polynomial(bch, syn);
+    err = compute_error_locator_polynomial(bch, ws, syn, GF_T(bch));
+    BCH_TRACE_STAGE(ws, BCH_STAGE_BM);
+    BCH_TRACE_SET(ws, elp_deg, (err > 0) ? (unsigned int)err : 0);
     if (err > 0) {
-        nroots = find_poly_roots(bch, 1, (struct gf_poly *)bch->elp, errloc);
+        if (use_chien(bch, err)) {
+            if ((bch->reject == BCH_REJECT_EARLY) && (err > 1) &&
+                !locator_splits(bch, ws, (struct gf_poly *)ws->elp))
+                nroots = 0;
+            else
+                nroots = chien_search(bch, ws, (struct gf_poly *)ws->elp,
+                              nbits, errloc);
+        } else
+            nroots = find_poly_roots(bch, ws, 1,
+                         (struct gf_poly *)ws->elp, errloc);
         if (err != nroots) err = -1;
     }
     if (err > 0) {
-        nbits = (len*8)+bch->ecc_bits;
         for (i = 0; i < err; i++) {
             if (errloc[i] >= nbits) {
                 err = -1;
@@ -641,49 +1118,139 @@ int decode_bch(struct bch_control *bch, const uint8_t *data, unsigned int len,
             errloc[i] = (errloc[i] & ~7)|(7-(errloc[i] & 7));
         }
     }
+    BCH_TRACE_STAGE(ws, BCH_STAGE_ROOTS);
     return (err >= 0) ? err : -EBADMSG;
 }
 
-static int build_gf_tables(struct bch_control *bch, unsigned int poly)
+/*
+ * Syndromes are linear in the remainder, so those of data || recv_ecc are
+ * the syndromes of the data's own ecc xor those of recv_ecc: a caller
+ * matching one input against many stored ecc computes each half once and
+ * hands the sum to decode_bch_ws.
+ */
+void bch_ecc_syndromes(const struct bch_control *bch, struct bch_workspace *ws,
+               const uint8_t *ecc, unsigned int *syn)
 {
-    unsigned int i, x = 1;
-    const unsigned int k = 1 << deg(poly);
-    if (k != (1u << GF_M(bch))) return -1;
-    for (i = 0; i < GF_N(bch); i++) {
-        bch->a_pow_tab[i] = x;
-        bch->a_log_tab[x] = i;
-        if (i && (x == 1)) return -1;
-        x <<= 1;
-        if (x & k) x ^= poly;
+#ifndef BCH_SPECIALIZED
+    if (bch->kernel == BCH_KERNEL_M13T64) {
+        bch_ecc_syndromes_m13t64(bch, ws, ecc, syn);
+        return;
     }
-    bch->a_pow_tab[GF_N(bch)] = 1;
+#endif
+    load_ecc8(bch, ws->ecc_buf, ecc);
+    compute_syndromes(bch, ws->ecc_buf, syn);
+}
+
+/*
+ * Error locator degree only. The degree never decreases, so the run stops
+ * as soon as it exceeds max_deg; with max_deg < t the remaining syndromes
+ * act as a check and a random syndrome set passes with probability about
+ * 2^-(m*(t-max_deg)).
+ */
+int bch_locator_degree(const struct bch_control *bch, struct bch_workspace *ws,
+               const unsigned int *syn, unsigned int max_deg)
+{
+#ifndef BCH_SPECIALIZED
+    if (bch->kernel == BCH_KERNEL_M13T64)
+        return bch_locator_degree_m13t64(bch, ws, syn, max_deg);
+#endif
+    if (max_deg > GF_T(bch))
+        max_deg = GF_T(bch);
+    return compute_error_locator_polynomial(bch, ws, syn, max_deg);
+}
+
+#ifndef BCH_SPECIALIZED
+int decode_bch(struct bch_control *bch, const uint8_t *data, unsigned int len,
+           const uint8_t *recv_ecc, const uint8_t *calc_ecc,
+           const unsigned int *syn, unsigned int *errloc)
+{
+    return decode_bch_ws(bch, bch->ws, data, len, recv_ecc, calc_ecc,
+                 syn, errloc);
+}
+
+static int build_gf_tables(struct bch_control *bch, unsigned int poly)
+{
+    if (gf_tab_init(&bch->gf, GF_M(bch), poly)) return -1;
+    /* a_pow_tab[i] == alpha^i for i < 2n */
+    bch->a_pow_tab = bch->gf.exp;
+    memcpy(bch->a_log_tab, bch->gf.log,
+           (1+GF_N(bch))*sizeof(*bch->a_log_tab));
     bch->a_log_tab[0] = 0;
     return 0;
 }
 
 static void build_mod8_tables(struct bch_control *bch, const uint32_t *g)
 {
-    int i, j, b, d;
+    int i, j, d;
     uint32_t data, hi, lo, *tab;
+    unsigned int b;
+    const uint8_t zero = 0;
     const int l = BCH_ECC_WORDS(bch);
     const int plen = DIV_ROUND_UP(bch->ecc_bits+1, 32);
     const int ecclen = DIV_ROUND_UP(bch->ecc_bits, 32);
-    memset(bch->mod8_tab, 0, 4*256*l*sizeof(*bch->mod8_tab));
+    const unsigned int ntabs = (bch->encoder == BCH_ENC_CLMUL) ?
+        1 : bch->slice_bytes;
+    memset(bch->mod8_tab, 0, ntabs*256*l*sizeof(*bch->mod8_tab));
     for (i = 0; i < 256; i++) {
-        for (b = 0; b < 4; b++) {
-            tab = bch->mod8_tab + (b*256+i)*l;
-            data = i << (8*b);
-            while (data) {
-                d = deg(data);
-                data ^= g[0] >> (31-d);
-                for (j = 0; j < ecclen; j++) {
-                    hi = (d < 31) ? g[j] << (d+1) : 0;
-                    lo = (j+1 < plen) ? g[j+1] >> (31-d) : 0;
-                    tab[j] ^= hi|lo;
-                }
+        tab = bch->mod8_tab + i*l;
+        data = i;
+        while (data) {
+            d = deg(data);
+            data ^= g[0] >> (31-d);
+            for (j = 0; j < ecclen; j++) {
+                hi = (d < 31) ? g[j] << (d+1) : 0;
+                lo = (j+1 < plen) ? g[j+1] >> (31-d) : 0;
+                tab[j] ^= hi|lo;
             }
         }
     }
+    /* table b: table b-1 shifted through the register by one zero byte */
+    for (b = 1; b < ntabs; b++) {
+        for (i = 0; i < 256; i++) {
+            tab = bch->mod8_tab + (b*256+i)*l;
+            memcpy(tab, tab-256*l, l*sizeof(*tab));
+            encode_bch_unaligned(bch, &zero, 1, tab);
+        }
+    }
+}
+
+static inline unsigned int genpoly_coef(const uint32_t *g, unsigned int e,
+                    unsigned int k)
+{
+    const unsigned int j = e-k;
+    return (g[j/32] >> (31-j%32)) & 1;
+}
+
+static int build_clmul_tables(struct bch_control *bch, const uint32_t *g)
+{
+    const unsigned int e = bch->ecc_bits;
+    unsigned int i, j, k;
+    uint8_t *rem;
+    uint64_t *tab = bch->clmul_tab;
+
+    rem = kmalloc(e+65, GFP_KERNEL);
+    if (rem == NULL)
+        return -ENOMEM;
+    memset(tab, 0, (1+BCH_CLMUL_WORDS(bch))*sizeof(*tab));
+    /* g without its leading term, left-aligned in 64-bit words */
+    for (k = 0; k < e; k++) {
+        j = e-1-k;
+        if (genpoly_coef(g, e, k))
+            tab[1+j/64] |= 1ull << (63-j%64);
+    }
+    /* mu = x^(e+64) / g, long division; only the low 64 bits are kept */
+    memset(rem, 0, e+65);
+    rem[e+64] = 1;
+    for (i = e+64; i >= e; i--) {
+        if (!rem[i])
+            continue;
+        if (i-e < 64)
+            tab[0] |= 1ull << (i-e);
+        for (k = 0; k <= e; k++)
+            rem[i-e+k] ^= genpoly_coef(g, e, k);
+    }
+    kfree(rem);
+    return 0;
 }
 
 static int build_deg2_base(struct bch_control *bch)
@@ -713,6 +1280,31 @@ static int build_deg2_base(struct bch_control *bch)
     return remaining ? -1 : 0;
 }
 
+static void build_syn_tables(struct bch_control *bch)
+{
+    const unsigned int t = GF_T(bch);
+    const unsigned int stride = BCH_SYN_TAB_STRIDE(bch);
+    const unsigned int hi = stride-512;
+    unsigned int i, j, b, e, c, x;
+    uint16_t *tab;
+    for (j = 0; j < t; j++) {
+        tab = bch->syn_tab+j*stride;
+        e = 2*j+1;
+        for (i = 0; i < 256; i++) {
+            for (b = 0, x = 0; b < 8; b++) {
+                if (i & (1u << b))
+                    x ^= a_pow(bch, e*b);
+            }
+            tab[i] = x;
+        }
+        c = a_pow(bch, 8*e);
+        for (i = 0; i < 256; i++)
+            tab[256+i] = (i <= GF_N(bch)) ? gf_mul(bch, i, c) : 0;
+        for (i = 0; i < hi; i++)
+            tab[512+i] = ((i << 8) <= GF_N(bch)) ? gf_mul(bch, i << 8, c) : 0;
+    }
+}
+
 static void *bch_alloc(size_t size, int *err)
 {
     void *ptr;
@@ -773,48 +1365,162 @@ finish:
     return genpoly;
 }
 
+struct bch_workspace *bch_alloc_workspace(const struct bch_control *bch)
+{
+    const unsigned int t = GF_T(bch);
+    const size_t words = BCH_ECC_WORDS(bch);
+    size_t size;
+    unsigned int i;
+    uint8_t *p;
+    struct bch_workspace *ws;
+    size = sizeof(*ws)+2*words*sizeof(uint32_t)+
+        2*2*t*sizeof(unsigned int)+(t+1)*sizeof(struct gf_poly_deg1)+
+        ARRAY_SIZE(ws->poly_2t)*GF_POLY_SZ(2*t);
+    ws = kzalloc(size, GFP_KERNEL);
+    if (ws == NULL) return NULL;
+    p = (uint8_t *)(ws+1);
+    ws->ecc_buf  = (uint32_t *)p;     p += words*sizeof(uint32_t);
+    ws->ecc_buf2 = (uint32_t *)p;     p += words*sizeof(uint32_t);
+    ws->syn      = (unsigned int *)p; p += 2*t*sizeof(unsigned int);
+    ws->cache    = (int *)p;          p += 2*t*sizeof(int);
+    ws->elp      = (struct bch_elspoly *)p;
+    p += (t+1)*sizeof(struct gf_poly_deg1);
+    for (i = 0; i < ARRAY_SIZE(ws->poly_2t); i++) {
+        ws->poly_2t[i] = (struct bch_elspoly *)p;
+        p += GF_POLY_SZ(2*t);
+    }
+    return ws;
+}
+
+void bch_free_workspace(struct bch_workspace *ws)
+{
+    kfree(ws);
+}
+
 struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
+{
+    return init_bch_cfg(m, t, prim_poly, NULL);
+}
+
+#define BCH_MIN_M   5
+#define BCH_MAX_M   15
+
+/* default primitive polynomial for each m in [BCH_MIN_M, BCH_MAX_M] */
+static const unsigned int prim_poly_tab[] = {
+    0x25, 0x43, 0x83, 0x11d, 0x211, 0x409, 0x805, 0x1053, 0x201b,
+    0x402b, 0x8003,
+};
+
+static unsigned int select_slice(const struct bch_config *cfg)
+{
+    if (!cfg || !cfg->slice_bytes)
+        return BCH_SLICE_DEFAULT;
+    if ((cfg->slice_bytes == 4) || (cfg->slice_bytes == 8) ||
+        (cfg->slice_bytes == 16))
+        return cfg->slice_bytes;
+    return 0;
+}
+
+static int select_encoder(const struct bch_config *cfg, unsigned int ecc_bits)
+{
+#ifdef BCH_HAVE_CLMUL
+    if ((!cfg || cfg->encoder != BCH_ENC_TABLE) && (ecc_bits >= 64) &&
+        cpu_has_clmul())
+        return BCH_ENC_CLMUL;
+#endif
+    return BCH_ENC_TABLE;
+}
+
+/* options that do not change any table (also applied to a loaded image) */
+static void bch_init_options(struct bch_control *bch,
+                 const struct bch_config *cfg)
+{
+    bch->root_finder = cfg ? cfg->root_finder : BCH_ROOTS_AUTO;
+    bch->reject = (cfg && (cfg->reject == BCH_REJECT_FULL)) ?
+        BCH_REJECT_FULL : BCH_REJECT_EARLY;
+    bch->chien_min_deg = (cfg && cfg->chien_max_deg) ?
+        cfg->chien_min_deg : BCH_CHIEN_MIN_DEG;
+    bch->chien_max_deg = (cfg && cfg->chien_max_deg) ?
+        cfg->chien_max_deg : BCH_CHIEN_MAX_DEG;
+    bch->kernel = ((!cfg || (cfg->kernel != BCH_KERNEL_GENERIC)) &&
+               (bch->m == 13) && (bch->t == 64) && (bch->ecc_bits == 832)) ?
+        BCH_KERNEL_M13T64 : BCH_KERNEL_GENERIC;
+}
+
+size_t bch_table_bytes(int m, int t, const struct bch_config *cfg)
+{
+    struct bch_control tmp;
+    size_t size;
+    const unsigned int slice = select_slice(cfg);
+    if ((m < BCH_MIN_M) || (m > BCH_MAX_M) || (t < 1) ||
+        (m*t >= ((1 << m)-1)) || !slice)
+        return 0;
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.m = m;
+    tmp.t = t;
+    tmp.n = (1 << m)-1;
+    tmp.ecc_bits = m*t;    /* upper bound of the generator degree */
+    size = gf_tab_bytes(m)+(1+tmp.n)*sizeof(*tmp.a_log_tab)+
+        m*sizeof(*tmp.xi_tab)+
+        t*BCH_SYN_TAB_STRIDE(&tmp)*sizeof(*tmp.syn_tab);
+    if (select_encoder(cfg, tmp.ecc_bits) == BCH_ENC_CLMUL)
+        size += 256*BCH_ECC_WORDS(&tmp)*sizeof(*tmp.mod8_tab)+
+            (1+BCH_CLMUL_WORDS(&tmp))*sizeof(*tmp.clmul_tab);
+    else
+        size += slice*256*BCH_ECC_WORDS(&tmp)*sizeof(*tmp.mod8_tab);
+    return size;
+}
+
+struct bch_control *init_bch_cfg(int m, int t, unsigned int prim_poly,
+                 const struct bch_config *cfg)
 {
     int err = 0;
-    unsigned int i, words;
+    unsigned int words;
     uint32_t *genpoly;
     struct bch_control *bch = NULL;
-    const int min_m = 5;
-    const int max_m = 15;
-    static const unsigned int prim_poly_tab[] = {
-        0x25, 0x43, 0x83, 0x11d, 0x211, 0x409, 0x805, 0x1053, 0x201b,
-        0x402b, 0x8003,
-    };
-    if ((m < min_m) || (m > max_m)) goto fail;
+    if ((m < BCH_MIN_M) || (m > BCH_MAX_M)) goto fail;
     if ((t < 1) || (m*t >= ((1 << m)-1))) goto fail;
-    if (prim_poly == 0) prim_poly = prim_poly_tab[m-min_m];
+    if (!select_slice(cfg)) goto fail;
+    if (prim_poly == 0) prim_poly = prim_poly_tab[m-BCH_MIN_M];
     bch = kzalloc(sizeof(*bch), GFP_KERNEL);
     if (bch == NULL) goto fail;
     bch->m = m;
     bch->t = t;
     bch->n = (1 << m)-1;
+    bch->slice_bytes = select_slice(cfg);
     words  = DIV_ROUND_UP(m*t, 32);
     bch->ecc_bytes = DIV_ROUND_UP(m*t, 8);
-    bch->a_pow_tab = bch_alloc((1+bch->n)*sizeof(*bch->a_pow_tab), &err);
     bch->a_log_tab = bch_alloc((1+bch->n)*sizeof(*bch->a_log_tab), &err);
-    bch->mod8_tab  = bch_alloc(words*1024*sizeof(*bch->mod8_tab), &err);
-    bch->ecc_buf   = bch_alloc(words*sizeof(*bch->ecc_buf), &err);
-    bch->ecc_buf2  = bch_alloc(words*sizeof(*bch->ecc_buf2), &err);
     bch->xi_tab    = bch_alloc(m*sizeof(*bch->xi_tab), &err);
-    bch->syn       = bch_alloc(2*t*sizeof(*bch->syn), &err);
-    bch->cache     = bch_alloc(2*t*sizeof(*bch->cache), &err);
-    bch->elp       = bch_alloc((t+1)*sizeof(struct gf_poly_deg1), &err);
-    for (i = 0; i < ARRAY_SIZE(bch->poly_2t); i++)
-        bch->poly_2t[i] = bch_alloc(GF_POLY_SZ(2*t), &err);
+    bch->syn_tab   = bch_alloc(t*BCH_SYN_TAB_STRIDE(bch)*sizeof(*bch->syn_tab),
+                   &err);
     if (err) goto fail;
+    bch->ws = bch_alloc_workspace(bch);
+    if (bch->ws == NULL) goto fail;
     err = build_gf_tables(bch, prim_poly);
     if (err) goto fail;
     genpoly = compute_generator_polynomial(bch);
     if (genpoly == NULL) goto fail;
-    build_mod8_tables(bch, genpoly);
+    bch->encoder = select_encoder(cfg, bch->ecc_bits);
+    bch_init_options(bch, cfg);
+    bch->mod8_tab = bch_alloc(((bch->encoder == BCH_ENC_CLMUL) ? 1 :
+                   bch->slice_bytes)*256*words*
+                  sizeof(*bch->mod8_tab), &err);
+    if (!err)
+        build_mod8_tables(bch, genpoly);
+#ifdef BCH_HAVE_CLMUL
+    if (!err && (bch->encoder == BCH_ENC_CLMUL)) {
+        bch->clmul_tab = bch_alloc((1+BCH_CLMUL_WORDS(bch))*
+                       sizeof(*bch->clmul_tab), &err);
+        if (!err)
+            err = build_clmul_tables(bch, genpoly);
+    }
+#endif
     kfree(genpoly);
+    if (err) goto fail;
     err = build_deg2_base(bch);
     if (err) goto fail;
+    build_syn_tables(bch);
     return bch;
 fail:
     free_bch(bch);
@@ -823,19 +1529,238 @@ fail:
 
 void free_bch(struct bch_control *bch)
 {
-    unsigned int i;
     if (bch) {
-        kfree(bch->a_pow_tab);
-        kfree(bch->a_log_tab);
-        kfree(bch->mod8_tab);
-        kfree(bch->ecc_buf);
-        kfree(bch->ecc_buf2);
-        kfree(bch->xi_tab);
-        kfree(bch->syn);
-        kfree(bch->cache);
-        kfree(bch->elp);
-        for (i = 0; i < ARRAY_SIZE(bch->poly_2t); i++)
-            kfree(bch->poly_2t[i]);
+        /* tables inside a caller-owned image are not ours to free */
+        if (!bch->image) {
+            gf_tab_free(&bch->gf);
+            kfree(bch->a_log_tab);
+            kfree(bch->mod8_tab);
+            kfree(bch->xi_tab);
+            kfree(bch->syn_tab);
+            kfree(bch->clmul_tab);
+        }
+        bch_free_workspace(bch->ws);
         kfree(bch);
     }
-}
\ No newline at end of file
+}
+
+/*
+ * Table image: every read-only table of a bch_control in one blob, each
+ * table at a BCH_IMAGE_ALIGN boundary after the header. The layout is
+ * native-endian; an image from a foreign ABI fails the magic or size
+ * checks and the caller falls back to init_bch_cfg.
+ */
+enum {
+    BCH_IMG_GF_LOG, BCH_IMG_GF_EXP, BCH_IMG_A_LOG, BCH_IMG_MOD8,
+    BCH_IMG_XI, BCH_IMG_SYN, BCH_IMG_CLMUL, BCH_IMG_TABS
+};
+
+struct bch_image_hdr {
+    uint32_t        magic;
+    uint32_t        version;
+    uint32_t        m;
+    uint32_t        t;
+    uint32_t        prim_poly;
+    uint32_t        ecc_bits;
+    uint32_t        encoder;
+    uint32_t        slice_bytes;
+    uint64_t        size;           /* whole image, header included */
+    uint64_t        checksum;       /* over everything after the header */
+    uint64_t        off[BCH_IMG_TABS];
+    uint64_t        len[BCH_IMG_TABS];
+};
+
+#define BCH_IMAGE_HDR_BYTES \
+    (DIV_ROUND_UP(sizeof(struct bch_image_hdr), BCH_IMAGE_ALIGN)*BCH_IMAGE_ALIGN)
+
+static void bch_image_lens(const struct bch_control *bch, uint64_t *len)
+{
+    const unsigned int words = BCH_ECC_WORDS(bch);
+    const unsigned int ntabs = (bch->encoder == BCH_ENC_CLMUL) ?
+        1 : bch->slice_bytes;
+    len[BCH_IMG_GF_LOG] = (1+GF_N(bch))*sizeof(*bch->gf.log);
+    len[BCH_IMG_GF_EXP] = GF_TAB_EXP_SIZE(GF_N(bch))*sizeof(*bch->gf.exp);
+    len[BCH_IMG_A_LOG]  = (1+GF_N(bch))*sizeof(*bch->a_log_tab);
+    len[BCH_IMG_MOD8]   = ntabs*256*words*sizeof(*bch->mod8_tab);
+    len[BCH_IMG_XI]     = GF_M(bch)*sizeof(*bch->xi_tab);
+    len[BCH_IMG_SYN]    = GF_T(bch)*BCH_SYN_TAB_STRIDE(bch)*
+        sizeof(*bch->syn_tab);
+    len[BCH_IMG_CLMUL]  = (bch->encoder == BCH_ENC_CLMUL) ?
+        (1+BCH_CLMUL_WORDS(bch))*sizeof(*bch->clmul_tab) : 0;
+}
+
+/* word-wise FNV-1a; the payload is a multiple of BCH_IMAGE_ALIGN bytes */
+static uint64_t bch_image_checksum(const uint8_t *p, uint64_t len)
+{
+    uint64_t h = 0xcbf29ce484222325ull, w;
+    for (; len >= 8; p += 8, len -= 8) {
+        memcpy(&w, p, 8);
+        h = (h^w)*0x100000001b3ull;
+    }
+    return h;
+}
+
+size_t bch_image_size(const struct bch_control *bch)
+{
+    uint64_t len[BCH_IMG_TABS], size = BCH_IMAGE_HDR_BYTES;
+    int i;
+    bch_image_lens(bch, len);
+    for (i = 0; i < BCH_IMG_TABS; i++)
+        size += DIV_ROUND_UP(len[i], BCH_IMAGE_ALIGN)*BCH_IMAGE_ALIGN;
+    return (size_t)size;
+}
+
+size_t bch_image_write(const struct bch_control *bch, void *buf, size_t size)
+{
+    struct bch_image_hdr hdr;
+    uint8_t *out = buf;
+    const void *src[BCH_IMG_TABS];
+    uint64_t pos = BCH_IMAGE_HDR_BYTES;
+    int i;
+    if (!bch || !buf || (size < bch_image_size(bch)))
+        return 0;
+    src[BCH_IMG_GF_LOG] = bch->gf.log;
+    src[BCH_IMG_GF_EXP] = bch->gf.exp;
+    src[BCH_IMG_A_LOG]  = bch->a_log_tab;
+    src[BCH_IMG_MOD8]   = bch->mod8_tab;
+    src[BCH_IMG_XI]     = bch->xi_tab;
+    src[BCH_IMG_SYN]    = bch->syn_tab;
+    src[BCH_IMG_CLMUL]  = bch->clmul_tab;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic = BCH_IMAGE_MAGIC;
+    hdr.version = BCH_IMAGE_VERSION;
+    hdr.m = GF_M(bch);
+    hdr.t = GF_T(bch);
+    /* alpha^m = x^m + prim_poly */
+    hdr.prim_poly = (1u << GF_M(bch))|bch->a_pow_tab[GF_M(bch)];
+    hdr.ecc_bits = bch->ecc_bits;
+    hdr.encoder = bch->encoder;
+    hdr.slice_bytes = bch->slice_bytes;
+    bch_image_lens(bch, hdr.len);
+    memset(out, 0, bch_image_size(bch));
+    for (i = 0; i < BCH_IMG_TABS; i++) {
+        hdr.off[i] = pos;
+        if (hdr.len[i])
+            memcpy(out+pos, src[i], hdr.len[i]);
+        pos += DIV_ROUND_UP(hdr.len[i], BCH_IMAGE_ALIGN)*BCH_IMAGE_ALIGN;
+    }
+    hdr.size = pos;
+    hdr.checksum = bch_image_checksum(out+BCH_IMAGE_HDR_BYTES,
+                      pos-BCH_IMAGE_HDR_BYTES);
+    memcpy(out, &hdr, sizeof(hdr));
+    return (size_t)pos;
+}
+
+/*
+ * Degree of the generator polynomial: the number of distinct roots in the
+ * cyclotomic cosets of 1, 3, ..., 2t-1 (as in compute_generator_polynomial)
+ */
+static uint32_t bch_count_roots(int m, int t)
+{
+    const unsigned int n = (1u << m)-1;
+    unsigned int i, j, r;
+    uint32_t count = 0;
+    uint8_t *roots = kzalloc(n, GFP_KERNEL);
+    if (roots == NULL)
+        return 0;
+    for (i = 0; i < (unsigned int)t; i++) {
+        for (j = 0, r = 2*i+1; j < (unsigned int)m; j++) {
+            count += !roots[r];
+            roots[r] = 1;
+            r = (2*r) % n;
+        }
+    }
+    kfree(roots);
+    return count;
+}
+
+struct bch_control *init_bch_image(const void *image, size_t size, int m,
+                   int t, unsigned int prim_poly,
+                   const struct bch_config *cfg)
+{
+    struct bch_image_hdr hdr;
+    const uint8_t *in = image;
+    uint64_t len[BCH_IMG_TABS], pos;
+    struct bch_control *bch = NULL;
+    int i;
+    if (!image || ((uintptr_t)image % 8) || (size < BCH_IMAGE_HDR_BYTES))
+        goto fail;
+    memcpy(&hdr, in, sizeof(hdr));
+    if ((hdr.magic != BCH_IMAGE_MAGIC) ||
+        (hdr.version != BCH_IMAGE_VERSION) || (hdr.size != size))
+        goto fail;
+    if ((hdr.m != (uint32_t)m) || (hdr.t != (uint32_t)t) ||
+        (m < BCH_MIN_M) || (m > BCH_MAX_M) || (t < 1) ||
+        (m*t >= ((1 << m)-1)))
+        goto fail;
+    if (prim_poly == 0) prim_poly = prim_poly_tab[m-BCH_MIN_M];
+    if (hdr.prim_poly != prim_poly)
+        goto fail;
+    /*
+     * ecc_bits sizes the tables and the encoder choice, and is fixed by
+     * m and t; the checksum only catches accidental damage, so recount it
+     */
+    if ((hdr.ecc_bits == 0) || (hdr.ecc_bits > (uint32_t)(m*t)) ||
+        (hdr.ecc_bits != bch_count_roots(m, t)))
+        goto fail;
+    for (i = sizeof(hdr); i < (int)BCH_IMAGE_HDR_BYTES; i++)
+        if (in[i])
+            goto fail;
+    /* the image only carries the tables of the encoder it was built for */
+    if (!select_slice(cfg) ||
+        (hdr.encoder != (uint32_t)select_encoder(cfg, hdr.ecc_bits)))
+        goto fail;
+    if ((hdr.slice_bytes != 4) && (hdr.slice_bytes != 8) &&
+        (hdr.slice_bytes != 16))
+        goto fail;
+    if ((hdr.encoder == BCH_ENC_TABLE) &&
+        (hdr.slice_bytes != select_slice(cfg)))
+        goto fail;
+    bch = kzalloc(sizeof(*bch), GFP_KERNEL);
+    if (bch == NULL)
+        goto fail;
+    bch->m = m;
+    bch->t = t;
+    bch->n = (1 << m)-1;
+    bch->ecc_bits = hdr.ecc_bits;
+    bch->ecc_bytes = DIV_ROUND_UP(m*t, 8);
+    bch->encoder = hdr.encoder;
+    bch->slice_bytes = hdr.slice_bytes;
+    bch_image_lens(bch, len);
+    /*
+     * offsets are outside the checksum: accept only the layout that
+     * bch_image_write produces, so no table can point at another one
+     */
+    for (i = 0, pos = BCH_IMAGE_HDR_BYTES; i < BCH_IMG_TABS; i++) {
+        if ((hdr.len[i] != len[i]) || (hdr.off[i] != pos))
+            goto fail;
+        pos += DIV_ROUND_UP(len[i], BCH_IMAGE_ALIGN)*BCH_IMAGE_ALIGN;
+    }
+    if (pos != size)
+        goto fail;
+    if (bch_image_checksum(in+BCH_IMAGE_HDR_BYTES,
+                   size-BCH_IMAGE_HDR_BYTES) != hdr.checksum)
+        goto fail;
+    /* tables point into the image, which must outlive the control */
+    bch->image = image;
+    bch->gf.m = m;
+    bch->gf.n = bch->n;
+    bch->gf.log = (uint16_t *)(in+hdr.off[BCH_IMG_GF_LOG]);
+    bch->gf.exp = (uint16_t *)(in+hdr.off[BCH_IMG_GF_EXP]);
+    bch->a_pow_tab = bch->gf.exp;
+    bch->a_log_tab = (uint16_t *)(in+hdr.off[BCH_IMG_A_LOG]);
+    bch->mod8_tab = (uint32_t *)(in+hdr.off[BCH_IMG_MOD8]);
+    bch->xi_tab = (unsigned int *)(in+hdr.off[BCH_IMG_XI]);
+    bch->syn_tab = (uint16_t *)(in+hdr.off[BCH_IMG_SYN]);
+    bch->clmul_tab = len[BCH_IMG_CLMUL] ?
+        (uint64_t *)(in+hdr.off[BCH_IMG_CLMUL]) : NULL;
+    bch_init_options(bch, cfg);
+    bch->ws = bch_alloc_workspace(bch);
+    if (bch->ws == NULL)
+        goto fail;
+    return bch;
+fail:
+    free_bch(bch);
+    return NULL;
+}
+#endif /* !BCH_SPECIALIZED */
@@ -2,6 +2,7 @@
 #define _BCH_H
 
 #include "win_compat.h"
+#include "gf.h"
 #include <stdint.h>
 
 struct bch_elspoly {
@@ -13,26 +14,166 @@ struct bch_elspoly {
     unsigned int   *poly;
 };
 
+/* 오류 위치 다항식 근 찾기 방식 */
+#define BCH_ROOTS_AUTO      0   /* 차수별로 BTA / Chien 자동 선택 */
+#define BCH_ROOTS_BTA       1   /* Berlekamp trace 인수분해 (커널 기본) */
+#define BCH_ROOTS_CHIEN     2   /* 단축 코드 유효 위치만 Chien search */
+
+/*
+ * AUTO 모드에서 Chien을 쓰는 차수 구간. fe_system roots 측정에서 BTA가
+ * 모든 차수(1..64)에서 더 빨라 기본 구간은 비어 있음 (min > max).
+ */
+#define BCH_CHIEN_MIN_DEG   1
+#define BCH_CHIEN_MAX_DEG   0
+
+/*
+ * 복호 실패(오류 > t) 판정 방식. EARLY는 근 찾기 전에 x^(2^m) = x mod sigma
+ * (sigma가 서로 다른 근으로 완전히 분해되는지) 를 확인해 분해되지 않으면
+ * 바로 실패로 끝냄. BTA는 첫 trace 계산의 제곱 사슬을 한 번 더 이어 검사하므로
+ * 성공 경로 비용이 거의 늘지 않음. Chien은 남은 위치로 차수를 채울 수 없으면 중단.
+ */
+#define BCH_REJECT_EARLY    0   /* 기본 */
+#define BCH_REJECT_FULL     1   /* 근 찾기를 끝까지 수행 (비교 측정용) */
+
+/* 인코더 (생성 다항식 나머지 계산) 방식 */
+#define BCH_ENC_AUTO        0   /* CPU가 지원하면 CLMUL, 아니면 테이블 */
+#define BCH_ENC_TABLE       1   /* mod8_tab slicing-by-N (커널 기본 N = 4) */
+#define BCH_ENC_CLMUL       2   /* PCLMULQDQ Barrett 축약 (x86-64) */
+
+/* 테이블 인코더가 한 번에 처리하는 바이트 수 (4, 8, 16) */
+#define BCH_SLICE_DEFAULT   4
+
+/*
+ * encode/decode 커널. m=13, t=64(ecc 832비트)는 필드 크기와 ECC 워드 수를
+ * 상수로 고정해 다시 컴파일한 경로(bch_m13t64.c)를 쓰고, 나머지는 범용 경로.
+ */
+#define BCH_KERNEL_AUTO     0   /* 파라미터가 맞으면 특화 커널 */
+#define BCH_KERNEL_GENERIC  1   /* 항상 범용 경로 (비교 측정용) */
+#define BCH_KERNEL_M13T64   2   /* bch_control.kernel 전용: 특화 커널 사용 중 */
+
+/* init_bch_cfg 옵션 (0으로 채우면 기본값) */
+struct bch_config {
+    int             root_finder;
+    int             encoder;        /* CLMUL 미지원 CPU에서는 TABLE로 대체 */
+    unsigned int    slice_bytes;    /* 0이면 BCH_SLICE_DEFAULT */
+    unsigned int    chien_min_deg;  /* chien_max_deg == 0이면 기본 구간 */
+    unsigned int    chien_max_deg;
+    int             kernel;         /* BCH_KERNEL_AUTO / GENERIC */
+    int             reject;         /* BCH_REJECT_EARLY / FULL */
+};
+
+#ifdef BCH_STATS
+/* decode_bch_ws 단계별 계측 (BCH_STATS 빌드 전용, 호출마다 덮어씀) */
+#define BCH_STAGE_ENCODE    0   /* 재인코딩 + 수신 ECC xor */
+#define BCH_STAGE_SYNDROME  1
+#define BCH_STAGE_BM        2   /* 오류 위치 다항식 (Berlekamp-Massey) */
+#define BCH_STAGE_ROOTS     3   /* 근 찾기 + errloc 변환 */
+#define BCH_STAGE_MAX       4
+
+struct bch_trace {
+    uint64_t        cycles[BCH_STAGE_MAX];
+    uint64_t        last;           /* 직전 단계 종료 시각 */
+    unsigned int    elp_deg;        /* 오류 위치 다항식 차수 (0: 오류 없음) */
+    unsigned int    depth;          /* BTA 인수분해 최대 재귀 깊이 (k) */
+};
+
+/* 라이브러리 내부 계측 매크로 (bch.c / bch_bs64.c 공용) */
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+static inline uint64_t bch_cycles(void) { return __rdtsc(); }
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+static inline uint64_t bch_cycles(void) { return __rdtsc(); }
+#else
+#include <time.h>
+static inline uint64_t bch_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec*1000000000ull+(uint64_t)ts.tv_nsec;
+}
+#endif
+#define BCH_TRACE_BEGIN(_ws) \
+    do { memset(&(_ws)->trace, 0, sizeof((_ws)->trace)); \
+         (_ws)->trace.last = bch_cycles(); } while (0)
+#define BCH_TRACE_STAGE(_ws, _s) \
+    do { uint64_t _now = bch_cycles(); \
+         (_ws)->trace.cycles[_s] += _now-(_ws)->trace.last; \
+         (_ws)->trace.last = _now; } while (0)
+#define BCH_TRACE_SET(_ws, _f, _v) ((_ws)->trace._f = (_v))
+#define BCH_TRACE_MAX(_ws, _f, _v) \
+    do { if ((_v) > (_ws)->trace._f) (_ws)->trace._f = (_v); } while (0)
+#else
+#define BCH_TRACE_BEGIN(_ws)            do { } while (0)
+#define BCH_TRACE_STAGE(_ws, _s)        do { } while (0)
+#define BCH_TRACE_SET(_ws, _f, _v)      do { } while (0)
+#define BCH_TRACE_MAX(_ws, _f, _v)      do { } while (0)
+#endif
+
+/* 호출 단위 가변 작업 공간 (스레드마다 하나씩) */
+struct bch_workspace {
+    uint32_t       *ecc_buf;
+    uint32_t       *ecc_buf2;
+    unsigned int   *syn;
+    int            *cache;
+    struct bch_elspoly *elp;
+    struct bch_elspoly *poly_2t[4];
+#ifdef BCH_STATS
+    struct bch_trace trace;
+#endif
+};
+
+/* 초기화 이후 읽기 전용 (여러 스레드가 공유 가능) */
 struct bch_control {
     unsigned int    m;
     unsigned int    n;
     unsigned int    t;
     unsigned int    ecc_bits;
     unsigned int    ecc_bytes;
-    uint32_t       *a_pow_tab;
-    uint32_t       *a_log_tab;
-    uint32_t       *mod8_tab;
-    uint32_t       *ecc_buf;
-    uint32_t       *ecc_buf2;
+    struct gf_tab   gf;         /* uint16 로그/지수 (0 표시값, gf.h) */
+    const uint16_t *a_pow_tab;  /* = gf.exp, i < 2n: alpha^i */
+    uint16_t       *a_log_tab;  /* gf.log과 같되 a_log_tab[0] = 0 */
+    uint32_t       *mod8_tab;   /* slice_bytes개의 256항목 테이블 (CLMUL은 1개) */
     unsigned int   *xi_tab;
-    unsigned int   *syn;
-    int            *cache;
-    struct bch_elspoly *elp;
-    struct bch_elspoly *poly_2t[4];
+    uint16_t       *syn_tab;    /* 홀수 신드롬별 바이트 단위 Horner 테이블 */
+    uint64_t       *clmul_tab;  /* [0]: mu 하위 64비트, [1..]: g 하위항 (좌정렬) */
+    int             encoder;    /* 실제 선택된 인코더 (BCH_ENC_TABLE/CLMUL) */
+    unsigned int    slice_bytes;
+    int             kernel;     /* 실제 선택된 커널 (BCH_KERNEL_GENERIC/M13T64) */
+    int             root_finder;
+    unsigned int    chien_min_deg;
+    unsigned int    chien_max_deg;
+    int             reject;
+    const void     *image;      /* 테이블이 가리키는 외부 이미지 (NULL = 직접 할당) */
+    struct bch_workspace *ws;   /* encode_bch/decode_bch 전용 (비재진입) */
 };
 
 struct bch_control *init_bch(int m, int t, unsigned int prim_poly);
+struct bch_control *init_bch_cfg(int m, int t, unsigned int prim_poly,
+                 const struct bch_config *cfg);
 void free_bch(struct bch_control *bch);
+
+/*
+ * 테이블 이미지: 읽기 전용 테이블 전체를 버전 / 파라미터 / 체크섬 헤더가 붙은
+ * 연속 바이너리 하나로 직렬화 (파일로 저장해 여러 프로세스가 mmap으로 공유)
+ * - bch_image_size  : 이미지 크기 (바이트)
+ * - bch_image_write : buf에 이미지 기록, 기록한 크기 반환 (0 = 실패)
+ * - init_bch_image  : 이미지 안의 테이블을 복사 없이 가리키는 bch_control.
+ *   헤더 / 파라미터 / 인코더 / 체크섬이 맞지 않으면 NULL (호출자는 init_bch_cfg로 대체).
+ *   image는 8바이트 정렬, free_bch 이후까지 유지되어야 함 (읽기 전용 매핑 가능).
+ *   헤더 값과 테이블 배치는 모두 검사하지만 테이블 내용은 체크섬(FNV, 우발적 손상
+ *   검출용)만 확인하므로, 이미지 파일은 신뢰하는 사용자만 쓸 수 있는 곳에 둘 것
+ */
+#define BCH_IMAGE_MAGIC     0x54484342u     /* "BCHT" (리틀 엔디언 기준) */
+#define BCH_IMAGE_VERSION   1
+#define BCH_IMAGE_ALIGN     64
+
+size_t bch_image_size(const struct bch_control *bch);
+size_t bch_image_write(const struct bch_control *bch, void *buf, size_t size);
+struct bch_control *init_bch_image(const void *image, size_t size, int m,
+                   int t, unsigned int prim_poly,
+                   const struct bch_config *cfg);
+size_t bch_table_bytes(int m, int t, const struct bch_config *cfg);
 void encode_bch(struct bch_control *bch, const uint8_t *data,
         unsigned int len, uint8_t *ecc);
 int decode_bch(struct bch_control *bch, const uint8_t *data,
@@ -40,4 +181,102 @@ int decode_bch(struct bch_control *bch, const uint8_t *data,
         const uint8_t *calc_ecc, const unsigned int *syn,
         unsigned int *errloc);
 
+struct bch_workspace *bch_alloc_workspace(const struct bch_control *bch);
+void bch_free_workspace(struct bch_workspace *ws);
+void encode_bch_ws(const struct bch_control *bch, struct bch_workspace *ws,
+           const uint8_t *data, unsigned int len, uint8_t *ecc);
+int decode_bch_ws(const struct bch_control *bch, struct bch_workspace *ws,
+          const uint8_t *data, unsigned int len,
+          const uint8_t *recv_ecc, const uint8_t *calc_ecc,
+          const unsigned int *syn, unsigned int *errloc);
+/* 데이터와 무관한 시간의 인코딩 (상수 시간 디코더용): CLMUL이면 앞을 0으로
+ * 채워 64비트 워드 단위로만, 아니면 바이트 테이블의 단일 비트 행을 마스크로 합산 */
+void encode_bch_ct(const struct bch_control *bch, const uint8_t *data,
+           unsigned int len, uint8_t *ecc);
+
+/*
+ * 1:N 매칭용 분해 단계
+ * - bch_ecc_syndromes : ecc 크기 나머지의 신드롬 syn[j] = S(j+1), j < 2t.
+ *   신드롬은 나머지에 대해 선형이므로 (data || recv_ecc)의 신드롬은
+ *   encode(data)의 신드롬 xor recv_ecc의 신드롬 (decode_bch_ws의 syn으로 전달)
+ * - bch_locator_degree: 오류 위치 다항식 차수만 계산, max_deg를 넘으면 즉시 -1
+ */
+void bch_ecc_syndromes(const struct bch_control *bch, struct bch_workspace *ws,
+               const uint8_t *ecc, unsigned int *syn);
+int bch_locator_degree(const struct bch_control *bch, struct bch_workspace *ws,
+               const unsigned int *syn, unsigned int max_deg);
+
+/* m=13, t=64 특화 커널 (kernel == BCH_KERNEL_M13T64일 때 위 함수가 호출) */
+void encode_bch_ws_m13t64(const struct bch_control *bch,
+              struct bch_workspace *ws, const uint8_t *data,
+              unsigned int len, uint8_t *ecc);
+int decode_bch_ws_m13t64(const struct bch_control *bch,
+             struct bch_workspace *ws, const uint8_t *data,
+             unsigned int len, const uint8_t *recv_ecc,
+             const uint8_t *calc_ecc, const unsigned int *syn,
+             unsigned int *errloc);
+void bch_ecc_syndromes_m13t64(const struct bch_control *bch,
+                  struct bch_workspace *ws, const uint8_t *ecc,
+                  unsigned int *syn);
+int bch_locator_degree_m13t64(const struct bch_control *bch,
+                  struct bch_workspace *ws, const unsigned int *syn,
+                  unsigned int max_deg);
+
+/*
+ * bitsliced 64블록 디코더 (bch_bs64.c, m=13 / t=64 / 원시 다항식 0x201b 전용)
+ * 블록 64개를 비트 평면으로 전치해 신드롬 / BM / Chien을 AND/XOR만으로 함께 처리.
+ * 에러 수와 데이터에 관계없이 작업량이 같음 (배치 백엔드).
+ * - bch_bs64   : 읽기 전용 설정 (len 고정, 여러 스레드가 공유 가능)
+ * - bch_bs64_ws: 호출 단위 작업 공간 (스레드마다 하나씩)
+ * width: Chien을 나란히 돌리는 위치 구간 수 (0 = CPU별 자동, 1 / 4(AVX2) / 8(AVX-512))
+ */
+#define BCH_BS64_LANES      64
+
+struct bch_bs64;
+struct bch_bs64_ws;
+
+struct bch_bs64 *bch_bs64_create(const struct bch_control *bch,
+                 unsigned int len, unsigned int width);
+void bch_bs64_free(struct bch_bs64 *bs);
+unsigned int bch_bs64_width(const struct bch_bs64 *bs);
+struct bch_bs64_ws *bch_bs64_alloc_workspace(const struct bch_bs64 *bs);
+void bch_bs64_free_workspace(struct bch_bs64_ws *ws);
+/*
+ * 블록 k (k < nblk <= 64): data + k*data_stride, recv_ecc + k*ecc_stride.
+ * corr + k*len에 정정된 데이터 (입력은 수정하지 않음),
+ * nerr[k]에 정정한 비트 수 또는 -EBADMSG. 반환: 성공 블록 수 / -EINVAL
+ */
+int decode_bch_bs64(const struct bch_bs64 *bs, struct bch_bs64_ws *ws,
+            unsigned int nblk, const uint8_t *data, size_t data_stride,
+            const uint8_t *recv_ecc, size_t ecc_stride, uint8_t *corr,
+            int *nerr);
+
+/*
+ * 단일 블록 상수 시간 디코더 (bch_bs64.c, bitsliced 디코더와 같은 코드 조건)
+ * 한 블록의 수행 시간이 오류 수와 데이터에 관계없이 같도록 모든 단계를 고정 비용으로:
+ * - 인코딩: encode_bch_ct, 신드롬: ECC 비트별 신드롬 행을 마스크로 합산 (분기 / 비밀 인덱스 없음)
+ * - BM: 항상 t 라운드, 갱신 여부는 마스크 선택, GF 곱은 시프트-xor (AVX2 / AVX-512 16비트 lane)
+ * - 근 찾기: 유효 위치 전체 Chien, 블록 하나의 위치를 bitsliced 레인 64 * width개에 나눠 실음
+ * bch는 create 이후에도 유지되어야 함 (인코더 테이블 공유)
+ */
+struct bch_ct;
+struct bch_ct_ws;
+
+struct bch_ct *bch_ct_create(const struct bch_control *bch, unsigned int len,
+                 unsigned int width);
+void bch_ct_free(struct bch_ct *ct);
+unsigned int bch_ct_width(const struct bch_ct *ct);
+struct bch_ct_ws *bch_ct_alloc_workspace(const struct bch_ct *ct);
+void bch_ct_free_workspace(struct bch_ct_ws *ws);
+/*
+ * errvec[len]: 데이터 영역 오류 벡터 (정정 = data ^ errvec), 실패해도 같은 시간에 채움.
+ * 반환: 정정한 비트 수 (ECC 영역 포함) 또는 -EBADMSG / -EINVAL
+ */
+int decode_bch_ct(const struct bch_ct *ct, struct bch_ct_ws *ws,
+          const uint8_t *data, const uint8_t *recv_ecc, uint8_t *errvec);
+#ifdef BCH_STATS
+/* 직전 decode_bch_ct 단계별 계측 (ws 소유) */
+const struct bch_trace *bch_ct_trace(const struct bch_ct_ws *ws);
+#endif
+
 #endif /* _BCH_H */
\ No newline at end of file
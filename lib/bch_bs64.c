@@ -0,0 +1,1095 @@
+/*
+ * Bitsliced decoder for the m = 13, t = 64 code. Up to 64 independent
+ * blocks are transposed into bit planes (bit k of every word belongs to
+ * block k) and decoded together with word-wide AND/XOR only:
+ *
+ *   1. syndromes: Horner over the received planes, multiplying by the
+ *      constants alpha^(2k-1) as unrolled XOR networks
+ *   2. error locator: inversionless Berlekamp-Massey, always t rounds,
+ *      the per-block update decision becomes a lane mask
+ *   3. roots: Chien search over the valid positions; the step constants
+ *      alpha^-k are folded into straight-line XOR networks, and the
+ *      positions are cut into W ranges that run side by side in SIMD
+ *      registers (W = 8 with AVX-512, 4 with AVX2, else 1)
+ *
+ * Roots found are XORed back into the planes and transposed out, so the
+ * amount of work does not depend on the data or on the error count.
+ *
+ * The same Chien kernels also back a single-block constant-time decoder
+ * (bch_ct, at the end of this file).
+ */
+#include "bch.h"
+#include <errno.h>
+
+#define BS_M                   GF13_M
+#define BS_T                   64
+#define BS_N                   GF13_N
+#define BS_SYN_PLANES          (BS_T*BS_M)     /* S1, S3, .., S127 */
+#define BS_POLY_PLANES         ((BS_T+1)*BS_M)
+
+#ifndef DIV_ROUND_UP
+#define DIV_ROUND_UP(n,d) (((n) + (d) - 1) / (d))
+#endif
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BS_HAVE_VEC
+typedef uint64_t bs_v4 __attribute__((vector_size(32)));
+typedef uint64_t bs_v8 __attribute__((vector_size(64)));
+#define BS_TARGET_AVX2         __attribute__((target("avx2")))
+#define BS_TARGET_AVX512       __attribute__((target("avx512f")))
+#define BS_TARGET_AVX512BW     __attribute__((target("avx512f,avx512bw")))
+#endif
+
+struct bch_bs64 {
+    unsigned int    len;        /* data bytes per block */
+    unsigned int    nbits;      /* 8*len+832 */
+    unsigned int    groups;     /* 64-bit plane groups, DIV_ROUND_UP(nbits, 64) */
+    unsigned int    width;      /* Chien ranges per step */
+    const uint16_t *a_pow_tab;  /* shared with bch_control */
+};
+
+struct bch_bs64_ws {
+    uint64_t       *plane;      /* [64*groups] stream order, then error planes */
+    uint64_t       *syn;        /* [(2t+1)*m], S_i at i*m */
+    uint64_t       *lam;        /* [(t+1)*m] x4: lam, lam2, b, b2 */
+    uint64_t       *chien;      /* [(t+1)*m*width] registers, 64-byte aligned */
+    uint64_t       *acc;        /* BS_TILE_BYTES, 64-byte aligned */
+    uint64_t       *z;          /* [steps*width] planes in, roots out */
+    void           *chien_mem;  /* chien, acc and z */
+    unsigned int    steps;
+    unsigned int    L[BCH_BS64_LANES];
+};
+
+/* alpha^e for e = -64..139: constant multipliers of the unrolled kernels */
+static const uint16_t bs_apow[204] = {
+    0x120a, 0x040f, 0x081e, 0x103c, 0x0063, 0x00c6, 0x018c, 0x0318,
+    0x0630, 0x0c60, 0x18c0, 0x119b, 0x032d, 0x065a, 0x0cb4, 0x1968,
+    0x12cb, 0x058d, 0x0b1a, 0x1634, 0x0c73, 0x18e6, 0x11d7, 0x03b5,
+    0x076a, 0x0ed4, 0x1da8, 0x1b4b, 0x168d, 0x0d01, 0x1a02, 0x141f,
+    0x0825, 0x104a, 0x008f, 0x011e, 0x023c, 0x0478, 0x08f0, 0x11e0,
+    0x03db, 0x07b6, 0x0f6c, 0x1ed8, 0x1dab, 0x1b4d, 0x1681, 0x0d19,
+    0x1a32, 0x147f, 0x08e5, 0x11ca, 0x038f, 0x071e, 0x0e3c, 0x1c78,
+    0x18eb, 0x11cd, 0x0381, 0x0702, 0x0e04, 0x1c08, 0x180b, 0x100d,
+    0x0001, 0x0002, 0x0004, 0x0008, 0x0010, 0x0020, 0x0040, 0x0080,
+    0x0100, 0x0200, 0x0400, 0x0800, 0x1000, 0x001b, 0x0036, 0x006c,
+    0x00d8, 0x01b0, 0x0360, 0x06c0, 0x0d80, 0x1b00, 0x161b, 0x0c2d,
+    0x185a, 0x10af, 0x0145, 0x028a, 0x0514, 0x0a28, 0x1450, 0x08bb,
+    0x1176, 0x02f7, 0x05ee, 0x0bdc, 0x17b8, 0x0f6b, 0x1ed6, 0x1db7,
+    0x1b75, 0x16f1, 0x0df9, 0x1bf2, 0x17ff, 0x0fe5, 0x1fca, 0x1f8f,
+    0x1f05, 0x1e11, 0x1c39, 0x1869, 0x10c9, 0x0189, 0x0312, 0x0624,
+    0x0c48, 0x1890, 0x113b, 0x026d, 0x04da, 0x09b4, 0x1368, 0x06cb,
+    0x0d96, 0x1b2c, 0x1643, 0x0c9d, 0x193a, 0x126f, 0x04c5, 0x098a,
+    0x1314, 0x0633, 0x0c66, 0x18cc, 0x1183, 0x031d, 0x063a, 0x0c74,
+    0x18e8, 0x11cb, 0x038d, 0x071a, 0x0e34, 0x1c68, 0x18cb, 0x118d,
+    0x0301, 0x0602, 0x0c04, 0x1808, 0x100b, 0x000d, 0x001a, 0x0034,
+    0x0068, 0x00d0, 0x01a0, 0x0340, 0x0680, 0x0d00, 0x1a00, 0x141b,
+    0x082d, 0x105a, 0x00af, 0x015e, 0x02bc, 0x0578, 0x0af0, 0x15e0,
+    0x0bdb, 0x17b6, 0x0f77, 0x1eee, 0x1dc7, 0x1b95, 0x1731, 0x0e79,
+    0x1cf2, 0x19ff, 0x13e5, 0x07d1, 0x0fa2, 0x1f44, 0x1e93, 0x1d3d,
+    0x1a61, 0x14d9, 0x09a9, 0x1352, 0x06bf, 0x0d7e, 0x1afc, 0x15e3,
+    0x0bdd, 0x17ba, 0x0f6f, 0x1ede,
+};
+
+static inline unsigned int bs_weight64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_popcountll(x);
+#else
+    x = x-((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull)+((x >> 2) & 0x3333333333333333ull);
+    x = (x+(x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (unsigned int)((x*0x0101010101010101ull) >> 56);
+#endif
+}
+
+/* 8 stream bytes from byte pos, big-endian; stream = data || ecc, then 0 */
+static inline uint64_t bs_load_row(const uint8_t *data, const uint8_t *ecc,
+                   unsigned int len, unsigned int nbytes,
+                   unsigned int pos)
+{
+    const uint8_t *p = NULL;
+    uint64_t v = 0;
+    unsigned int i, q;
+
+    if (pos+8 <= len)
+        p = data+pos;
+    else if ((pos >= len) && (pos+8 <= nbytes))
+        p = ecc+pos-len;
+    for (i = 0; i < 8; i++) {
+        q = pos+i;
+        v = (v << 8)|(p ? p[i] : (q < len) ? data[q] :
+                  (q < nbytes) ? ecc[q-len] : 0);
+    }
+    return v;
+}
+
+/*
+ * In-place 64x64 bit matrix transpose, bit 63-c of a[r] being element
+ * (r, c). Rows are loaded lane-reversed so that after the transpose bit k
+ * of plane b belongs to block k; the same call turns planes back into
+ * lane-reversed rows.
+ */
+static void bs_transpose64(uint64_t *a)
+{
+    uint64_t m = 0x00000000ffffffffull, t;
+    unsigned int j, k;
+
+    for (j = 32; j; j >>= 1, m ^= m << j) {
+        for (k = 0; k < 64; k = (k+j+1) & ~j) {
+            t = (a[k]^(a[k+j] >> j)) & m;
+            a[k] ^= t;
+            a[k+j] ^= t << j;
+        }
+    }
+}
+
+/* r = a*c for a constant field element c (all lanes) */
+static void bs_mul_const(uint64_t *r, const uint64_t *a, unsigned int c)
+{
+    uint64_t cm[BS_M];
+    int i;
+
+    for (i = 0; i < BS_M; i++)
+        cm[i] = 0-(uint64_t)((c >> i) & 1);
+    gf13_bs64_mul(r, a, cm);
+}
+
+/*
+ * Unrolled kernels. Every register is multiplied by a constant alpha^e
+ * once per step; column b of that multiplier is bs_apow[64+e+b], so each
+ * product becomes a fixed XOR network once the compiler has folded the
+ * table reads. Lane w of a vector register walks its own range of
+ * positions.
+ *
+ * Syndromes: Horner over the range, S <- S*alpha^(2k-1)+r_p, register k
+ * held in machine registers for the whole walk.
+ * Chien: register k steps by alpha^-k from one position to the next. The
+ * positions are walked in tiles: one register at a time is kept in
+ * machine registers across the tile and added into per-position sums
+ * that stay in L1.
+ */
+#define BS_TILE_BYTES          (24*1024)
+
+#define BS_SYN_COL(_k, _b)     bs_apow[64+2*(_k)-1+(_b)]
+#define BS_CHIEN_COL(_k, _b)   bs_apow[64-(_k)+(_b)]
+#define BS_TERM(_col, _k, _b, _c)                                       \
+    (((_col(_k, _b) >> (_c)) & 1) ? x_[_b] : z_)
+#define BS_ROW(_col, _k, _c)                                            \
+    (BS_TERM(_col, _k, 0, _c)^BS_TERM(_col, _k, 1, _c)^                 \
+     BS_TERM(_col, _k, 2, _c)^BS_TERM(_col, _k, 3, _c)^                 \
+     BS_TERM(_col, _k, 4, _c)^BS_TERM(_col, _k, 5, _c)^                 \
+     BS_TERM(_col, _k, 6, _c)^BS_TERM(_col, _k, 7, _c)^                 \
+     BS_TERM(_col, _k, 8, _c)^BS_TERM(_col, _k, 9, _c)^                 \
+     BS_TERM(_col, _k, 10, _c)^BS_TERM(_col, _k, 11, _c)^               \
+     BS_TERM(_col, _k, 12, _c))
+#define BS_MULC(_col, _k)                                               \
+    y_[0] = BS_ROW(_col, _k, 0);   y_[1] = BS_ROW(_col, _k, 1);         \
+    y_[2] = BS_ROW(_col, _k, 2);   y_[3] = BS_ROW(_col, _k, 3);         \
+    y_[4] = BS_ROW(_col, _k, 4);   y_[5] = BS_ROW(_col, _k, 5);         \
+    y_[6] = BS_ROW(_col, _k, 6);   y_[7] = BS_ROW(_col, _k, 7);         \
+    y_[8] = BS_ROW(_col, _k, 8);   y_[9] = BS_ROW(_col, _k, 9);         \
+    y_[10] = BS_ROW(_col, _k, 10); y_[11] = BS_ROW(_col, _k, 11);       \
+    y_[12] = BS_ROW(_col, _k, 12)
+#define BS_EACH(_op)                                                    \
+    _op(0);  _op(1);  _op(2);  _op(3);  _op(4);  _op(5);  _op(6);       \
+    _op(7);  _op(8);  _op(9);  _op(10); _op(11); _op(12)
+#define BS_ZERO(_c)            x_[_c] = z_
+#define BS_COPY(_c)            x_[_c] = y_[_c]
+#define BS_LOAD(_c)            x_[_c] = r_[BS_M*k_+(_c)]
+#define BS_SAVE(_c)            r_[BS_M*k_+(_c)] = x_[_c]
+#define BS_NEXT(_c)            x_[_c] = y_[_c]; a_[_c] ^= y_[_c]
+#define BS_SYN_REG(_k)                                                  \
+    do {                                                                \
+        k_ = (_k)-1;                                                    \
+        BS_EACH(BS_ZERO);                                               \
+        for (st_ = steps; st_-- > 0;) {                                 \
+            BS_MULC(BS_SYN_COL, _k);                                    \
+            BS_EACH(BS_COPY);                                           \
+            x_[0] ^= p_[st_];                                           \
+        }                                                               \
+        BS_EACH(BS_SAVE);                                               \
+    } while (0)
+#define BS_CHIEN_REG(_k)                                                \
+    do {                                                                \
+        k_ = (_k);                                                      \
+        BS_EACH(BS_LOAD);                                               \
+        for (st_ = 0, a_ = acc_; st_ < n_; st_++, a_ += BS_M) {         \
+            BS_MULC(BS_CHIEN_COL, _k);                                  \
+            BS_EACH(BS_NEXT);                                           \
+        }                                                               \
+        BS_EACH(BS_SAVE);                                               \
+    } while (0)
+#define BS_REG8(_reg, _k)                                               \
+    _reg(_k);     _reg((_k)+1); _reg((_k)+2); _reg((_k)+3);             \
+    _reg((_k)+4); _reg((_k)+5); _reg((_k)+6); _reg((_k)+7)
+#define BS_REG64(_reg)                                                  \
+    BS_REG8(_reg, 1);  BS_REG8(_reg, 9);  BS_REG8(_reg, 17);            \
+    BS_REG8(_reg, 25); BS_REG8(_reg, 33); BS_REG8(_reg, 41);            \
+    BS_REG8(_reg, 49); BS_REG8(_reg, 57)
+
+/* p: [steps] received planes, last step first; r: [t][m] partial S_(2k-1) */
+#define BS_SYN_FN(_name, _type, _attr)                                  \
+_attr static void _name(uint64_t *rbuf, const uint64_t *pbuf,           \
+            unsigned int steps)                                 \
+{                                                                       \
+    _type *r_ = (_type *)rbuf, x_[BS_M], y_[BS_M], z_ = {0};            \
+    const _type *p_ = (const _type *)pbuf;                              \
+    unsigned int st_, k_;                                               \
+                                                                        \
+    BS_REG64(BS_SYN_REG);                                               \
+}
+
+/* r: [t+1][m] registers (k = 0: lam_0), acc: one tile of sums, z: [steps] */
+#define BS_CHIEN_FN(_name, _type, _attr)                                \
+_attr static void _name(uint64_t *rbuf, uint64_t *abuf, uint64_t *zbuf, \
+            unsigned int steps)                                 \
+{                                                                       \
+    const unsigned int tile_ = BS_TILE_BYTES/(BS_M*sizeof(_type));      \
+    _type *r_ = (_type *)rbuf, *acc_ = (_type *)abuf;                   \
+    _type *zo_ = (_type *)zbuf, *a_, x_[BS_M], y_[BS_M], z_ = {0};      \
+    unsigned int s0_, n_, st_, c_, k_;                                  \
+                                                                        \
+    for (s0_ = 0; s0_ < steps; s0_ += tile_, zo_ += tile_) {            \
+        n_ = (steps-s0_ < tile_) ? steps-s0_ : tile_;                   \
+        for (st_ = 0; st_ < n_; st_++)                                  \
+            for (c_ = 0; c_ < BS_M; c_++)                               \
+                acc_[st_*BS_M+c_] = r_[c_];                             \
+        BS_REG64(BS_CHIEN_REG);                                         \
+        for (st_ = 0, a_ = acc_; st_ < n_; st_++, a_ += BS_M) {         \
+            y_[0] = a_[0];                                              \
+            for (c_ = 1; c_ < BS_M; c_++)                               \
+                y_[0] |= a_[c_];                                        \
+            zo_[st_] = ~y_[0];                                          \
+        }                                                               \
+    }                                                                   \
+}
+
+BS_SYN_FN(bs_syn_w1, uint64_t, )
+BS_CHIEN_FN(bs_chien_w1, uint64_t, )
+#ifdef BS_HAVE_VEC
+BS_SYN_FN(bs_syn_w4, bs_v4, BS_TARGET_AVX2)
+BS_SYN_FN(bs_syn_w8, bs_v8, BS_TARGET_AVX512)
+BS_CHIEN_FN(bs_chien_w4, bs_v4, BS_TARGET_AVX2)
+BS_CHIEN_FN(bs_chien_w8, bs_v8, BS_TARGET_AVX512)
+#endif
+
+/* alpha^e, e reduced mod n (may be negative) */
+static unsigned int bs_apow_mod(const struct bch_bs64 *bs, int64_t e)
+{
+    e %= BS_N;
+    if (e < 0)
+        e += BS_N;
+    return bs->a_pow_tab[e];
+}
+
+/*
+ * S_j = sum_p r_p*alpha^(jp), p = nbits-1-s for stream bit s. Range w
+ * covers positions [w*steps, (w+1)*steps) and yields its sum relative to
+ * p0 = w*steps; the ranges are combined with alpha^(j*p0), then the even
+ * syndromes follow by squaring.
+ */
+static void bs_syndromes(const struct bch_bs64 *bs, struct bch_bs64_ws *ws)
+{
+    const unsigned int W = bs->width, steps = ws->steps;
+    uint64_t *r = ws->chien, *pl = ws->z, *syn = ws->syn, prod[BS_M];
+    unsigned int k, c, w, st, p;
+
+    for (w = 0; w < W; w++) {
+        for (st = 0; st < steps; st++) {
+            p = w*steps+st;
+            pl[st*W+w] = (p < bs->nbits) ? ws->plane[bs->nbits-1-p] : 0;
+        }
+    }
+    switch (W) {
+#ifdef BS_HAVE_VEC
+    case 8:
+        bs_syn_w8(r, pl, steps);
+        break;
+    case 4:
+        bs_syn_w4(r, pl, steps);
+        break;
+#endif
+    default:
+        bs_syn_w1(r, pl, steps);
+        break;
+    }
+    memset(syn, 0, (2*BS_T+1)*BS_M*sizeof(*syn));
+    for (k = 1; k <= BS_T; k++) {
+        for (w = 0; w < W; w++) {
+            for (c = 0; c < BS_M; c++)
+                prod[c] = r[((k-1)*BS_M+c)*W+w];
+            if (w)
+                bs_mul_const(prod, prod,
+                         bs_apow_mod(bs, (int64_t)(2*k-1)*w*steps));
+            for (c = 0; c < BS_M; c++)
+                syn[(2*k-1)*BS_M+c] ^= prod[c];
+        }
+    }
+    for (k = 2; k <= 2*BS_T; k += 2)
+        gf13_bs64_mul(syn+k*BS_M, syn+(k/2)*BS_M, syn+(k/2)*BS_M);
+}
+
+/*
+ * Inversionless Berlekamp-Massey for binary codes: for round i,
+ *   d      = sum_j lam_j*S_(2i+1-j)
+ *   lam'   = g*lam+d*x*b
+ *   b'     = x*lam, g' = d, L' = 2i+1-L   if d != 0 and L <= i
+ *   b'     = x^2*b                        otherwise
+ * Degrees are bounded by 2i+1 in round i, and a block whose L exceeds t
+ * has failed, so t+1 coefficients are kept.
+ */
+static void bs_berlekamp_massey(struct bch_bs64_ws *ws)
+{
+    uint64_t *lam = ws->lam, *lam2 = lam+BS_POLY_PLANES;
+    uint64_t *b = lam2+BS_POLY_PLANES, *b2 = b+BS_POLY_PLANES, *tmp;
+    uint64_t d[BS_M], g[BS_M], p[BS_M], nz, lm, cm, sel;
+    unsigned int i, j, k, c, dmax, emax;
+
+    memset(lam, 0, 4*BS_POLY_PLANES*sizeof(*lam));
+    memset(g, 0, sizeof(g));
+    lam[0] = b[0] = g[0] = ~0ull;
+    memset(ws->L, 0, sizeof(ws->L));
+
+    for (i = 0; i < BS_T; i++) {
+        dmax = (2*i < BS_T) ? 2*i : BS_T;
+        emax = (2*i+1 < BS_T) ? 2*i+1 : BS_T;
+        memset(d, 0, sizeof(d));
+        for (j = 0; j <= dmax; j++) {
+            gf13_bs64_mul(p, lam+j*BS_M, ws->syn+(2*i+1-j)*BS_M);
+            for (c = 0; c < BS_M; c++)
+                d[c] ^= p[c];
+        }
+        for (nz = 0, c = 0; c < BS_M; c++)
+            nz |= d[c];
+        for (lm = 0, k = 0; k < BCH_BS64_LANES; k++)
+            lm |= (uint64_t)(ws->L[k] <= i) << k;
+        cm = nz & lm;
+
+        for (j = 0; j <= emax; j++) {
+            gf13_bs64_mul(lam2+j*BS_M, lam+j*BS_M, g);
+            if (j) {
+                gf13_bs64_mul(p, b+(j-1)*BS_M, d);
+                for (c = 0; c < BS_M; c++)
+                    lam2[j*BS_M+c] ^= p[c];
+            }
+        }
+        for (j = 0; j <= BS_T; j++) {
+            for (c = 0; c < BS_M; c++) {
+                b2[j*BS_M+c] =
+                    ((j >= 1) ? lam[(j-1)*BS_M+c] & cm : 0)|
+                    ((j >= 2) ? b[(j-2)*BS_M+c] & ~cm : 0);
+            }
+        }
+        for (c = 0; c < BS_M; c++)
+            g[c] = (d[c] & cm)|(g[c] & ~cm);
+        for (k = 0; k < BCH_BS64_LANES; k++) {
+            sel = 0-((cm >> k) & 1);
+            ws->L[k] = (ws->L[k] & ~(unsigned int)sel)|
+                ((2*i+1-ws->L[k]) & (unsigned int)sel);
+        }
+        tmp = lam; lam = lam2; lam2 = tmp;
+        tmp = b; b = b2; b2 = tmp;
+    }
+    /* an even number of swaps: the result is back in ws->lam */
+}
+
+/*
+ * sigma(alpha^-p) for p < nbits. Range w covers positions [w*steps,
+ * (w+1)*steps); its registers start at lam_k*alpha^-k(p0-1) because
+ * every step multiplies before summing.
+ */
+static void bs_chien(const struct bch_bs64 *bs, struct bch_bs64_ws *ws)
+{
+    const unsigned int W = bs->width, steps = ws->steps;
+    uint64_t *r = ws->chien, *e = ws->plane;
+    uint64_t prod[BS_M], z;
+    unsigned int k, c, w, st, p;
+
+    for (w = 0; w < W; w++) {
+        for (c = 0; c < BS_M; c++)
+            r[c*W+w] = ws->lam[c];
+        for (k = 1; k <= BS_T; k++) {
+            bs_mul_const(prod, ws->lam+k*BS_M,
+                     bs_apow_mod(bs, -(int64_t)k*((int64_t)(w*steps)-1)));
+            for (c = 0; c < BS_M; c++)
+                r[(k*BS_M+c)*W+w] = prod[c];
+        }
+    }
+    switch (W) {
+#ifdef BS_HAVE_VEC
+    case 8:
+        bs_chien_w8(r, ws->acc, ws->z, steps);
+        break;
+    case 4:
+        bs_chien_w4(r, ws->acc, ws->z, steps);
+        break;
+#endif
+    default:
+        bs_chien_w1(r, ws->acc, ws->z, steps);
+        break;
+    }
+    /* error plane of stream bit nbits-1-p */
+    memset(e, 0, 64*bs->groups*sizeof(*e));
+    for (w = 0; w < W; w++) {
+        for (st = 0; st < steps; st++) {
+            p = w*steps+st;
+            z = ws->z[st*W+w];
+            if (p < bs->nbits)
+                e[bs->nbits-1-p] = z;
+        }
+    }
+}
+
+int decode_bch_bs64(const struct bch_bs64 *bs, struct bch_bs64_ws *ws,
+            unsigned int nblk, const uint8_t *data, size_t data_stride,
+            const uint8_t *recv_ecc, size_t ecc_stride, uint8_t *corr,
+            int *nerr)
+{
+    const unsigned int len = bs->len, nbytes = bs->nbits/8;
+    unsigned int g, k, i, pos, cnt[BCH_BS64_LANES];
+    uint64_t *a, row;
+    int ok = 0;
+
+    if (!nblk || (nblk > BCH_BS64_LANES) || !data || !recv_ecc || !corr ||
+        !nerr)
+        return -EINVAL;
+    /* 1. transpose: plane s = stream bit s of every block */
+    for (g = 0; g < bs->groups; g++) {
+        a = ws->plane+64*g;
+        for (k = 0; k < BCH_BS64_LANES; k++)
+            a[63-k] = (k < nblk) ?
+                bs_load_row(data+k*data_stride, recv_ecc+k*ecc_stride,
+                        len, nbytes, 8*g) : 0;
+        bs_transpose64(a);
+    }
+    /* 2. syndromes, error locator, roots */
+    bs_syndromes(bs, ws);
+    bs_berlekamp_massey(ws);
+    bs_chien(bs, ws);
+
+    /* 3. error planes back to rows: correct data, count roots */
+    memset(cnt, 0, sizeof(cnt));
+    for (g = 0; g < bs->groups; g++) {
+        a = ws->plane+64*g;
+        bs_transpose64(a);
+        for (k = 0; k < nblk; k++) {
+            row = a[63-k];
+            cnt[k] += bs_weight64(row);
+            for (i = 0, pos = 8*g; (i < 8) && (pos < len); i++, pos++)
+                corr[k*len+pos] = data[k*data_stride+pos]^
+                    (uint8_t)(row >> (56-8*i));
+        }
+    }
+    for (k = 0; k < nblk; k++) {
+        nerr[k] = ((cnt[k] == ws->L[k]) && (ws->L[k] <= BS_T)) ?
+            (int)cnt[k] : -EBADMSG;
+        ok += (nerr[k] >= 0);
+    }
+    return ok;
+}
+
+static unsigned int bs_select_width(unsigned int width)
+{
+    int level = gf13_simd_level();
+    unsigned int top = 1;
+#ifdef BS_HAVE_VEC
+    top = (level >= GF13_SIMD_AVX512) ? 8 : (level >= GF13_SIMD_AVX2) ? 4 : 1;
+#else
+    (void)level;
+#endif
+    if (!width)
+        return top;
+    if ((width != 1) && (width != 4) && (width != 8))
+        return 0;
+    return (width <= top) ? width : top;
+}
+
+struct bch_bs64 *bch_bs64_create(const struct bch_control *bch,
+                 unsigned int len, unsigned int width)
+{
+    struct bch_bs64 *bs;
+
+    if (!bch || (bch->m != BS_M) || (bch->t != BS_T) ||
+        (bch->ecc_bits != BS_SYN_PLANES) ||
+        (bch->a_pow_tab[BS_M] != (GF13_POLY & BS_N)) ||
+        (8*len > BS_N-BS_SYN_PLANES) || !len || !bs_select_width(width))
+        return NULL;
+    bs = calloc(1, sizeof(*bs));
+    if (bs == NULL)
+        return NULL;
+    bs->len = len;
+    bs->nbits = 8*len+BS_SYN_PLANES;
+    bs->groups = DIV_ROUND_UP(bs->nbits, 64);
+    bs->width = bs_select_width(width);
+    bs->a_pow_tab = bch->a_pow_tab;
+    return bs;
+}
+
+void bch_bs64_free(struct bch_bs64 *bs)
+{
+    if (bs) {
+        kfree(bs);
+    }
+}
+
+unsigned int bch_bs64_width(const struct bch_bs64 *bs)
+{
+    return bs->width;
+}
+
+struct bch_bs64_ws *bch_bs64_alloc_workspace(const struct bch_bs64 *bs)
+{
+    struct bch_bs64_ws *ws;
+    const unsigned int steps = DIV_ROUND_UP(bs->nbits, bs->width);
+    const size_t chien = (size_t)BS_POLY_PLANES*bs->width;
+    const size_t acc = BS_TILE_BYTES/sizeof(uint64_t);
+
+    ws = calloc(1, sizeof(*ws));
+    if (ws == NULL)
+        return NULL;
+    ws->steps = steps;
+    ws->plane = kmalloc(64*bs->groups*sizeof(uint64_t), GFP_KERNEL);
+    ws->syn = kmalloc((2*BS_T+1)*BS_M*sizeof(uint64_t), GFP_KERNEL);
+    ws->lam = kmalloc(4*BS_POLY_PLANES*sizeof(uint64_t), GFP_KERNEL);
+    /* vector loads/stores in the Chien kernels: both 64-byte aligned */
+    ws->chien_mem = kmalloc((chien+acc+(size_t)steps*bs->width)*
+                sizeof(uint64_t)+64, GFP_KERNEL);
+    if (!ws->plane || !ws->syn || !ws->lam || !ws->chien_mem) {
+        bch_bs64_free_workspace(ws);
+        return NULL;
+    }
+    ws->chien = (uint64_t *)(((uintptr_t)ws->chien_mem+63) & ~(uintptr_t)63);
+    ws->acc = ws->chien+chien;
+    ws->z = ws->acc+acc;
+    return ws;
+}
+
+void bch_bs64_free_workspace(struct bch_bs64_ws *ws)
+{
+    if (ws) {
+        kfree(ws->plane);
+        kfree(ws->syn);
+        kfree(ws->lam);
+        kfree(ws->chien_mem);
+        kfree(ws);
+    }
+}
+
+/*
+ * Single-block constant-time decoder. The stages above for one block,
+ * each with a fixed amount of work and no branch or table index taken
+ * from the data:
+ *
+ *   1. syndromes of calc_ecc ^ recv_ecc (encode_bch_ct): the odd
+ *      syndromes of every ecc bit are precomputed rows, the bits select
+ *      them with masks
+ *   2. the Berlekamp-Massey above on 16-bit lanes holding coefficients,
+ *      products by shift and masked XOR against the columns a*alpha^b
+ *   3. Chien search over all valid positions: the positions of the one
+ *      block are spread over the 64*width bitsliced lanes, so the Chien
+ *      kernels above run nbits/(64*width) steps
+ */
+#define CT_COEFS               96      /* t+1 coefficients in whole vectors */
+#define CT_PAD                 32      /* zeros in front: x*lam, x^2*b loads */
+#define CT_POLY                (CT_PAD+CT_COEFS)
+#define CT_REV                 (2*BS_T+CT_COEFS)
+
+#if defined(__GNUC__)
+#define CT_HAVE_VEC
+typedef uint16_t ct_u16x8 __attribute__((vector_size(16)));
+typedef int16_t ct_s16x8 __attribute__((vector_size(16)));
+#endif
+#ifdef BS_HAVE_VEC
+typedef uint16_t ct_u16x16 __attribute__((vector_size(32)));
+typedef int16_t ct_s16x16 __attribute__((vector_size(32)));
+typedef uint16_t ct_u16x32 __attribute__((vector_size(64)));
+typedef int16_t ct_s16x32 __attribute__((vector_size(64)));
+#endif
+
+struct bch_ct {
+    const struct bch_control *bch;  /* encoder tables */
+    unsigned int    len;        /* data bytes */
+    unsigned int    nbits;      /* 8*len+832 */
+    unsigned int    width;      /* Chien vector width, as bch_bs64 */
+    unsigned int    steps;      /* positions per bitsliced lane */
+    unsigned int    lanes;      /* coefficients per BM vector: 32/16/8/1 */
+    uint16_t       *rows;       /* [832][t] S_1, S_3, .., S_127 per ecc bit */
+    uint64_t       *start;      /* [t][m][width] planes of alpha^-k(p0-1) */
+    void           *mem;
+};
+
+struct bch_ct_ws {
+    uint8_t         ecc[BS_SYN_PLANES/8];
+    uint16_t       *syn;        /* [2t+1], S_i at i */
+    uint16_t       *rev;        /* [m][CT_REV] S_(2t-p)*alpha^b, 0 past p = 2t-1 */
+    uint16_t       *poly;       /* [4][CT_POLY] lam, lam2, b, b2 */
+    uint64_t       *chien;      /* [(t+1)*m*width] registers */
+    uint64_t       *acc;        /* [steps*m*width] */
+    uint64_t       *z;          /* [steps*width] */
+    uint64_t       *err;        /* position bitmap, bit p */
+    unsigned int    words;      /* of err */
+    void           *mem;
+#ifdef BCH_STATS
+    struct bch_trace trace;
+#endif
+};
+
+/* a^2 = sum_b a_b*alpha^2b: linear in the bits of a */
+static inline unsigned int ct_sqr(unsigned int a)
+{
+    unsigned int r = 0, b;
+
+    for (b = 0; b < BS_M; b++)
+        r ^= bs_apow[64+2*b] & (0u-((a >> b) & 1));
+    return r;
+}
+
+/* col[b] = a*alpha^b */
+static inline void ct_cols(uint16_t *col, unsigned int a)
+{
+    unsigned int b;
+
+    for (b = 0; b < BS_M; b++) {
+        col[b] = (uint16_t)a;
+        a = ((a << 1) & BS_N)^((0u-(a >> (BS_M-1))) & (GF13_POLY & BS_N));
+    }
+}
+
+/* bit loops have constant trip counts, unroll them fully */
+#if defined(__GNUC__)
+#define CT_UNROLL              _Pragma("GCC unroll 16")
+#else
+#define CT_UNROLL
+#endif
+
+/* all-ones in the lanes of x whose bit c is set */
+#define CT_BIT(_u, _s, _x, _c) ((_u)((_s)((_x) << (15-(_c))) >> 15))
+
+/* syn[k] = S_(2k+1): rows of the set ecc bits, XORed under masks */
+#define CT_SYN_FN(_name, _u, _n, _attr)                                 \
+_attr static void _name(uint16_t *syn, const uint16_t *rows,            \
+            const uint8_t *ecc)                                 \
+{                                                                       \
+    _u acc_[BS_T/(_n)], r_, m_, z_ = {0};                               \
+    unsigned int i_, j_;                                                \
+                                                                        \
+    for (j_ = 0; j_ < BS_T/(_n); j_++)                                  \
+        acc_[j_] = z_;                                                  \
+    for (i_ = 0; i_ < BS_SYN_PLANES; i_++, rows += BS_T) {              \
+        m_ = z_+(uint16_t)(0u-((ecc[i_ >> 3] >> (7-(i_ & 7))) & 1));    \
+        CT_UNROLL                                                       \
+        for (j_ = 0; j_ < BS_T/(_n); j_++) {                            \
+            memcpy(&r_, rows+j_*(_n), sizeof(r_));                      \
+            acc_[j_] ^= r_ & m_;                                        \
+        }                                                               \
+    }                                                                   \
+    for (j_ = 0; j_ < BS_T/(_n); j_++)                                  \
+        memcpy(syn+j_*(_n), &acc_[j_], sizeof(acc_[j_]));               \
+}
+
+/*
+ * Inversionless Berlekamp-Massey of bs_berlekamp_massey, coefficients in
+ * lanes. Round i only touches the vectors holding degrees up to 2i+1,
+ * which depends on i alone. rev[b][p] = S_(2t-p)*alpha^b, so the
+ * discrepancy terms S_(2i+1-j) of consecutive j are consecutive in rev;
+ * the same lane masks of lam give d and g*lam in one pass, d*x*b is
+ * added in a second. Returns L, sigma in poly+CT_PAD.
+ */
+#define CT_BM_FN(_name, _u, _s, _n, _attr)                              \
+_attr static unsigned int _name(uint16_t *poly, uint16_t *rev)          \
+{                                                                       \
+    uint16_t *lam = poly+CT_PAD, *lam2 = lam+CT_POLY;                   \
+    uint16_t *b = lam2+CT_POLY, *b2 = b+CT_POLY, *tmp;                  \
+    uint16_t col_[BS_M], t_[_n], d, g = 1, cm;                          \
+    unsigned int i_, v_, c_, j_, nv_, sel, L = 0;                       \
+    _u x_, y_, m_, acc_, dacc_, cv_[BS_M], cmv_, z_ = {0};              \
+                                                                        \
+    for (c_ = 1; c_ < BS_M; c_++) {                                     \
+        for (v_ = 0; v_ < CT_REV; v_ += (_n)) {                         \
+            memcpy(&x_, rev+(c_-1)*CT_REV+v_, sizeof(x_));              \
+            x_ = ((x_ << 1) & (uint16_t)BS_N)^                          \
+                (CT_BIT(_u, _s, x_, BS_M-1) &                           \
+                 (uint16_t)(GF13_POLY & BS_N));                         \
+            memcpy(rev+c_*CT_REV+v_, &x_, sizeof(x_));                  \
+        }                                                               \
+    }                                                                   \
+    memset(poly, 0, 4*CT_POLY*sizeof(*poly));                           \
+    lam[0] = b[0] = 1;                                                  \
+                                                                        \
+    for (i_ = 0; i_ < BS_T; i_++) {                                     \
+        nv_ = DIV_ROUND_UP((2*i_+2 < BS_T+1) ? 2*i_+2 : BS_T+1, (_n));  \
+        /* 1. d = sum_j lam_j*S_(2i+1-j), lam2 = g*lam */               \
+        ct_cols(col_, g);                                               \
+        CT_UNROLL                                                       \
+        for (c_ = 0; c_ < BS_M; c_++)                                   \
+            cv_[c_] = z_+col_[c_];                                      \
+        dacc_ = z_;                                                     \
+        for (v_ = 0; v_ < nv_; v_++) {                                  \
+            memcpy(&x_, lam+v_*(_n), sizeof(x_));                       \
+            acc_ = z_;                                                  \
+            CT_UNROLL                                                   \
+            for (c_ = 0; c_ < BS_M; c_++) {                             \
+                memcpy(&y_, rev+c_*CT_REV+2*BS_T-1-2*i_+v_*(_n),        \
+                       sizeof(y_));                                     \
+                m_ = CT_BIT(_u, _s, x_, c_);                            \
+                dacc_ ^= m_ & y_;                                       \
+                acc_ ^= m_ & cv_[c_];                                   \
+            }                                                           \
+            memcpy(lam2+v_*(_n), &acc_, sizeof(acc_));                  \
+        }                                                               \
+        memcpy(t_, &dacc_, sizeof(t_));                                 \
+        for (d = 0, j_ = 0; j_ < (_n); j_++)                            \
+            d ^= t_[j_];                                                \
+        /* 2. update if d != 0 and L <= i: lam2 += d*x*b, b2 */         \
+        sel = 0u-((((uint32_t)d+0xffffu) >> 16) & ((L-i_-1) >> 31));    \
+        cm = (uint16_t)sel;                                             \
+        ct_cols(col_, d);                                               \
+        CT_UNROLL                                                       \
+        for (c_ = 0; c_ < BS_M; c_++)                                   \
+            cv_[c_] = z_+col_[c_];                                      \
+        cmv_ = z_+cm;                                                   \
+        for (v_ = 0; v_ < nv_; v_++) {                                  \
+            memcpy(&acc_, lam2+v_*(_n), sizeof(acc_));                  \
+            memcpy(&y_, b+v_*(_n)-1, sizeof(y_));                       \
+            CT_UNROLL                                                   \
+            for (c_ = 0; c_ < BS_M; c_++)                               \
+                acc_ ^= CT_BIT(_u, _s, y_, c_) & cv_[c_];               \
+            memcpy(lam2+v_*(_n), &acc_, sizeof(acc_));                  \
+            memcpy(&x_, lam+v_*(_n)-1, sizeof(x_));                     \
+            memcpy(&y_, b+v_*(_n)-2, sizeof(y_));                       \
+            acc_ = (x_ & cmv_)|(y_ & ~cmv_);                            \
+            memcpy(b2+v_*(_n), &acc_, sizeof(acc_));                    \
+        }                                                               \
+        /* t+1 coefficients are kept, as in bs_berlekamp_massey */      \
+        memset(lam2+BS_T+1, 0, (CT_COEFS-BS_T-1)*sizeof(*lam2));        \
+        memset(b2+BS_T+1, 0, (CT_COEFS-BS_T-1)*sizeof(*b2));            \
+        g = (uint16_t)((d & cm)|(g & ~cm));                             \
+        L = ((2*i_+1-L) & sel)|(L & ~sel);                              \
+        tmp = lam; lam = lam2; lam2 = tmp;                              \
+        tmp = b; b = b2; b2 = tmp;                                      \
+    }                                                                   \
+    return L;                                                           \
+}
+
+/*
+ * Chien registers of bs_chien for one block in every lane: r_k =
+ * lam_k*alpha^-k(p0-1), the lane constants alpha^-k(p0-1) read from the
+ * start planes. Horner over the bits of lam_k, a <- a*alpha+(s & bit),
+ * keeps only the product in registers (x^13 = x^4+x^3+x+1).
+ */
+#define BS_CT_TERM(_c)         a_[_c] ^= s_[_c] & m_
+#define BS_CT_ALPHA                                                     \
+    t_ = a_[12]; a_[12] = a_[11]; a_[11] = a_[10]; a_[10] = a_[9];      \
+    a_[9] = a_[8]; a_[8] = a_[7]; a_[7] = a_[6]; a_[6] = a_[5];         \
+    a_[5] = a_[4]; a_[4] = a_[3]^t_; a_[3] = a_[2]^t_; a_[2] = a_[1];   \
+    a_[1] = a_[0]^t_; a_[0] = t_
+#define BS_CT_START_FN(_name, _type, _attr)                             \
+_attr static void _name(uint64_t *rbuf, const uint64_t *sbuf,           \
+            const uint16_t *lam)                                \
+{                                                                       \
+    _type *r_ = (_type *)rbuf, a_[BS_M], m_, t_, z_ = {0};              \
+    const _type *s_ = (const _type *)sbuf;                              \
+    unsigned int k_, b_, c_;                                            \
+                                                                        \
+    CT_UNROLL                                                           \
+    for (c_ = 0; c_ < BS_M; c_++)                                       \
+        r_[c_] = z_-(uint64_t)((lam[0] >> c_) & 1);                     \
+    for (k_ = 1; k_ <= BS_T; k_++, s_ += BS_M) {                        \
+        BS_EACH(BS_ZERO_A);                                             \
+        for (b_ = BS_M; b_-- > 0;) {                                    \
+            BS_CT_ALPHA;                                                \
+            m_ = z_-(uint64_t)((lam[k_] >> b_) & 1);                    \
+            BS_EACH(BS_CT_TERM);                                        \
+        }                                                               \
+        CT_UNROLL                                                       \
+        for (c_ = 0; c_ < BS_M; c_++)                                   \
+            r_[k_*BS_M+c_] = a_[c_];                                    \
+    }                                                                   \
+}
+#define BS_ZERO_A(_c)          a_[_c] = z_
+
+#ifdef CT_HAVE_VEC
+CT_SYN_FN(ct_syn_x8, ct_u16x8, 8, )
+CT_BM_FN(ct_bm_x8, ct_u16x8, ct_s16x8, 8, )
+#else
+CT_SYN_FN(ct_syn_x1, uint16_t, 1, )
+CT_BM_FN(ct_bm_x1, uint16_t, int16_t, 1, )
+#endif
+BS_CT_START_FN(bs_ct_start_w1, uint64_t, )
+#ifdef BS_HAVE_VEC
+CT_SYN_FN(ct_syn_x16, ct_u16x16, 16, BS_TARGET_AVX2)
+CT_SYN_FN(ct_syn_x32, ct_u16x32, 32, BS_TARGET_AVX512BW)
+CT_BM_FN(ct_bm_x16, ct_u16x16, ct_s16x16, 16, BS_TARGET_AVX2)
+CT_BM_FN(ct_bm_x32, ct_u16x32, ct_s16x32, 32, BS_TARGET_AVX512BW)
+BS_CT_START_FN(bs_ct_start_w4, bs_v4, BS_TARGET_AVX2)
+BS_CT_START_FN(bs_ct_start_w8, bs_v8, BS_TARGET_AVX512)
+#endif
+
+/* sigma(alpha^-p) == 0 for the positions of lane 64w+q: bit p of ws->err */
+static void ct_chien(const struct bch_ct *ct, struct bch_ct_ws *ws,
+             const uint16_t *lam)
+{
+    const unsigned int W = ct->width, steps = ct->steps;
+    uint64_t a[64], row;
+    unsigned int w, q, st, s0, pos;
+
+    switch (W) {
+#ifdef BS_HAVE_VEC
+    case 8:
+        bs_ct_start_w8(ws->chien, ct->start, lam);
+        bs_chien_w8(ws->chien, ws->acc, ws->z, steps);
+        break;
+    case 4:
+        bs_ct_start_w4(ws->chien, ct->start, lam);
+        bs_chien_w4(ws->chien, ws->acc, ws->z, steps);
+        break;
+#endif
+    default:
+        bs_ct_start_w1(ws->chien, ct->start, lam);
+        bs_chien_w1(ws->chien, ws->acc, ws->z, steps);
+        break;
+    }
+    /* 64 steps at a time: after the transpose a[63-q] bit st is lane q */
+    memset(ws->err, 0, ws->words*sizeof(*ws->err));
+    for (w = 0; w < W; w++) {
+        for (s0 = 0; s0 < steps; s0 += 64) {
+            for (st = 0; st < 64; st++)
+                a[63-st] = (s0+st < steps) ? ws->z[(s0+st)*W+w] : 0;
+            bs_transpose64(a);
+            for (q = 0; q < 64; q++) {
+                pos = (64*w+q)*steps+s0;
+                row = a[63-q];
+                ws->err[pos/64] |= row << (pos%64);
+                if (pos%64)
+                    ws->err[pos/64+1] |= row >> (64-pos%64);
+            }
+        }
+    }
+}
+
+int decode_bch_ct(const struct bch_ct *ct, struct bch_ct_ws *ws,
+          const uint8_t *data, const uint8_t *recv_ecc, uint8_t *errvec)
+{
+    const unsigned int nbits = ct->nbits;
+    uint16_t *syn = ws->syn, *lam = ws->poly+CT_PAD;
+    unsigned int i, k, p, L, cnt;
+
+    if (!data || !recv_ecc || !errvec)
+        return -EINVAL;
+    BCH_TRACE_BEGIN(ws);
+    /* 1. syndromes: odd ones from the rows, even ones by squaring */
+    encode_bch_ct(ct->bch, data, ct->len, ws->ecc);
+    for (i = 0; i < sizeof(ws->ecc); i++)
+        ws->ecc[i] ^= recv_ecc[i];
+    BCH_TRACE_STAGE(ws, BCH_STAGE_ENCODE);
+    switch (ct->lanes) {
+#ifdef BS_HAVE_VEC
+    case 32:
+        ct_syn_x32(ws->rev, ct->rows, ws->ecc);
+        break;
+    case 16:
+        ct_syn_x16(ws->rev, ct->rows, ws->ecc);
+        break;
+#endif
+    default:
+#ifdef CT_HAVE_VEC
+        ct_syn_x8(ws->rev, ct->rows, ws->ecc);
+#else
+        ct_syn_x1(ws->rev, ct->rows, ws->ecc);
+#endif
+        break;
+    }
+    syn[0] = 0;
+    for (k = 1; k <= BS_T; k++)
+        syn[2*k-1] = ws->rev[k-1];
+    for (k = 1; k <= BS_T; k++)
+        syn[2*k] = (uint16_t)ct_sqr(syn[k]);
+    for (p = 0; p < CT_REV; p++)
+        ws->rev[p] = (p < 2*BS_T) ? syn[2*BS_T-p] : 0;
+    BCH_TRACE_STAGE(ws, BCH_STAGE_SYNDROME);
+
+    /* 2. error locator */
+    switch (ct->lanes) {
+#ifdef BS_HAVE_VEC
+    case 32:
+        L = ct_bm_x32(ws->poly, ws->rev);
+        break;
+    case 16:
+        L = ct_bm_x16(ws->poly, ws->rev);
+        break;
+#endif
+    default:
+#ifdef CT_HAVE_VEC
+        L = ct_bm_x8(ws->poly, ws->rev);
+#else
+        L = ct_bm_x1(ws->poly, ws->rev);
+#endif
+        break;
+    }
+    BCH_TRACE_STAGE(ws, BCH_STAGE_BM);
+    BCH_TRACE_SET(ws, elp_deg, L);
+
+    /* 3. roots: positions past nbits are dropped, p = nbits-1-s */
+    ct_chien(ct, ws, lam);
+    ws->err[nbits/64] &= (1ull << (nbits%64))-1;
+    for (i = nbits/64+1; i < ws->words; i++)
+        ws->err[i] = 0;
+    for (cnt = 0, i = 0; i <= nbits/64; i++)
+        cnt += bs_weight64(ws->err[i]);
+    /* data byte k: stream bits 8k..8k+7, one byte of the bitmap */
+    for (k = 0; k < ct->len; k++) {
+        p = nbits/8-1-k;
+        errvec[k] = (uint8_t)(ws->err[p/8] >> (8*(p%8)));
+    }
+    BCH_TRACE_STAGE(ws, BCH_STAGE_ROOTS);
+    return ((cnt == L) && (L <= BS_T)) ? (int)cnt : -EBADMSG;
+}
+
+static unsigned int ct_select_lanes(void)
+{
+#ifdef BS_HAVE_VEC
+    int level = gf13_simd_level();
+
+    if (level >= GF13_SIMD_AVX512)
+        return 32;
+    if (level >= GF13_SIMD_AVX2)
+        return 16;
+#endif
+#ifdef CT_HAVE_VEC
+    return 8;
+#else
+    return 1;
+#endif
+}
+
+struct bch_ct *bch_ct_create(const struct bch_control *bch, unsigned int len,
+                 unsigned int width)
+{
+    struct bch_ct *ct;
+    struct bch_workspace *bws;
+    unsigned int syn[2*BS_T], i, k, c, w, q;
+    uint8_t ecc[BS_SYN_PLANES/8];
+    const size_t rows = (size_t)BS_SYN_PLANES*BS_T*sizeof(uint16_t);
+    int64_t e;
+    uint64_t *s;
+
+    if (!bch || (bch->m != BS_M) || (bch->t != BS_T) ||
+        (bch->ecc_bits != BS_SYN_PLANES) ||
+        (bch->a_pow_tab[BS_M] != (GF13_POLY & BS_N)) ||
+        (8*len > BS_N-BS_SYN_PLANES) || !len || !bs_select_width(width))
+        return NULL;
+    ct = calloc(1, sizeof(*ct));
+    if (ct == NULL)
+        return NULL;
+    ct->bch = bch;
+    ct->len = len;
+    ct->nbits = 8*len+BS_SYN_PLANES;
+    ct->width = bs_select_width(width);
+    ct->steps = DIV_ROUND_UP(ct->nbits, 64*ct->width);
+    ct->lanes = ct_select_lanes();
+    ct->mem = kmalloc(rows+(size_t)BS_T*BS_M*ct->width*sizeof(uint64_t)+64,
+              GFP_KERNEL);
+    bws = bch_alloc_workspace(bch);
+    if (!ct->mem || !bws) {
+        bch_free_workspace(bws);
+        bch_ct_free(ct);
+        return NULL;
+    }
+    ct->rows = (uint16_t *)(((uintptr_t)ct->mem+63) & ~(uintptr_t)63);
+    ct->start = (uint64_t *)((uint8_t *)ct->rows+rows);
+
+    /* row i: syndromes of the remainder with only ecc bit i set */
+    for (i = 0; i < BS_SYN_PLANES; i++) {
+        memset(ecc, 0, sizeof(ecc));
+        ecc[i/8] = 0x80 >> (i%8);
+        bch_ecc_syndromes(bch, bws, ecc, syn);
+        for (k = 0; k < BS_T; k++)
+            ct->rows[i*BS_T+k] = (uint16_t)syn[2*k];
+    }
+    bch_free_workspace(bws);
+
+    /* lane 64w+q starts at p0 = (64w+q)*steps */
+    s = ct->start;
+    memset(s, 0, (size_t)BS_T*BS_M*ct->width*sizeof(*s));
+    for (k = 1; k <= BS_T; k++) {
+        for (w = 0; w < ct->width; w++) {
+            for (q = 0; q < 64; q++) {
+                e = -(int64_t)k*((int64_t)(64*w+q)*ct->steps-1);
+                e %= BS_N;
+                if (e < 0)
+                    e += BS_N;
+                for (c = 0; c < BS_M; c++)
+                    s[((k-1)*BS_M+c)*ct->width+w] |=
+                        (uint64_t)((bch->a_pow_tab[e] >> c) & 1) << q;
+            }
+        }
+    }
+    return ct;
+}
+
+void bch_ct_free(struct bch_ct *ct)
+{
+    if (ct) {
+        kfree(ct->mem);
+        kfree(ct);
+    }
+}
+
+unsigned int bch_ct_width(const struct bch_ct *ct)
+{
+    return ct->width;
+}
+
+struct bch_ct_ws *bch_ct_alloc_workspace(const struct bch_ct *ct)
+{
+    struct bch_ct_ws *ws;
+    const size_t W = ct->width;
+    size_t off[8], size = 0;
+    unsigned int i;
+
+    ws = calloc(1, sizeof(*ws));
+    if (ws == NULL)
+        return NULL;
+    ws->words = DIV_ROUND_UP(64*ct->width*ct->steps, 64)+1;
+    /* one block, every part 64-byte aligned for the vector kernels */
+    off[0] = (2*BS_T+1)*sizeof(uint16_t);
+    off[1] = (size_t)BS_M*CT_REV*sizeof(uint16_t);
+    off[2] = 4*CT_POLY*sizeof(uint16_t);
+    off[3] = (size_t)BS_POLY_PLANES*W*sizeof(uint64_t);
+    off[4] = (size_t)ct->steps*BS_M*W*sizeof(uint64_t);
+    off[5] = (size_t)ct->steps*W*sizeof(uint64_t);
+    off[6] = (size_t)ws->words*sizeof(uint64_t);
+    for (i = 0; i < 7; i++) {
+        off[7] = (off[i]+63) & ~(size_t)63;
+        off[i] = size;
+        size += off[7];
+    }
+    ws->mem = kmalloc(size+64, GFP_KERNEL);
+    if (ws->mem == NULL) {
+        kfree(ws);
+        return NULL;
+    }
+    ws->syn = (uint16_t *)(((uintptr_t)ws->mem+63) & ~(uintptr_t)63);
+    ws->rev = (uint16_t *)((uint8_t *)ws->syn+off[1]);
+    ws->poly = (uint16_t *)((uint8_t *)ws->syn+off[2]);
+    ws->chien = (uint64_t *)((uint8_t *)ws->syn+off[3]);
+    ws->acc = (uint64_t *)((uint8_t *)ws->syn+off[4]);
+    ws->z = (uint64_t *)((uint8_t *)ws->syn+off[5]);
+    ws->err = (uint64_t *)((uint8_t *)ws->syn+off[6]);
+    return ws;
+}
+
+void bch_ct_free_workspace(struct bch_ct_ws *ws)
+{
+    if (ws) {
+        kfree(ws->mem);
+        kfree(ws);
+    }
+}
+
+#ifdef BCH_STATS
+const struct bch_trace *bch_ct_trace(const struct bch_ct_ws *ws)
+{
+    return &ws->trace;
+}
+#endif
@@ -0,0 +1,20 @@
+/*
+ * Specialized build of the encode/decode hot paths for the fixed
+ * parameter set of this project: m = 13, t = 64, ecc_bits = 832
+ * (n = 8191, 26 ECC words). Field sizes become compile-time constants,
+ * so register copies and scratch arrays are fixed-size and the word
+ * loops are fully unrolled. init_bch_cfg selects it through
+ * bch_control.kernel; tables are shared with the generic path.
+ */
+#define BCH_SPECIALIZED
+#define GF_M(_p)               13
+#define GF_T(_p)               64
+#define GF_N(_p)               8191
+#define GF_ECC_BITS(_p)        832
+
+#define encode_bch_ws          encode_bch_ws_m13t64
+#define decode_bch_ws          decode_bch_ws_m13t64
+#define bch_ecc_syndromes      bch_ecc_syndromes_m13t64
+#define bch_locator_degree     bch_locator_degree_m13t64
+
+#include "bch.c"
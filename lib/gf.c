@@ -0,0 +1,313 @@
+#include "gf.h"
+#include "win_compat.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define GF_HAVE_SIMD
+#define GF_TARGET_AVX2   __attribute__((target("avx2")))
+#define GF_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define GF_HAVE_SIMD
+#define GF_TARGET_AVX2
+#define GF_TARGET_AVX512
+#endif
+
+#if defined(__GNUC__)
+#define GF_UNROLL              _Pragma("GCC unroll 16")
+#else
+#define GF_UNROLL
+#endif
+
+int gf_tab_init(struct gf_tab *tab, unsigned int m, unsigned int poly)
+{
+    unsigned int i, x = 1;
+    const unsigned int k = 1u << m;
+
+    memset(tab, 0, sizeof(*tab));
+    if ((m < 2) || (m > 15) || (poly < k) || (poly >= 2*k))
+        return -1;
+    tab->m = m;
+    tab->n = k-1;
+    tab->log = kmalloc((tab->n+1)*sizeof(*tab->log), GFP_KERNEL);
+    tab->exp = kmalloc(GF_TAB_EXP_SIZE(tab->n)*sizeof(*tab->exp), GFP_KERNEL);
+    if (!tab->log || !tab->exp)
+        goto fail;
+    for (i = 0; i < tab->n; i++) {
+        tab->exp[i] = x;
+        tab->log[x] = i;
+        if (i && (x == 1))
+            goto fail;
+        x <<= 1;
+        if (x & k)
+            x ^= poly;
+    }
+    /* second period, then zeros reached only through the log[0] = 2n */
+    tab->log[0] = 2*tab->n;
+    for (i = tab->n; i < 2*tab->n; i++)
+        tab->exp[i] = tab->exp[i-tab->n];
+    for (; i < GF_TAB_EXP_SIZE(tab->n); i++)
+        tab->exp[i] = 0;
+    return 0;
+fail:
+    gf_tab_free(tab);
+    return -1;
+}
+
+void gf_tab_free(struct gf_tab *tab)
+{
+    kfree(tab->log);
+    kfree(tab->exp);
+    tab->log = NULL;
+    tab->exp = NULL;
+}
+
+size_t gf_tab_bytes(unsigned int m)
+{
+    const size_t n = (1u << m)-1;
+    return (n+1+GF_TAB_EXP_SIZE(n))*sizeof(uint16_t);
+}
+
+/*
+ * Bitsliced multiply: schoolbook product of the 13 bit planes into 25
+ * planes, then fold planes 24..13 down with x^13 = x^4+x^3+x+1.
+ */
+#define GF13_BS_MUL(_type, _r, _a, _b)                                  \
+    do {                                                                \
+        _type p_[2*GF13_M-1], x_[GF13_M], y_[GF13_M];                   \
+        int i_, j_;                                                     \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < GF13_M; i_++) {                               \
+            x_[i_] = (_a)[i_];                                          \
+            y_[i_] = (_b)[i_];                                          \
+        }                                                               \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < 2*GF13_M-1; i_++)                             \
+            p_[i_] = 0;                                                 \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < GF13_M; i_++)                                 \
+            GF_UNROLL                                                   \
+            for (j_ = 0; j_ < GF13_M; j_++)                             \
+                p_[i_+j_] ^= x_[i_] & y_[j_];                           \
+        GF_UNROLL                                                       \
+        for (i_ = 2*GF13_M-2; i_ >= GF13_M; i_--) {                     \
+            p_[i_-GF13_M+4] ^= p_[i_];                                  \
+            p_[i_-GF13_M+3] ^= p_[i_];                                  \
+            p_[i_-GF13_M+1] ^= p_[i_];                                  \
+            p_[i_-GF13_M] ^= p_[i_];                                    \
+        }                                                               \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < GF13_M; i_++)                                 \
+            (_r)[i_] = p_[i_];                                          \
+    } while (0)
+
+void gf13_bs32_mul(uint32_t *r, const uint32_t *a, const uint32_t *b)
+{
+    GF13_BS_MUL(uint32_t, r, a, b);
+}
+
+void gf13_bs64_mul(uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+    GF13_BS_MUL(uint64_t, r, a, b);
+}
+
+/* lane k goes to bit k of every plane; accumulate planes in registers */
+#define GF13_BS_PACK(_type, _lanes, _w, _x)                             \
+    do {                                                                \
+        _type p_[GF13_M];                                               \
+        unsigned int v_;                                                \
+        int i_, k_;                                                     \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < GF13_M; i_++)                                 \
+            p_[i_] = 0;                                                 \
+        for (k_ = (_lanes)-1; k_ >= 0; k_--) {                          \
+            v_ = (_x)[k_];                                              \
+            GF_UNROLL                                                   \
+            for (i_ = 0; i_ < GF13_M; i_++)                             \
+                p_[i_] = (p_[i_] << 1)|((v_ >> i_) & 1);                \
+        }                                                               \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < GF13_M; i_++)                                 \
+            (_w)[i_] = p_[i_];                                          \
+    } while (0)
+
+#define GF13_BS_UNPACK(_type, _lanes, _x, _w)                           \
+    do {                                                                \
+        _type p_[GF13_M];                                               \
+        unsigned int v_;                                                \
+        int i_, k_;                                                     \
+        GF_UNROLL                                                       \
+        for (i_ = 0; i_ < GF13_M; i_++)                                 \
+            p_[i_] = (_w)[i_];                                          \
+        for (k_ = 0; k_ < (_lanes); k_++) {                             \
+            v_ = 0;                                                     \
+            GF_UNROLL                                                   \
+            for (i_ = 0; i_ < GF13_M; i_++)                             \
+                v_ |= (unsigned int)((p_[i_] >> k_) & 1) << i_;         \
+            (_x)[k_] = (uint16_t)v_;                                    \
+        }                                                               \
+    } while (0)
+
+void gf13_bs32_pack(uint32_t *w, const uint16_t *x)
+{
+    GF13_BS_PACK(uint32_t, 32, w, x);
+}
+
+void gf13_bs32_unpack(uint16_t *x, const uint32_t *w)
+{
+    GF13_BS_UNPACK(uint32_t, 32, x, w);
+}
+
+void gf13_bs64_pack(uint64_t *w, const uint16_t *x)
+{
+    GF13_BS_PACK(uint64_t, 64, w, x);
+}
+
+void gf13_bs64_unpack(uint16_t *x, const uint64_t *w)
+{
+    GF13_BS_UNPACK(uint64_t, 64, x, w);
+}
+
+/*
+ * Vector multiply, shift-and-add on 16-bit lanes: for each bit i of b,
+ * r ^= a where the bit is set, then a = a*x reduced by the polynomial
+ * (bit 12 moves to bit 13, which the xor with 0x201b clears again).
+ * No tables and no data-dependent branches.
+ */
+#ifdef GF_HAVE_SIMD
+GF_TARGET_AVX2
+static void gf13_mul_vec_avx2(uint16_t *r, const uint16_t *a,
+                  const uint16_t *b, size_t len)
+{
+    const __m256i poly = _mm256_set1_epi16(GF13_POLY);
+    __m256i va, vb, vr;
+    size_t k;
+    int i;
+
+    for (k = 0; k+16 <= len; k += 16) {
+        va = _mm256_loadu_si256((const __m256i *)(a+k));
+        vb = _mm256_loadu_si256((const __m256i *)(b+k));
+        vr = _mm256_setzero_si256();
+        GF_UNROLL
+        for (i = 0; i < GF13_M; i++) {
+            vr = _mm256_xor_si256(vr, _mm256_and_si256(va,
+                 _mm256_srai_epi16(_mm256_slli_epi16(vb, 15), 15)));
+            vb = _mm256_srli_epi16(vb, 1);
+            va = _mm256_xor_si256(_mm256_slli_epi16(va, 1),
+                 _mm256_and_si256(poly,
+                 _mm256_srai_epi16(_mm256_slli_epi16(va, 3), 15)));
+        }
+        _mm256_storeu_si256((__m256i *)(r+k), vr);
+    }
+    for (; k < len; k++) {
+        uint16_t x = a[k], y = 0;
+        for (i = 0; i < GF13_M; i++) {
+            y ^= x & (uint16_t)-((b[k] >> i) & 1);
+            x = (uint16_t)((x << 1)^(GF13_POLY & -((x >> 12) & 1)));
+        }
+        r[k] = y;
+    }
+}
+
+GF_TARGET_AVX512
+static void gf13_mul_vec_avx512(uint16_t *r, const uint16_t *a,
+                const uint16_t *b, size_t len)
+{
+    const __m512i poly = _mm512_set1_epi16(GF13_POLY);
+    __m512i va, vb, vr;
+    size_t k = 0;
+    int i;
+
+    for (; k+32 <= len; k += 32) {
+        va = _mm512_loadu_si512((const void *)(a+k));
+        vb = _mm512_loadu_si512((const void *)(b+k));
+        vr = _mm512_setzero_si512();
+        GF_UNROLL
+        for (i = 0; i < GF13_M; i++) {
+            vr = _mm512_xor_si512(vr, _mm512_and_si512(va,
+                 _mm512_srai_epi16(_mm512_slli_epi16(vb, 15), 15)));
+            vb = _mm512_srli_epi16(vb, 1);
+            va = _mm512_xor_si512(_mm512_slli_epi16(va, 1),
+                 _mm512_and_si512(poly,
+                 _mm512_srai_epi16(_mm512_slli_epi16(va, 3), 15)));
+        }
+        _mm512_storeu_si512((void *)(r+k), vr);
+    }
+    if (k < len)
+        gf13_mul_vec_avx2(r+k, a+k, b+k, len-k);
+}
+
+static int cpu_level(void)
+{
+#ifdef _MSC_VER
+    int r[4];
+    __cpuidex(r, 7, 0);
+    if (((r[1] >> 16) & 1) && ((r[1] >> 30) & 1))
+        return GF13_SIMD_AVX512;
+    if ((r[1] >> 5) & 1)
+        return GF13_SIMD_AVX2;
+    return GF13_SIMD_NONE;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+        return GF13_SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return GF13_SIMD_AVX2;
+    return GF13_SIMD_NONE;
+#endif
+}
+#endif
+
+int gf13_simd_level(void)
+{
+#ifdef GF_HAVE_SIMD
+    /*
+     * cached with relaxed atomics: threads may all run cpu_level() once
+     * and store the same value, but no access is a data race
+     */
+    static int level = -1;
+#ifdef _MSC_VER
+    int l = *(volatile int *)&level;
+    if (l < 0) {
+        l = cpu_level();
+        *(volatile int *)&level = l;
+    }
+#else
+    int l = __atomic_load_n(&level, __ATOMIC_RELAXED);
+    if (l < 0) {
+        l = cpu_level();
+        __atomic_store_n(&level, l, __ATOMIC_RELAXED);
+    }
+#endif
+    return l;
+#else
+    return GF13_SIMD_NONE;
+#endif
+}
+
+void gf13_mul_vec_level(int level, const struct gf_tab *tab, uint16_t *r,
+            const uint16_t *a, const uint16_t *b, size_t len)
+{
+    size_t k;
+    if (level > gf13_simd_level())
+        level = gf13_simd_level();
+#ifdef GF_HAVE_SIMD
+    if (level == GF13_SIMD_AVX512) {
+        gf13_mul_vec_avx512(r, a, b, len);
+        return;
+    }
+    if (level == GF13_SIMD_AVX2) {
+        gf13_mul_vec_avx2(r, a, b, len);
+        return;
+    }
+#endif
+    for (k = 0; k < len; k++)
+        r[k] = (uint16_t)gf_tab_mul(tab, a[k], b[k]);
+}
+
+void gf13_mul_vec(const struct gf_tab *tab, uint16_t *r, const uint16_t *a,
+          const uint16_t *b, size_t len)
+{
+    gf13_mul_vec_level(GF13_SIMD_AVX512, tab, r, a, b, len);
+}
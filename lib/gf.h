@@ -0,0 +1,80 @@
+#ifndef _GF_H
+#define _GF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * GF(2^m) 연산 모듈
+ * - 스칼라: uint16 로그/지수 테이블 (m <= 15 아무 필드, bch.c가 사용)
+ *   0의 로그를 2n 표시값으로 두고 지수 테이블의 2n 이후를 0으로 채워
+ *   곱/제곱/나눗셈이 0 검사 없이 조회 1번
+ * - bitsliced: m = 13 원소 32/64개를 비트 평면 13워드로 두고 AND/XOR 곱
+ * - SIMD: m = 13 원소 배열 곱 (AVX2 16개 / AVX-512BW 32개씩, 테이블 없음)
+ */
+
+/* 로그/지수 테이블 (init 이후 읽기 전용, 여러 스레드가 공유 가능) */
+struct gf_tab {
+    unsigned int    m;
+    unsigned int    n;      /* 2^m - 1 */
+    uint16_t       *log;    /* [n+1], log[0] = 2n (0 표시값) */
+    uint16_t       *exp;    /* [4n+1], i < 2n: alpha^i, 2n..4n: 0 */
+};
+
+#define GF_TAB_EXP_SIZE(_n)     (4*(_n)+1)
+
+/* 0: 성공, -1: m 범위 밖 / 원시 다항식 아님 / 메모리 부족 */
+int gf_tab_init(struct gf_tab *tab, unsigned int m, unsigned int poly);
+void gf_tab_free(struct gf_tab *tab);
+size_t gf_tab_bytes(unsigned int m);
+
+static inline unsigned int gf_tab_mul(const struct gf_tab *g, unsigned int a,
+                      unsigned int b)
+{
+    return g->exp[g->log[a]+g->log[b]];
+}
+
+static inline unsigned int gf_tab_sqr(const struct gf_tab *g, unsigned int a)
+{
+    return g->exp[2*g->log[a]];
+}
+
+/* b != 0 */
+static inline unsigned int gf_tab_div(const struct gf_tab *g, unsigned int a,
+                      unsigned int b)
+{
+    return g->exp[g->log[a]+g->n-g->log[b]];
+}
+
+/* a != 0 */
+static inline unsigned int gf_tab_inv(const struct gf_tab *g, unsigned int a)
+{
+    return g->exp[g->n-g->log[a]];
+}
+
+/* ===== m = 13 전용 (원시 다항식 x^13+x^4+x^3+x+1) ===== */
+#define GF13_M          13
+#define GF13_N          8191
+#define GF13_POLY       0x201b
+
+/* bitsliced: w[i]의 비트 k = 원소 k의 i번째 비트 */
+void gf13_bs32_mul(uint32_t *r, const uint32_t *a, const uint32_t *b);
+void gf13_bs64_mul(uint64_t *r, const uint64_t *a, const uint64_t *b);
+void gf13_bs32_pack(uint32_t *w, const uint16_t *x);
+void gf13_bs32_unpack(uint16_t *x, const uint32_t *w);
+void gf13_bs64_pack(uint64_t *w, const uint16_t *x);
+void gf13_bs64_unpack(uint16_t *x, const uint64_t *w);
+
+/* r[i] = a[i]*b[i], i < len (r가 a 또는 b와 같아도 됨) */
+#define GF13_SIMD_NONE      0
+#define GF13_SIMD_AVX2      1
+#define GF13_SIMD_AVX512    2
+
+int gf13_simd_level(void);
+void gf13_mul_vec(const struct gf_tab *tab, uint16_t *r, const uint16_t *a,
+          const uint16_t *b, size_t len);
+/* 백엔드 직접 호출 (측정 / 비교용, level이 CPU보다 높으면 한 단계씩 낮춤) */
+void gf13_mul_vec_level(int level, const struct gf_tab *tab, uint16_t *r,
+            const uint16_t *a, const uint16_t *b, size_t len);
+
+#endif /* _GF_H */
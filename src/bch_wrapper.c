@@ -5,46 +5,211 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+// 레거시 API(fe_bch_init / fe_encode / fe_decode)가 사용하는 공용 인스턴스
 static struct bch_control *bch = NULL;
 
+/* =================================================================
+ * [Context API] 인스턴스를 직접 소유하는 호출자용
+ * ================================================================= */
+
+struct bch_control *fe_bch_create(const struct bch_config *cfg) {
+    // 정의된 상수를 사용하여 테이블(GF, mod8, deg2 base) 1회 생성
+    return init_bch_cfg(GFBITS, SYS_T, 0, cfg);
+}
+
+struct bch_control *fe_bch_create_image(const struct bch_config *cfg, const void *image, size_t size) {
+    // 테이블은 image를 그대로 가리킴 (복사 / 계산 없음, 맞지 않는 이미지면 NULL)
+    return init_bch_image(image, size, GFBITS, SYS_T, 0, cfg);
+}
+
+void fe_bch_destroy(struct bch_control *ctx) {
+    if (ctx) free_bch(ctx);
+}
+
+struct bch_workspace *fe_bch_ws_create(const struct bch_control *ctx) {
+    if (!ctx) return NULL;
+    return bch_alloc_workspace(ctx);
+}
+
+void fe_bch_ws_destroy(struct bch_workspace *ws) {
+    if (ws) bch_free_workspace(ws);
+}
+
+void fe_bch_encode(const struct bch_control *ctx, struct bch_workspace *ws,
+                   const uint8_t *input, uint8_t *ecc) {
+    if (!ctx || !ws) return;
+
+    // 라이브러리에 순수 데이터(FE_DATA_BYTES)만 넘기면 
+    // 내부적으로 Shortening(Zero-Padding)을 처리하여 ECC 생성
+    memset(ecc, 0, ctx->ecc_bytes);
+    encode_bch_ws(ctx, ws, input, FE_DATA_BYTES, ecc);
+}
+
+void fe_bch_encode_update(const struct bch_control *ctx, struct bch_workspace *ws,
+                          const uint8_t *chunk, size_t len, uint8_t *ecc) {
+    if (!ctx || !ws || len == 0) return;
+
+    // ecc에 든 나머지를 불러와 이어서 나눔 (앞쪽 Shortening 0은 나머지에 영향 없음)
+    encode_bch_ws(ctx, ws, chunk, (unsigned int)len, ecc);
+}
+
+// errloc에서 데이터 영역 위치만 앞으로 모음 (ECC 영역 오류는 버림), 남은 개수 반환
+static size_t fe_bch_compact(unsigned int *errloc, int count) {
+    size_t n = 0;
+    for (int i = 0; i < count; i++) {
+        if (errloc[i] < FE_DATA_BYTES * 8) errloc[n++] = errloc[i];
+    }
+    return n;
+}
+
+// errloc의 비트를 뒤집음
+static void fe_bch_correct(uint8_t *noisy_input, const unsigned int *errloc, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        unsigned int idx = errloc[i];
+        noisy_input[idx / 8] ^= (1 << (idx % 8));
+    }
+}
+
+int fe_bch_locate(const struct bch_control *ctx, struct bch_workspace *ws,
+                  const uint8_t *input, const uint8_t *ecc,
+                  unsigned int *errloc, size_t *nflip) {
+    if (!ctx || !ws || !errloc || !nflip) return -1;
+
+    // 디코딩 수행 (입력은 읽기만 함)
+    int count = decode_bch_ws(ctx, ws, input, FE_DATA_BYTES, ecc, NULL, NULL, errloc);
+    *nflip = (count > 0) ? fe_bch_compact(errloc, count) : 0;
+    return count;
+}
+
+int fe_bch_decode(const struct bch_control *ctx, struct bch_workspace *ws,
+                  uint8_t *noisy_input, const uint8_t *ecc) {
+    unsigned int errloc[SYS_T];
+    size_t nflip;
+    int count = fe_bch_locate(ctx, ws, noisy_input, ecc, errloc, &nflip);
+
+    // [비트 플리핑] 에러 위치 정정 수행
+    if (count >= 0) fe_bch_correct(noisy_input, errloc, nflip);
+    return count;
+}
+
+/* =================================================================
+ * [1:N] 신드롬 분해 단계
+ * ================================================================= */
+
+void fe_bch_ecc_syndromes(const struct bch_control *ctx, struct bch_workspace *ws,
+                          const uint8_t *ecc, unsigned int *syn) {
+    if (!ctx || !ws) return;
+    bch_ecc_syndromes(ctx, ws, ecc, syn);
+}
+
+int fe_bch_locator_degree(const struct bch_control *ctx, struct bch_workspace *ws,
+                          const unsigned int *syn, int max_deg) {
+    if (!ctx || !ws || max_deg < 0) return -1;
+    return bch_locator_degree(ctx, ws, syn, (unsigned int)max_deg);
+}
+
+int fe_bch_locate_syn(const struct bch_control *ctx, struct bch_workspace *ws,
+                      const unsigned int *syn, unsigned int *errloc, size_t *nflip) {
+    if (!ctx || !ws || !errloc || !nflip) return -1;
+
+    int count = decode_bch_ws(ctx, ws, NULL, FE_DATA_BYTES, NULL, NULL, syn, errloc);
+    *nflip = (count > 0) ? fe_bch_compact(errloc, count) : 0;
+    return count;
+}
+
+int fe_bch_decode_syn(const struct bch_control *ctx, struct bch_workspace *ws,
+                      uint8_t *noisy_input, const unsigned int *syn) {
+    unsigned int errloc[SYS_T];
+    size_t nflip;
+    int count = fe_bch_locate_syn(ctx, ws, syn, errloc, &nflip);
+    if (count >= 0) fe_bch_correct(noisy_input, errloc, nflip);
+    return count;
+}
+
+/* =================================================================
+ * [Bitsliced] 64건 배치 디코더
+ * ================================================================= */
+
+struct bch_bs64 *fe_bch_bs64_create(const struct bch_control *ctx, unsigned int width) {
+    if (!ctx) return NULL;
+    return bch_bs64_create(ctx, FE_DATA_BYTES, width);
+}
+
+void fe_bch_bs64_destroy(struct bch_bs64 *bs) {
+    if (bs) bch_bs64_free(bs);
+}
+
+struct bch_bs64_ws *fe_bch_bs64_ws_create(const struct bch_bs64 *bs) {
+    if (!bs) return NULL;
+    return bch_bs64_alloc_workspace(bs);
+}
+
+void fe_bch_bs64_ws_destroy(struct bch_bs64_ws *ws) {
+    if (ws) bch_bs64_free_workspace(ws);
+}
+
+int fe_bch_decode_bs64(const struct bch_bs64 *bs, struct bch_bs64_ws *ws, size_t n,
+                       const uint8_t *inputs, const uint8_t *ecc, size_t ecc_stride,
+                       uint8_t *corr, int *nerr) {
+    if (!bs || !ws || n == 0 || n > BCH_BS64_LANES || ecc_stride < FE_ECC_BYTES) return -1;
+    return decode_bch_bs64(bs, ws, (unsigned int)n, inputs, FE_DATA_BYTES,
+                           ecc, ecc_stride, corr, nerr);
+}
+
+struct bch_ct *fe_bch_ct_create(const struct bch_control *ctx, unsigned int width) {
+    if (!ctx) return NULL;
+    return bch_ct_create(ctx, FE_DATA_BYTES, width);
+}
+
+void fe_bch_ct_destroy(struct bch_ct *ct) {
+    if (ct) bch_ct_free(ct);
+}
+
+struct bch_ct_ws *fe_bch_ct_ws_create(const struct bch_ct *ct) {
+    if (!ct) return NULL;
+    return bch_ct_alloc_workspace(ct);
+}
+
+void fe_bch_ct_ws_destroy(struct bch_ct_ws *ws) {
+    if (ws) bch_ct_free_workspace(ws);
+}
+
+int fe_bch_decode_ct(const struct bch_ct *ct, struct bch_ct_ws *ws,
+                     const uint8_t *input, const uint8_t *ecc, uint8_t *errvec) {
+    if (!ct || !ws) return -1;
+    return decode_bch_ct(ct, ws, input, ecc, errvec);
+}
+
+/* =================================================================
+ * [Legacy API] 공용 인스턴스 사용
+ * ================================================================= */
+
 int fe_bch_init(void) {
-    // 정의된 상수를 사용하여 초기화
-    bch = init_bch(GFBITS, SYS_T, 0);
+    // 이미 초기화된 경우 테이블을 다시 만들지 않음 (중복 호출 안전)
+    if (bch) return 0;
+    bch = fe_bch_create(NULL);
     if (!bch) return -1;
     return 0;
 }
 
 void fe_bch_free(void) {
     if (bch) {
-        free_bch(bch);
+        fe_bch_destroy(bch);
         bch = NULL;
     }
 }
 
 void fe_encode(const uint8_t *input, uint8_t *ecc) {
     if (!bch) return;
-    
-    // 라이브러리에 순수 데이터(FE_DATA_BYTES)만 넘기면 
-    // 내부적으로 Shortening(Zero-Padding)을 처리하여 ECC 생성
-    memset(ecc, 0, bch->ecc_bytes);
-    encode_bch(bch, input, FE_DATA_BYTES, ecc);
+    fe_bch_encode(bch, bch->ws, input, ecc);
 }
 
 int fe_decode(uint8_t *noisy_input, const uint8_t *ecc) {
     if (!bch) return -1;
+    return fe_bch_decode(bch, bch->ws, noisy_input, ecc);
+}
 
-    unsigned int errloc[SYS_T]; 
-    // 디코딩 수행
-    int count = decode_bch(bch, noisy_input, FE_DATA_BYTES, ecc, NULL, NULL, errloc);
-
-    if (count >= 0) {
-        // [비트 플리핑] 에러 위치 정정 수행
-        for (int i = 0; i < count; i++) {
-            unsigned int idx = errloc[i];
-            if (idx < FE_DATA_BYTES * 8) {
-                noisy_input[idx / 8] ^= (1 << (idx % 8));
-            }
-        }
-    }
-    return count;
-}
\ No newline at end of file
+int fe_locate(const uint8_t *input, const uint8_t *ecc, unsigned int *errloc, size_t *nflip) {
+    if (!bch) return -1;
+    return fe_bch_locate(bch, bch->ws, input, ecc, errloc, nflip);
+}
@@ -2,6 +2,7 @@
 #define BCH_WRAPPER_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /* =================================================================
  * [Configuration] 순수 입력 데이터 3488비트 확보 설정
@@ -37,6 +38,10 @@
 #define FE_DATA_BYTES   ((PK_NCOLS + 7) / 8)    // 436 Bytes (3488 bits)
 #define FE_TOTAL_BYTES  ((SYS_N_BITS + 7) / 8)  // 540 Bytes
 
+/* Helper Data = ECC || KDF salt (등록마다 새 salt) */
+#define FE_SALT_BYTES   32
+#define FE_HELPER_BYTES (FE_ECC_BYTES + FE_SALT_BYTES)  // 136 Bytes
+
 /* 라이브러리 내부 버퍼 크기 (m=13일 때 넉넉하게 잡음) */
 #define BCH_TOTAL_BYTES 2048
 
@@ -45,9 +50,85 @@
  * [API Declarations]
  * ================================================================= */
 
+struct bch_control;
+struct bch_workspace;
+struct bch_config;
+
+/* 인스턴스 단위 API: 테이블을 한 번 만들고 여러 번 재사용
+ * - bch_control  : 읽기 전용 테이블, 여러 스레드가 공유
+ * - bch_workspace: 호출 중 가변 버퍼, 동시에 실행되는 호출마다 별도 */
+struct bch_control *fe_bch_create(const struct bch_config *cfg);  // cfg == NULL: 기본값
+/* 미리 만든 테이블 이미지(fe_tables.h)로 생성: image는 destroy 이후까지 유지 */
+struct bch_control *fe_bch_create_image(const struct bch_config *cfg, const void *image, size_t size);
+void fe_bch_destroy(struct bch_control *ctx);
+struct bch_workspace *fe_bch_ws_create(const struct bch_control *ctx);
+void fe_bch_ws_destroy(struct bch_workspace *ws);
+void fe_bch_encode(const struct bch_control *ctx, struct bch_workspace *ws,
+                   const uint8_t *input, uint8_t *ecc);
+int fe_bch_decode(const struct bch_control *ctx, struct bch_workspace *ws,
+                  uint8_t *noisy_input, const uint8_t *ecc);
+
+/* 조각 단위 인코딩: ecc(FE_ECC_BYTES)의 나머지에서 이어서 chunk를 인코딩
+ * ecc를 0으로 시작해 조각들을 순서대로 넘기면 전체를 fe_bch_encode한 것과 같음 */
+void fe_bch_encode_update(const struct bch_control *ctx, struct bch_workspace *ws,
+                          const uint8_t *chunk, size_t len, uint8_t *ecc);
+
+/* 정정 없이 오류 위치만: 입력은 읽기만 하고 정정은 호출자가 가상으로 적용
+ * - errloc[SYS_T]: 앞쪽 *nflip개가 데이터 영역 비트 위치 (byte * 8 + bit), ECC 영역 오류는 제외
+ * - 반환: fe_bch_decode와 같음 (ECC 영역 포함 오류 수, 실패 시 음수) */
+int fe_bch_locate(const struct bch_control *ctx, struct bch_workspace *ws,
+                  const uint8_t *input, const uint8_t *ecc,
+                  unsigned int *errloc, size_t *nflip);
+
+/* 1:N 매칭: 신드롬이 나머지에 대해 선형인 것을 이용한 분해 단계
+ * - fe_bch_ecc_syndromes : ecc(FE_ECC_BYTES)의 신드롬 syn[2 * SYS_T]
+ *   probe의 encode 결과와 저장된 helper의 신드롬을 xor하면 (probe || helper)의 신드롬
+ * - fe_bch_locator_degree: 오류 위치 다항식 차수 (max_deg 초과 시 즉시 음수)
+ * - fe_bch_decode_syn    : 신드롬으로 디코딩 후 noisy_input 정정 (fe_bch_decode와 같은 반환)
+ * - fe_bch_locate_syn    : 신드롬으로 오류 위치만 (fe_bch_locate와 같은 출력) */
+void fe_bch_ecc_syndromes(const struct bch_control *ctx, struct bch_workspace *ws,
+                          const uint8_t *ecc, unsigned int *syn);
+int fe_bch_locator_degree(const struct bch_control *ctx, struct bch_workspace *ws,
+                          const unsigned int *syn, int max_deg);
+int fe_bch_decode_syn(const struct bch_control *ctx, struct bch_workspace *ws,
+                      uint8_t *noisy_input, const unsigned int *syn);
+int fe_bch_locate_syn(const struct bch_control *ctx, struct bch_workspace *ws,
+                      const unsigned int *syn, unsigned int *errloc, size_t *nflip);
+
+/* bitsliced 배치 디코더: 최대 64건을 한 번에 정정 (작업량이 에러 수와 무관)
+ * - width: Chien 병렬 구간 수 (0 = CPU별 자동, 1 / 4 / 8)
+ * - inputs / ecc: FE_DATA_BYTES / ecc_stride 간격, 입력은 수정하지 않음
+ * - corr: n * FE_DATA_BYTES, nerr[k]: 정정 비트 수 또는 음수 (실패) */
+struct bch_bs64;
+struct bch_bs64_ws;
+
+struct bch_bs64 *fe_bch_bs64_create(const struct bch_control *ctx, unsigned int width);
+void fe_bch_bs64_destroy(struct bch_bs64 *bs);
+struct bch_bs64_ws *fe_bch_bs64_ws_create(const struct bch_bs64 *bs);
+void fe_bch_bs64_ws_destroy(struct bch_bs64_ws *ws);
+int fe_bch_decode_bs64(const struct bch_bs64 *bs, struct bch_bs64_ws *ws, size_t n,
+                       const uint8_t *inputs, const uint8_t *ecc, size_t ecc_stride,
+                       uint8_t *corr, int *nerr);
+
+/* 상수 시간 단일 디코더: 수행 시간이 에러 수 / 데이터와 무관 (SCA 대응 reproduce)
+ * - width: Chien 병렬 구간 수 (bitsliced와 같음, 0 = CPU별 자동)
+ * - errvec: FE_DATA_BYTES 오류 벡터 (정정 = input ^ errvec), 실패해도 같은 시간에 채움
+ * - 반환: ECC 영역 포함 오류 수, 실패 시 음수 */
+struct bch_ct;
+struct bch_ct_ws;
+
+struct bch_ct *fe_bch_ct_create(const struct bch_control *ctx, unsigned int width);
+void fe_bch_ct_destroy(struct bch_ct *ct);
+struct bch_ct_ws *fe_bch_ct_ws_create(const struct bch_ct *ct);
+void fe_bch_ct_ws_destroy(struct bch_ct_ws *ws);
+int fe_bch_decode_ct(const struct bch_ct *ct, struct bch_ct_ws *ws,
+                     const uint8_t *input, const uint8_t *ecc, uint8_t *errvec);
+
+/* 레거시 API: 내부 공용 인스턴스 사용 */
 int fe_bch_init(void);
 void fe_bch_free(void);
 void fe_encode(const uint8_t *input, uint8_t *ecc);
-int fe_decode(uint8_t *noisy_input, const uint8_t *ecc);
+int fe_decode(uint8_t *noisy_input, const uint8_t *ecc);     // noisy_input을 제자리 정정
+int fe_locate(const uint8_t *input, const uint8_t *ecc, unsigned int *errloc, size_t *nflip);
 
 #endif // BCH_WRAPPER_H
\ No newline at end of file
@@ -1,12 +1,69 @@
 #include "fe_api.h"
 #include "fe_core.h"
 #include "bch_wrapper.h"
+#include "fe_thread.h"
+#include "fe_kdf.h"
+#include "../lib/bch.h"
 #include <string.h>
 
+// 컨텍스트 없이 호출되는 레거시 API용 공용 컨텍스트 (최초 호출 시 생성)
+static fe_ctx *g_default_ctx = NULL;
+static fe_once_t g_default_once = FE_ONCE_INIT;
+
+static void fe_default_ctx_init(void) {
+    g_default_ctx = FE_Ctx_Create(NULL);
+}
+
+static fe_ctx *fe_default_ctx(void) {
+    // 여러 스레드가 동시에 첫 호출을 해도 1회만 생성
+    fe_once(&g_default_once, fe_default_ctx_init);
+    return g_default_ctx;
+}
+
+/* =================================================================
+ * (0) Context 관리
+ * ================================================================= */
+void fe_ctx_params_default(fe_ctx_params *params) {
+    if (!params) return;
+    memset(params, 0, sizeof(*params));
+    params->num_threads = 1;
+    params->pin_threads = 0;
+    params->root_finder = FE_ROOTS_AUTO;
+    params->encoder = FE_ENC_AUTO;
+    params->slice_bytes = 4;
+    params->kernel = FE_KERNEL_AUTO;
+    params->decoder = FE_DEC_SCALAR;
+    params->bs_width = 0;
+    params->reject = FE_REJECT_EARLY;
+    params->kdf_lanes = 0;
+    params->tables_path = NULL;
+}
+
+fe_ctx *fe_ctx_create(void) {
+    return FE_Ctx_Create(NULL);
+}
+
+fe_ctx *fe_ctx_create_ex(const fe_ctx_params *params) {
+    return FE_Ctx_Create(params);
+}
+
+void fe_ctx_destroy(fe_ctx *ctx) {
+    FE_Ctx_Destroy(ctx);
+}
+
+int fe_ctx_tables_mapped(const fe_ctx *ctx) {
+    return (ctx && ctx->tables) ? 1 : 0;
+}
+
+size_t fe_ctx_table_bytes(const fe_ctx_params *params) {
+    return FE_Ctx_Table_Bytes(params);
+}
+
 /* =================================================================
  * (1) Enrollment 구현
  * ================================================================= */
-int fe_enroll(
+int fe_enroll_ctx(
+    fe_ctx *ctx,
     const uint8_t *input,
     size_t input_len,
     uint8_t *helper_data,
@@ -15,7 +72,7 @@ int fe_enroll(
     size_t *key_len
 ) {
     // 1. 파라미터 유효성 검사
-    if (!input || !helper_data || !helper_len || !secret_key || !key_len) {
+    if (!ctx || !input || !helper_data || !helper_len || !secret_key || !key_len) {
         return FE_FAIL_PARAM;
     }
 
@@ -24,30 +81,111 @@ int fe_enroll(
         return FE_FAIL_PARAM;
     }
 
-    // 초기화 (최초 1회 필요, 중복 호출 안전)
-    if (FE_Init() < 0) return FE_FAIL_PARAM;
-
     FE_Key key_struct;
 
     // 2. Core 엔진 호출 (Gen)
-    // 내부적으로 Helper Data와 Key를 생성함
-    FE_Gen(input, helper_data, &key_struct);
+    // 내부적으로 Helper Data(ECC || salt)와 Key를 생성함 (salt 난수 실패 시 오류)
+    if (FE_Gen_Ctx(ctx, input, helper_data, &key_struct) < 0) {
+        return FE_FAIL_PARAM;
+    }
 
     // 3. 결과 전달
     // 생성된 키를 사용자가 제공한 버퍼로 복사
     memcpy(secret_key, key_struct.key, FE_KEY_LEN);
 
     // 실제 출력된 길이 정보 갱신
-    *helper_len = FE_ECC_BYTES;
+    *helper_len = FE_HELPER_BYTES;
     *key_len = FE_KEY_LEN;
 
     return FE_SUCCESS;
 }
 
+/* =================================================================
+ * (1-2) Streaming Enrollment 구현
+ * ================================================================= */
+
+// 공개 상태의 opaque 영역에 코어 상태를 그대로 둠
+typedef char fe_enroll_stream_fits[(sizeof(FE_Gen_Stream) <= sizeof(fe_enroll_stream)) ? 1 : -1];
+
+static FE_Gen_Stream *fe_stream_state(fe_enroll_stream *stream) {
+    return (FE_Gen_Stream *)(void *)stream->opaque;
+}
+
+int fe_enroll_stream_init(fe_ctx *ctx, fe_enroll_stream *stream) {
+    if (!ctx || !stream) return FE_FAIL_PARAM;
+    memset(stream, 0, sizeof(*stream));
+
+    // 조각마다 할당하지 않도록 작업 공간은 final / abort까지 보관
+    struct bch_workspace *ws = fe_bch_ws_create(ctx->bch);
+    if (!ws) return FE_FAIL_PARAM;
+    if (FE_Gen_Stream_Init(ctx, ws, fe_stream_state(stream)) < 0) {
+        fe_bch_ws_destroy(ws);
+        return FE_FAIL_PARAM;
+    }
+    return FE_SUCCESS;
+}
+
+int fe_enroll_stream_update(fe_enroll_stream *stream, const uint8_t *chunk, size_t chunk_len) {
+    if (!stream) return FE_FAIL_PARAM;
+    if (FE_Gen_Stream_Update(fe_stream_state(stream), chunk, chunk_len) < 0) return FE_FAIL_PARAM;
+    return FE_SUCCESS;
+}
+
+int fe_enroll_stream_final(
+    fe_enroll_stream *stream,
+    uint8_t *helper_data,
+    size_t *helper_len,
+    uint8_t *secret_key,
+    size_t *key_len
+) {
+    FE_Key key_struct;
+    if (!stream) return FE_FAIL_PARAM;
+    FE_Gen_Stream *st = fe_stream_state(stream);
+    if (!st->ctx) return FE_FAIL_PARAM;
+
+    // Final이 상태를 지우므로 작업 공간은 먼저 꺼내 둠
+    struct bch_workspace *ws = st->ws;
+    int ret = FE_FAIL_PARAM;
+    if (helper_data && helper_len && secret_key && key_len &&
+        FE_Gen_Stream_Final(st, helper_data, &key_struct) == 0) {
+        memcpy(secret_key, key_struct.key, FE_KEY_LEN);
+        *helper_len = FE_HELPER_BYTES;
+        *key_len = FE_KEY_LEN;
+        ret = FE_SUCCESS;
+    }
+    fe_bch_ws_destroy(ws);
+    memset(stream, 0, sizeof(*stream));
+    return ret;
+}
+
+void fe_enroll_stream_abort(fe_enroll_stream *stream) {
+    if (!stream) return;
+    FE_Gen_Stream *st = fe_stream_state(stream);
+    fe_bch_ws_destroy(st->ws);
+    // 해시 상태에 입력이 섞여 있으므로 지움
+    memset(stream, 0, sizeof(*stream));
+}
+
+int fe_enroll(
+    const uint8_t *input,
+    size_t input_len,
+    uint8_t *helper_data,
+    size_t *helper_len,
+    uint8_t *secret_key,
+    size_t *key_len
+) {
+    // 공용 컨텍스트 초기화 (최초 1회만 테이블 생성)
+    fe_ctx *ctx = fe_default_ctx();
+    if (!ctx) return FE_FAIL_PARAM;
+
+    return fe_enroll_ctx(ctx, input, input_len, helper_data, helper_len, secret_key, key_len);
+}
+
 /* =================================================================
  * (2) Reproduction 구현 (SCA 측정 대상)
  * ================================================================= */
-int fe_reproduce(
+int fe_reproduce_ctx(
+    fe_ctx *ctx,
     const uint8_t *input,
     size_t input_len,
     const uint8_t *helper_data,
@@ -56,23 +194,20 @@ int fe_reproduce(
     size_t *key_len
 ) {
     // 1. 파라미터 유효성 검사
-    if (!input || !helper_data || !recovered_key || !key_len) {
+    if (!ctx || !input || !helper_data || !recovered_key || !key_len) {
         return FE_FAIL_PARAM;
     }
 
     // 규격 검사
-    if (input_len != FE_DATA_BYTES || helper_len != FE_ECC_BYTES) {
+    if (input_len != FE_DATA_BYTES || helper_len != FE_HELPER_BYTES) {
         return FE_FAIL_PARAM;
     }
 
-    // 초기화
-    if (FE_Init() < 0) return FE_FAIL_PARAM;
-
     FE_Key key_struct;
 
     // 2. Core 엔진 호출 (Rep)
     // 이곳이 실행 시간 측정의 핵심 포인트
-    int ret = FE_Rep(input, (uint8_t *)helper_data, &key_struct);
+    int ret = FE_Rep_Ctx(ctx, input, helper_data, &key_struct);
 
     if (ret < 0) {
         // 복구 실패 (에러가 너무 많음)
@@ -84,4 +219,221 @@ int fe_reproduce(
     *key_len = FE_KEY_LEN;
 
     return FE_SUCCESS;
-}
\ No newline at end of file
+}
+
+int fe_reproduce(
+    const uint8_t *input,
+    size_t input_len,
+    const uint8_t *helper_data,
+    size_t helper_len,
+    uint8_t *recovered_key,
+    size_t *key_len
+) {
+    // 공용 컨텍스트 초기화 (최초 1회만 테이블 생성)
+    fe_ctx *ctx = fe_default_ctx();
+    if (!ctx) return FE_FAIL_PARAM;
+
+    return fe_reproduce_ctx(ctx, input, input_len, helper_data, helper_len, recovered_key, key_len);
+}
+
+/* =================================================================
+ * [Batch 공통] 워커가 처리할 항목 구간 [begin, end)
+ * ================================================================= */
+typedef struct {
+    fe_ctx *ctx;
+    struct bch_workspace **ws;   // 워커 인덱스별 작업 공간
+    struct bch_bs64_ws **bs_ws;  // 워커 인덱스별 bitsliced 작업 공간 (decoder == BITSLICED)
+    struct bch_ct_ws **ct_ws;    // 워커 인덱스별 상수 시간 작업 공간 (decoder == CONSTTIME)
+    const uint8_t *inputs;
+    const uint8_t *helpers;
+    uint8_t *helpers_out;
+    uint8_t *keys_out;
+    int *status_out;
+    const uint8_t *commits;      // 저장소 키 커밋 열 (NULL이면 대조 안 함)
+} fe_batch_job;
+
+// 복원한 키를 항목별 키 커밋과 대조 (저장소 배치, 잘못 정정된 키 거절).
+// 상수 시간 모드는 복호 실패 항목 (키 0)도 같은 대조를 거침
+static void batch_check_commits(fe_batch_job *job, size_t begin, size_t end) {
+    FE_Key key_struct;
+    if (!job->commits) return;
+    for (size_t i = begin; i < end; i++) {
+        int ok = (job->status_out[i] == FE_SUCCESS);
+        if (!ok && !job->ctx->ct) continue;
+        memcpy(key_struct.key, job->keys_out + i * FE_KEY_LEN, FE_KEY_LEN);
+        if (FE_Check_Commit(&key_struct, job->commits + i * FE_KEY_LEN) | !ok) {
+            memset(job->keys_out + i * FE_KEY_LEN, 0, FE_KEY_LEN);
+            job->status_out[i] = FE_FAIL_DECODE;
+        }
+    }
+    memset(&key_struct, 0, sizeof(key_struct));
+}
+
+// 키 유도는 FE_SHA3_MAX_LANES건씩 multi-buffer로 (FE_Gen_Batch / FE_Rep_Batch)
+static void batch_enroll_range(void *arg, int worker, size_t begin, size_t end) {
+    fe_batch_job *job = (fe_batch_job *)arg;
+    if (FE_Gen_Batch(job->ctx, job->ws[worker], end - begin, job->inputs + begin * FE_DATA_BYTES,
+                     job->helpers_out + begin * FE_HELPER_BYTES, job->keys_out + begin * FE_KEY_LEN,
+                     job->status_out + begin) < 0) {
+        for (size_t i = begin; i < end; i++) job->status_out[i] = FE_FAIL_PARAM;
+    }
+}
+
+static void batch_reproduce_range(void *arg, int worker, size_t begin, size_t end) {
+    fe_batch_job *job = (fe_batch_job *)arg;
+    if (FE_Rep_Batch(job->ctx, job->ws[worker], end - begin, job->inputs + begin * FE_DATA_BYTES,
+                     job->helpers + begin * FE_HELPER_BYTES, job->keys_out + begin * FE_KEY_LEN,
+                     job->status_out + begin) < 0) {
+        for (size_t i = begin; i < end; i++) job->status_out[i] = FE_FAIL_PARAM;
+    }
+    batch_check_commits(job, begin, end);
+}
+
+// bitsliced: 최대 64건씩 한 번에 정정
+static void batch_reproduce_bs64_range(void *arg, int worker, size_t begin, size_t end) {
+    fe_batch_job *job = (fe_batch_job *)arg;
+    for (size_t i = begin; i < end; i += BCH_BS64_LANES) {
+        size_t cnt = (end - i < BCH_BS64_LANES) ? end - i : BCH_BS64_LANES;
+        if (FE_Rep_Bs64(job->ctx, job->bs_ws[worker], cnt, job->inputs + i * FE_DATA_BYTES,
+                        job->helpers + i * FE_HELPER_BYTES, job->keys_out + i * FE_KEY_LEN,
+                        job->status_out + i) < 0) {
+            for (size_t k = i; k < i + cnt; k++) job->status_out[k] = FE_FAIL_PARAM;
+        }
+    }
+    batch_check_commits(job, begin, end);
+}
+
+// 상수 시간: 항목마다 같은 작업량 (키 유도도 항목별 단건 경로)
+static void batch_reproduce_ct_range(void *arg, int worker, size_t begin, size_t end) {
+    fe_batch_job *job = (fe_batch_job *)arg;
+    FE_Key key_struct;
+    for (size_t i = begin; i < end; i++) {
+        if (FE_Rep_Ct(job->ctx, job->ct_ws[worker], job->inputs + i * FE_DATA_BYTES,
+                      job->helpers + i * FE_HELPER_BYTES, &key_struct) < 0) {
+            memset(job->keys_out + i * FE_KEY_LEN, 0, FE_KEY_LEN);
+            job->status_out[i] = FE_FAIL_DECODE;
+            continue;
+        }
+        memcpy(job->keys_out + i * FE_KEY_LEN, key_struct.key, FE_KEY_LEN);
+        job->status_out[i] = FE_SUCCESS;
+    }
+    memset(&key_struct, 0, sizeof(key_struct));
+    batch_check_commits(job, begin, end);
+}
+
+// 풀이 있으면 work-stealing 병렬 실행, 없으면 호출 스레드에서 순차 실행
+static int batch_run(fe_batch_job *job, size_t n, size_t grain, fe_pool_job_fn fn) {
+    fe_ctx *ctx = job->ctx;
+    struct bch_workspace *local_ws = NULL;
+    struct bch_bs64_ws *local_bs_ws = NULL;
+    struct bch_ct_ws *local_ct_ws = NULL;
+
+    if (ctx->pool) {
+        job->ws = ctx->ws;
+        job->bs_ws = ctx->bs_ws;
+        job->ct_ws = ctx->ct_ws;
+        fe_pool_run(ctx->pool, n, grain, fn, job);
+    } else {
+        // 작업 공간을 배치 전체에서 재사용
+        local_ws = fe_bch_ws_create(ctx->bch);
+        int need_bs = (fn == batch_reproduce_bs64_range);
+        int need_ct = (fn == batch_reproduce_ct_range);
+        if (need_bs) local_bs_ws = fe_bch_bs64_ws_create(ctx->bs);
+        if (need_ct) local_ct_ws = fe_bch_ct_ws_create(ctx->ct);
+        if (!local_ws || (need_bs && !local_bs_ws) || (need_ct && !local_ct_ws)) {
+            fe_bch_ws_destroy(local_ws);
+            fe_bch_bs64_ws_destroy(local_bs_ws);
+            fe_bch_ct_ws_destroy(local_ct_ws);
+            return FE_FAIL_PARAM;
+        }
+        job->ws = &local_ws;
+        job->bs_ws = &local_bs_ws;
+        job->ct_ws = &local_ct_ws;
+        fn(job, 0, 0, n);
+        fe_bch_ws_destroy(local_ws);
+        fe_bch_bs64_ws_destroy(local_bs_ws);
+        fe_bch_ct_ws_destroy(local_ct_ws);
+    }
+
+    int success = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (job->status_out[i] == FE_SUCCESS) success++;
+    }
+    return success;
+}
+
+/* =================================================================
+ * (3) Batch Enrollment 구현
+ * ================================================================= */
+int fe_enroll_batch(
+    fe_ctx *ctx,
+    const uint8_t *inputs,
+    size_t n,
+    uint8_t *helpers_out,
+    uint8_t *keys_out,
+    int *status_out
+) {
+    // 1. 파라미터 유효성 검사 (배치당 1회)
+    if (!ctx || !inputs || !helpers_out || !keys_out || !status_out) {
+        return FE_FAIL_PARAM;
+    }
+
+    // 2. 항목 처리 (인코딩은 가벼우므로 키 유도 묶음 단위로 분배)
+    fe_batch_job job = { ctx, NULL, NULL, NULL, inputs, NULL, helpers_out, keys_out, status_out, NULL };
+    return batch_run(&job, n, FE_SHA3_MAX_LANES, batch_enroll_range);
+}
+
+/* =================================================================
+ * (4) Batch Reproduction 구현
+ * ================================================================= */
+int fe_reproduce_batch(
+    fe_ctx *ctx,
+    const uint8_t *inputs,
+    const uint8_t *helpers,
+    size_t n,
+    uint8_t *keys_out,
+    int *status_out
+) {
+    // 1. 파라미터 유효성 검사 (배치당 1회)
+    if (!ctx || !inputs || !helpers || !keys_out || !status_out) {
+        return FE_FAIL_PARAM;
+    }
+
+    fe_batch_job job = { ctx, NULL, NULL, NULL, inputs, helpers, NULL, keys_out, status_out, NULL };
+
+    // 2-1. bitsliced: 64건이 한 단위 (비용이 일정하므로 블록 단위로 분배)
+    if (ctx->bs) return batch_run(&job, n, BCH_BS64_LANES, batch_reproduce_bs64_range);
+    if (ctx->ct) return batch_run(&job, n, 1, batch_reproduce_ct_range);
+
+    // 2-2. 항목 처리 (디코딩 비용 편차가 크므로 키 유도 lane 수만큼만 묶어 분배)
+    return batch_run(&job, n, fe_sha3_lanes((unsigned int)ctx->params.kdf_lanes), batch_reproduce_range);
+}
+
+/* =================================================================
+ * (4-1) 저장소 Batch Reproduction 구현
+ * ================================================================= */
+int fe_reproduce_batch_store(
+    fe_ctx *ctx,
+    const fe_store *store,
+    size_t first,
+    const uint8_t *inputs,
+    size_t n,
+    uint8_t *keys_out,
+    int *status_out
+) {
+    // 1. 파라미터 유효성 검사 (항목 범위가 저장소 안이어야 함)
+    size_t count = fe_store_count(store);
+    if (!ctx || !store || !inputs || !keys_out || !status_out) {
+        return FE_FAIL_PARAM;
+    }
+    if (first > count || n > count - first) {
+        return FE_FAIL_PARAM;
+    }
+
+    // 2. helper / 커밋 열은 매핑 안의 위치를 그대로 넘김 (복사 없음)
+    fe_batch_job job = { ctx, NULL, NULL, NULL, inputs, fe_store_helpers(store) + first * FE_HELPER_BYTES,
+                         NULL, keys_out, status_out, fe_store_commits(store) + first * FE_KEY_LEN };
+    if (ctx->bs) return batch_run(&job, n, BCH_BS64_LANES, batch_reproduce_bs64_range);
+    if (ctx->ct) return batch_run(&job, n, 1, batch_reproduce_ct_range);
+    return batch_run(&job, n, fe_sha3_lanes((unsigned int)ctx->params.kdf_lanes), batch_reproduce_range);
+}
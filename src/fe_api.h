@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdio.h>
 
 /* =================================================================
  * [상태 코드 정의]
@@ -11,13 +12,97 @@
 #define FE_FAIL_DECODE  -1  // 복구 실패 (에러 과다)
 #define FE_FAIL_PARAM   -2  // 입력 파라미터 오류 (길이 불일치 등)
 
+/* =================================================================
+ * [컨텍스트]
+ * BCH 테이블(GF log/antilog, 생성다항식, mod8_tab, deg2 base)을
+ * 생성 시 1회만 만들고 이후 enroll/reproduce 호출에서 재사용합니다.
+ * 생성 이후에는 읽기 전용이므로 하나의 컨텍스트를 여러 스레드에서
+ * 잠금 없이 동시에 사용할 수 있습니다.
+ * ================================================================= */
+typedef struct fe_ctx fe_ctx;
+
+/* 오류 위치 다항식 근 찾기 방식 (fe_ctx_params.root_finder) */
+#define FE_ROOTS_AUTO    0   // 다항식 차수별로 더 빠른 쪽 자동 선택
+#define FE_ROOTS_BTA     1   // Berlekamp trace 인수분해
+#define FE_ROOTS_CHIEN   2   // 유효 위치(4320개)만 검사하는 Chien search
+
+/* BCH 인코더 방식 (fe_ctx_params.encoder) */
+#define FE_ENC_AUTO      0   // CPU가 PCLMULQDQ를 지원하면 CLMUL, 아니면 테이블
+#define FE_ENC_TABLE     1   // slicing-by-N 테이블 (N = slice_bytes)
+#define FE_ENC_CLMUL     2   // carry-less multiply (미지원 CPU에서는 테이블)
+
+/* BCH 커널 (fe_ctx_params.kernel) */
+#define FE_KERNEL_AUTO     0   // m=13, t=64 상수 특화 커널
+#define FE_KERNEL_GENERIC  1   // 런타임 파라미터 범용 경로 (비교 측정용)
+
+/* 배치 reproduce 디코더 (fe_ctx_params.decoder) */
+#define FE_DEC_SCALAR      0   // 항목마다 decode_bch (에러 수에 비례하는 비용)
+#define FE_DEC_BITSLICED   1   // 64건씩 비트 평면으로 묶어 처리 (에러 수와 무관한 고정 비용)
+#define FE_DEC_CONSTTIME   2   // 항목마다 상수 시간 디코더 (단건 reproduce 포함, 수행 시간이 에러 수와 무관)
+
+/* 복구 실패(오류 > t) 판정 (fe_ctx_params.reject, scalar 디코더에만 적용) */
+#define FE_REJECT_EARLY    0   // 근 찾기 전에 오류 위치 다항식이 분해되는지 검사해 조기 실패
+#define FE_REJECT_FULL     1   // 근 찾기를 끝까지 수행한 뒤 근 개수로 판정 (비교 측정용)
+
+/* 컨텍스트 생성 옵션 (fe_ctx_params_default로 초기화 후 필요한 값만 변경) */
+typedef struct {
+    int num_threads;    // 배치 API 워커 수 (1 = 호출 스레드만, 0 = CPU 코어 수)
+    int pin_threads;    // 1이면 워커 스레드를 CPU 코어에 고정
+    int root_finder;    // FE_ROOTS_*
+    int encoder;        // FE_ENC_*
+    int slice_bytes;    // 테이블 인코더 1회 처리 바이트: 4, 8, 16 (0 = 4)
+    int kernel;         // FE_KERNEL_*
+    int decoder;        // FE_DEC_* (SCALAR / BITSLICED는 fe_reproduce_batch에만, CONSTTIME은 모든 reproduce)
+    int bs_width;       // bitsliced / 상수 시간 Chien 병렬 구간: 0 = 자동, 1 / 4(AVX2) / 8(AVX-512)
+    int reject;         // FE_REJECT_*
+    int kdf_lanes;      // 배치 키 유도 동시 처리 수: 0 = 자동, 1 / 4(AVX2) / 8(AVX-512)
+    const char *tables_path;    // 미리 만든 테이블 파일 (fe_tables write), NULL = 직접 계산
+} fe_ctx_params;
+
+/**
+ * @brief 생성 옵션 기본값 채우기
+ */
+void fe_ctx_params_default(fe_ctx_params *params);
+
+/**
+ * @brief 컨텍스트 생성 (실패 시 NULL, 기본 옵션)
+ */
+fe_ctx *fe_ctx_create(void);
+
+/**
+ * @brief 옵션을 지정한 컨텍스트 생성 (params == NULL이면 기본 옵션)
+ */
+fe_ctx *fe_ctx_create_ex(const fe_ctx_params *params);
+
+/**
+ * @brief 컨텍스트 해제 (NULL 허용)
+ */
+void fe_ctx_destroy(fe_ctx *ctx);
+
+/**
+ * @brief 컨텍스트가 테이블 파일을 매핑해서 쓰는지 (1), 직접 계산했는지 (0)
+ * tables_path의 파일이 없거나 버전 / 파라미터 / 인코더 / 체크섬이 맞지 않으면
+ * 생성은 실패하지 않고 테이블을 계산하므로, 시작 지연을 확인할 때 사용합니다.
+ */
+int fe_ctx_tables_mapped(const fe_ctx *ctx);
+
+/**
+ * @brief 해당 옵션으로 만들 컨텍스트의 BCH 테이블 메모리 (바이트, 상한)
+ * 컨텍스트를 만들지 않고 호스트별 slice_bytes를 고를 때 사용합니다.
+ * @return 0이면 잘못된 옵션 (params == NULL이면 기본 옵션)
+ */
+size_t fe_ctx_table_bytes(const fe_ctx_params *params);
+
 /* =================================================================
  * [API 함수 선언]
+ * 컨텍스트를 받지 않는 함수는 최초 호출 시 생성되는 공용 컨텍스트를 사용합니다.
  * ================================================================= */
 
 /**
  * @brief (1) Enrollment API
  * 입력 생체 데이터로부터 Helper Data와 Secret Key를 생성합니다.
+ * Helper Data는 FE_HELPER_BYTES(ECC || 등록별 salt)이며, 키는
+ * SHA3-256(salt || 입력)이므로 같은 입력도 등록마다 다른 키가 나옵니다.
  */
 int fe_enroll(
     const uint8_t *input,
@@ -31,6 +116,10 @@ int fe_enroll(
 /**
  * @brief (2) Reproduction API
  * 노이즈가 섞인 입력과 Helper Data를 이용해 Secret Key를 복원합니다.
+ * 입력은 수정하지도 복사하지도 않습니다: 오류 위치만 구한 뒤 해시 흡수 중에
+ * 해당 비트를 뒤집으므로, 같은 버퍼를 여러 스레드/호출이 공유해도 안전합니다.
+ * 컨텍스트의 decoder가 FE_DEC_CONSTTIME이면 (fe_reproduce_ctx) 디코딩과 키 유도의
+ * 작업량이 오류 수와 성공 여부에 관계없이 일정합니다.
  * SCA 분석 시, 이 함수의 실행 시간과 전력 소모를 측정합니다.
  */
 int fe_reproduce(
@@ -42,4 +131,402 @@ int fe_reproduce(
     size_t *key_len
 );
 
+/**
+ * @brief (1-1) Enrollment API (컨텍스트 지정)
+ */
+int fe_enroll_ctx(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    uint8_t *helper_data,
+    size_t *helper_len,
+    uint8_t *secret_key,
+    size_t *key_len
+);
+
+/**
+ * @brief (2-1) Reproduction API (컨텍스트 지정)
+ */
+int fe_reproduce_ctx(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    const uint8_t *helper_data,
+    size_t helper_len,
+    uint8_t *recovered_key,
+    size_t *key_len
+);
+
+/* =================================================================
+ * [스트리밍 Enrollment API]
+ * 템플릿을 조각 단위로 받는 캡처 장치용입니다. 조각이 도착할 때마다 BCH
+ * 나머지와 키 해시(SHA3-256(salt || 입력))를 이어서 갱신하므로 템플릿 전체를
+ * 모아 두지 않고 인코딩이 캡처와 겹칩니다. 결과는 fe_enroll_ctx와 같은 형식입니다.
+ *
+ *   fe_enroll_stream st;
+ *   fe_enroll_stream_init(ctx, &st);
+ *   while (조각 수신) fe_enroll_stream_update(&st, chunk, chunk_len);
+ *   fe_enroll_stream_final(&st, helper, &h_len, key, &k_len);
+ *
+ * 상태는 호출자 소유이며 스택에 둘 수 있습니다. init이 성공하면 final 또는
+ * abort로 반드시 끝내야 합니다 (작업 공간 해제, 상태 지움). 조각 길이는 자유이고
+ * 합계가 FE_DATA_BYTES(436)여야 합니다. 상태 하나를 여러 스레드가 동시에 쓰면 안 됩니다.
+ * ================================================================= */
+#define FE_ENROLL_STREAM_WORDS  64
+
+typedef struct {
+    uint64_t opaque[FE_ENROLL_STREAM_WORDS];    // 내부 상태 (직접 접근하지 않음)
+} fe_enroll_stream;
+
+/**
+ * @brief (1-2) 스트리밍 Enrollment 시작 (salt를 새로 뽑음)
+ */
+int fe_enroll_stream_init(fe_ctx *ctx, fe_enroll_stream *stream);
+
+/**
+ * @brief 입력 조각 추가
+ * @return 합계가 FE_DATA_BYTES를 넘으면 FE_FAIL_PARAM (상태는 그대로)
+ */
+int fe_enroll_stream_update(fe_enroll_stream *stream, const uint8_t *chunk, size_t chunk_len);
+
+/**
+ * @brief Helper Data / Secret Key 출력 후 상태 종료 (성공 여부와 관계없이 종료)
+ * @return 받은 입력 합계가 FE_DATA_BYTES가 아니면 FE_FAIL_PARAM
+ */
+int fe_enroll_stream_final(
+    fe_enroll_stream *stream,
+    uint8_t *helper_data,
+    size_t *helper_len,
+    uint8_t *secret_key,
+    size_t *key_len
+);
+
+/**
+ * @brief 결과 없이 상태 종료 (init 전이거나 이미 끝난 상태도 허용)
+ */
+void fe_enroll_stream_abort(fe_enroll_stream *stream);
+
+/* =================================================================
+ * [배치 API]
+ * 여러 건을 한 번의 호출로 처리합니다. 작업 공간 할당과 파라미터 검사를
+ * 배치당 1회로 줄이고, 같은 테이블을 연속 사용하여 캐시 적중률을 높입니다.
+ *
+ * 배열은 모두 연속 메모리이며 항목 간격은 다음과 같습니다.
+ *   inputs  : n * FE_DATA_BYTES (436)
+ *   helpers : n * FE_HELPER_BYTES (136, ECC || salt)
+ *   keys    : n * FE_KEY_LEN    (32)
+ *   status  : n (항목별 FE_SUCCESS / FE_FAIL_DECODE / FE_FAIL_PARAM)
+ *
+ * 키 유도(SHA3-256)는 여러 건을 SIMD lane에 나눠 실어 한 번에 계산합니다
+ * (kdf_lanes). 컨텍스트의 num_threads가 2 이상이면 항목을 워커들이 work-stealing
+ * 방식으로 나눠 처리합니다. decoder가 FE_DEC_BITSLICED이면 reproduce는
+ * 64건 단위로 묶어 분배하고, FE_DEC_CONSTTIME이면 항목마다 상수 시간 디코더를
+ * 씁니다. 같은 컨텍스트의 배치 호출은 순서대로 실행됩니다.
+ *
+ * 반환값: 성공한 항목 수, 인자 오류 시 FE_FAIL_PARAM
+ * ================================================================= */
+
+/**
+ * @brief (3) Batch Enrollment API
+ */
+int fe_enroll_batch(
+    fe_ctx *ctx,
+    const uint8_t *inputs,
+    size_t n,
+    uint8_t *helpers_out,
+    uint8_t *keys_out,
+    int *status_out
+);
+
+/**
+ * @brief (4) Batch Reproduction API
+ * 입력 배열은 수정하지 않습니다.
+ */
+int fe_reproduce_batch(
+    fe_ctx *ctx,
+    const uint8_t *inputs,
+    const uint8_t *helpers,
+    size_t n,
+    uint8_t *keys_out,
+    int *status_out
+);
+
+/* =================================================================
+ * [Helper 레코드] 버전이 있는 단건 저장 형식 (FE_RECORD_BYTES = 184)
+ * 헤더 16바이트(magic, 버전, m / t, 데이터 비트 수, ECC / salt / 커밋 길이) ||
+ * helper(ECC || salt) || 키 커밋. 바이트 단위로 정의되어 플랫폼 간에 그대로 옮길 수 있고,
+ * 키 커밋이 함께 있어 잘못 정정된 키(오류 > t)를 reproduce에서 거절합니다.
+ * ================================================================= */
+#define FE_RECORD_VERSION   1
+#define FE_RECORD_BYTES     184
+
+/**
+ * @brief helper / 키 커밋(fe_key_commit)을 레코드로 묶기
+ */
+int fe_record_pack(
+    const uint8_t *helper_data,
+    size_t helper_len,
+    const uint8_t *commit,
+    size_t commit_len,
+    uint8_t *record_out,
+    size_t *record_len
+);
+
+/**
+ * @brief 레코드 헤더 검사 후 helper / 키 커밋 위치 반환 (복사 없음, 출력 인자는 NULL 가능)
+ * @return 길이 / magic / 버전 / 파라미터가 이 빌드와 다르면 FE_FAIL_PARAM
+ */
+int fe_record_parse(
+    const uint8_t *record,
+    size_t record_len,
+    const uint8_t **helper_data,
+    const uint8_t **commit
+);
+
+/**
+ * @brief (1-3) Enrollment API (레코드 출력)
+ */
+int fe_enroll_record(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    uint8_t *record_out,
+    size_t *record_len,
+    uint8_t *secret_key,
+    size_t *key_len
+);
+
+/**
+ * @brief (2-2) Reproduction API (레코드 입력, 복원한 키를 키 커밋과 대조)
+ * @return 레코드 형식 오류는 FE_FAIL_PARAM, 복구 실패 / 커밋 불일치는 FE_FAIL_DECODE
+ */
+int fe_reproduce_record(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    const uint8_t *record,
+    size_t record_len,
+    uint8_t *recovered_key,
+    size_t *key_len
+);
+
+/* =================================================================
+ * [다중 블록] FE_DATA_BYTES보다 긴 템플릿 (8 ~ 32 kbit 홍채 / 얼굴 임베딩 등)
+ * 템플릿을 FE_DATA_BYTES 블록 n개로 나눠 블록마다 BCH ECC를 만들고, 키는 템플릿
+ * 전체에서 한 번 유도합니다: 키 = SHA3-256(salt || 정정된 템플릿).
+ * - 분할: 기본은 앞에서부터 436바이트씩, FE_MULTI_INTERLEAVE면 템플릿 바이트 i를
+ *   블록 i % n에 넣어 연속된 버스트 오류를 여러 블록에 나눔. 남는 자리는 0
+ * - 레코드 1개 = 헤더 16 || 블록별 ECC (n x 104) || salt 32 || 키 커밋 32.
+ *   바이트 단위 정의(플랫폼 무관)이며 템플릿 길이와 분할 방식을 함께 저장
+ * - reproduce는 블록을 동시에 복호: FE_DEC_BITSLICED면 모든 블록을 bitsliced 디코더
+ *   한 번(블록 = lane)에, 그 외에는 컨텍스트 워커(num_threads)가 블록을 나눠 복호.
+ *   FE_DEC_CONSTTIME이면 실패 여부와 관계없이 모든 블록과 키 유도를 수행
+ * - 블록 하나라도 복구에 실패하거나 키 커밋이 맞지 않으면 FE_FAIL_DECODE
+ * ================================================================= */
+#define FE_MULTI_MAX_BLOCKS 64      // 템플릿 최대 64 * 436 = 27904바이트
+#define FE_MULTI_INTERLEAVE 1       // flags: 바이트 단위 인터리브
+
+/**
+ * @brief 템플릿 길이별 블록 수 / 레코드 크기 (지원하지 않는 길이면 0)
+ */
+size_t fe_multi_blocks(size_t input_len);
+size_t fe_multi_record_bytes(size_t input_len);
+
+/**
+ * @brief (1-4) 다중 블록 Enrollment
+ * @param flags      0 또는 FE_MULTI_INTERLEAVE
+ * @param record_len 입력: record_out 버퍼 크기, 출력: 레코드 크기 (fe_multi_record_bytes)
+ */
+int fe_enroll_multi(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    int flags,
+    uint8_t *record_out,
+    size_t *record_len,
+    uint8_t *secret_key,
+    size_t *key_len
+);
+
+/**
+ * @brief (2-3) 다중 블록 Reproduction (입력은 수정하지 않음)
+ * @return 레코드 형식 오류 / 길이 불일치는 FE_FAIL_PARAM, 복구 실패 / 커밋 불일치는 FE_FAIL_DECODE
+ */
+int fe_reproduce_multi(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    const uint8_t *record,
+    size_t record_len,
+    uint8_t *recovered_key,
+    size_t *key_len
+);
+
+/* =================================================================
+ * [등록 저장소] 대량 등록용 열 단위 파일 (고정 간격, 64바이트 정렬, mmap)
+ * helper 열([n][136], ECC || salt), 키 커밋 열([n][32]), 갤러리 prescreen용
+ * helper 신드롬 열([n][64] uint16)을 각각 연속으로 저장합니다. 열기는 헤더만
+ * 검사하고 파일을 읽기 전용으로 매핑하며, 배치 reproduce와 갤러리는 항목을
+ * 파싱하거나 복사하지 않고 매핑된 열을 그대로 읽습니다.
+ * 파일은 만든 기계의 바이트 순서를 따릅니다 (옮길 때는 레코드 형식 사용).
+ * ================================================================= */
+typedef struct fe_store fe_store;
+
+/**
+ * @brief 레코드 count건(연속 배열, 간격 FE_RECORD_BYTES)으로 저장소 파일 작성
+ * 임시 파일에 다 쓴 뒤 교체하므로 이미 열린 저장소에는 영향이 없습니다.
+ */
+int fe_store_write(fe_ctx *ctx, const char *path, const uint8_t *records, size_t count);
+
+/**
+ * @brief 저장소 파일 열기 (없거나 형식이 맞지 않으면 NULL)
+ */
+fe_store *fe_store_open(const char *path);
+
+/**
+ * @brief 저장소 닫기 (NULL 허용, 이 저장소로 연 갤러리를 먼저 해제)
+ */
+void fe_store_close(fe_store *store);
+
+/**
+ * @brief 항목 수 / helper 열 시작 / 키 커밋 열 시작
+ */
+size_t fe_store_count(const fe_store *store);
+const uint8_t *fe_store_helpers(const fe_store *store);
+const uint8_t *fe_store_commits(const fe_store *store);
+
+/**
+ * @brief (4-1) 저장소 항목 [first, first + n)에 대한 Batch Reproduction
+ * inputs[i]는 항목 first + i의 probe입니다. helper는 매핑된 열에서 바로 읽고,
+ * 복원한 키를 키 커밋과 대조해 맞지 않으면 FE_FAIL_DECODE로 표시합니다.
+ */
+int fe_reproduce_batch_store(
+    fe_ctx *ctx,
+    const fe_store *store,
+    size_t first,
+    const uint8_t *inputs,
+    size_t n,
+    uint8_t *keys_out,
+    int *status_out
+);
+
+/* =================================================================
+ * [갤러리 API] 1:N 식별
+ * 등록된 helper와 키 커밋(키의 해시, 키 자체는 저장하지 않음)을 연속 배열로
+ * 보관하고, probe 하나를 모든 항목과 대조해 키가 복원되는 항목을 찾습니다.
+ *
+ * - 신드롬은 ECC 나머지에 대해 선형이므로 항목별 helper 신드롬을 등록 시
+ *   미리 계산해 두고, probe는 1회만 인코딩합니다. 항목마다 xor 한 번으로
+ *   (probe || helper)의 신드롬을 얻습니다.
+ * - prescreen: 오류 위치 다항식 차수가 max_errors를 넘으면 BM 도중 제외.
+ *   남은 신드롬 2(t - max_errors)개가 검사 역할을 하므로 타인 항목이 통과할
+ *   확률은 약 2^-(13 * (t - max_errors))이고, 통과한 후보만 근 찾기와
+ *   키 커밋 비교를 합니다.
+ * - 컨텍스트의 num_threads가 2 이상이면 워커들이 항목을 나눠 검사합니다.
+ * - 갤러리는 컨텍스트를 빌려 쓰므로 컨텍스트보다 먼저 해제해야 합니다.
+ *   등록(enroll/add)과 식별을 동시에 호출하지 않아야 합니다.
+ * ================================================================= */
+typedef struct fe_gallery fe_gallery;
+
+/* max_errors 기본값: t - 8 (오류 57~64개 probe는 거절, 후보 오탐 확률 ~2^-104) */
+#define FE_GALLERY_MAX_ERRORS   56
+
+/* 식별 결과 */
+typedef struct {
+    long index;         // 일치 항목 (여러 개면 가장 작은 인덱스), 없으면 -1
+    size_t matches;     // 키 커밋까지 일치한 항목 수
+    size_t scanned;     // 검사한 항목 수
+    size_t candidates;  // prescreen을 통과해 근 찾기까지 간 항목 수
+} fe_gallery_result;
+
+/**
+ * @brief 갤러리 생성
+ * @param capacity   초기 항목 수 (모자라면 자동으로 늘림)
+ * @param max_errors prescreen 차수 상한 1..64 (0 = FE_GALLERY_MAX_ERRORS)
+ */
+fe_gallery *fe_gallery_create(fe_ctx *ctx, size_t capacity, int max_errors);
+
+/**
+ * @brief 갤러리 해제 (NULL 허용)
+ */
+void fe_gallery_destroy(fe_gallery *gallery);
+
+/**
+ * @brief 등록된 항목 수
+ */
+size_t fe_gallery_count(const fe_gallery *gallery);
+
+/**
+ * @brief 입력을 enroll해 갤러리에 추가
+ * @param secret_key NULL 가능 (FE_KEY_LEN 바이트)
+ * @param index_out  NULL 가능
+ */
+int fe_gallery_enroll(
+    fe_gallery *gallery,
+    const uint8_t *input,
+    size_t input_len,
+    uint8_t *secret_key,
+    size_t *index_out
+);
+
+/**
+ * @brief 저장해 둔 helper / 키 커밋으로 항목 추가 (fe_key_commit 결과)
+ */
+int fe_gallery_add(
+    fe_gallery *gallery,
+    const uint8_t *helper_data,
+    size_t helper_len,
+    const uint8_t *commit,
+    size_t commit_len,
+    size_t *index_out
+);
+
+/**
+ * @brief 저장소를 갤러리로 열기 (항목은 매핑된 열을 그대로 사용, 복사 / 신드롬 계산 없음)
+ * 저장소는 갤러리보다 오래 유지해야 합니다. 이후 항목을 추가하면 그때 메모리로 복사합니다.
+ */
+fe_gallery *fe_gallery_open(fe_ctx *ctx, const fe_store *store, int max_errors);
+
+/**
+ * @brief 갤러리 전체를 저장소 파일로 저장 (fe_gallery_open으로 다시 열 수 있음)
+ */
+int fe_gallery_save(const fe_gallery *gallery, const char *path);
+
+/**
+ * @brief probe 하나를 모든 항목과 대조 (1:N)
+ * @param recovered_key NULL 가능, 일치 시 result->index 항목의 키
+ * @param result        NULL 가능
+ * @return 일치 시 FE_SUCCESS, 없으면 FE_FAIL_DECODE
+ * 입력은 수정하지 않습니다.
+ */
+int fe_gallery_identify(
+    fe_gallery *gallery,
+    const uint8_t *probe,
+    size_t probe_len,
+    uint8_t *recovered_key,
+    fe_gallery_result *result
+);
+
+/**
+ * @brief 키 커밋 (갤러리 저장용 키 해시, FE_KEY_LEN 바이트)
+ */
+void fe_key_commit(const uint8_t *secret_key, uint8_t *commit_out);
+
+/* =================================================================
+ * [계측] reproduce 단계별 사이클 / 오류 위치 다항식 차수 / 인수분해 깊이
+ * -DFE_STATS=ON 빌드에서만 수집합니다 (끄면 측정 코드가 빠짐).
+ * 프로세스 전역 누적값이며 모든 컨텍스트의 reproduce가 합쳐집니다.
+ * ================================================================= */
+
+/**
+ * @brief 누적 히스토그램을 CSV 형태로 출력
+ * @return FE_SUCCESS, 계측이 꺼진 빌드면 FE_FAIL_PARAM
+ */
+int fe_stats_dump(FILE *fp);
+
+/**
+ * @brief 누적값 초기화
+ */
+void fe_stats_reset(void);
+
 #endif // FE_API_H
\ No newline at end of file
@@ -1,16 +1,435 @@
 #include "fe_core.h"
+#include "fe_kdf.h"
+#include "fe_thread.h"
+#include "fe_stats.h"
+#include "../lib/bch.h"
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-// 간단한 해시 함수 (테스트용)
-static void simple_hash(const uint8_t *input, int len, uint8_t *out_key) {
-    memset(out_key, 0, FE_KEY_LEN);
-    for (int i = 0; i < len; i++) {
-        out_key[i % FE_KEY_LEN] ^= input[i];
-        out_key[i % FE_KEY_LEN] = (out_key[i % FE_KEY_LEN] << 1) | (out_key[i % FE_KEY_LEN] >> 7);
+// 키 = SHA3-256(salt || data)
+void FE_Derive_Key(const uint8_t *data, const uint8_t *salt, FE_Key *key_out) {
+    FE_Derive_Key_Flip(data, NULL, 0, salt, key_out);
+}
+
+// 키 = SHA3-256(salt || (data ^ 오류 벡터)), 정정본은 만들지 않고 흡수 중에 비트를 뒤집음
+void FE_Derive_Key_Flip(const uint8_t *data, const unsigned int *flip, size_t nflip,
+                        const uint8_t *salt, FE_Key *key_out) {
+    fe_sha3 h;
+    fe_sha3_init(&h);
+    fe_sha3_update(&h, salt, FE_SALT_BYTES);
+    fe_sha3_update_flip(&h, data, FE_DATA_BYTES, flip, nflip);
+    fe_sha3_final(&h, key_out->key);
+}
+
+// 키 = SHA3-256(salt || (data ^ errvec)), 오류 벡터 전체를 흡수 (상수 시간 경로)
+void FE_Derive_Key_Xor(const uint8_t *data, const uint8_t *errvec,
+                       const uint8_t *salt, FE_Key *key_out) {
+    fe_sha3 h;
+    fe_sha3_init(&h);
+    fe_sha3_update(&h, salt, FE_SALT_BYTES);
+    fe_sha3_update_xor(&h, data, errvec, FE_DATA_BYTES);
+    fe_sha3_final(&h, key_out->key);
+}
+
+// 같은 키 유도를 n건 한꺼번에 (SIMD lane마다 한 건)
+void FE_Derive_Keys(const FE_Ctx *ctx, size_t n, const uint8_t *const *data,
+                    const unsigned int *const *flip, const size_t *nflip,
+                    const uint8_t *const *salt, uint8_t *const *key_out) {
+    fe_sha3_256_multi_flip((unsigned int)ctx->params.kdf_lanes, n,
+                           salt, FE_SALT_BYTES, data, FE_DATA_BYTES, flip, nflip, key_out);
+}
+
+void FE_Commit_Key(const FE_Key *key, uint8_t *commit_out) {
+    uint8_t buf[FE_KEY_LEN + 1];
+    memcpy(buf, key->key, FE_KEY_LEN);
+    buf[FE_KEY_LEN] = 0xC0;   // 키 유도와 구분하는 도메인 바이트
+    fe_sha3_256(buf, FE_KEY_LEN + 1, commit_out);
+}
+
+int FE_Check_Commit(const FE_Key *key, const uint8_t *commit) {
+    uint8_t check[FE_KEY_LEN], diff = 0;
+    FE_Commit_Key(key, check);
+    for (size_t i = 0; i < FE_KEY_LEN; i++) diff |= check[i] ^ commit[i];
+    return (diff + 0xff) >> 8;
+}
+
+/* =================================================================
+ * [Context] BCH 테이블을 컨텍스트 수명 동안 유지
+ * ================================================================= */
+
+// 공개 생성 옵션 -> BCH 라이브러리 옵션
+static void fe_params_to_bch(const fe_ctx_params *params, struct bch_config *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    switch (params->root_finder) {
+    case FE_ROOTS_BTA:   cfg->root_finder = BCH_ROOTS_BTA; break;
+    case FE_ROOTS_CHIEN: cfg->root_finder = BCH_ROOTS_CHIEN; break;
+    default:             cfg->root_finder = BCH_ROOTS_AUTO; break;
+    }
+    switch (params->encoder) {
+    case FE_ENC_TABLE: cfg->encoder = BCH_ENC_TABLE; break;
+    case FE_ENC_CLMUL: cfg->encoder = BCH_ENC_CLMUL; break;
+    default:           cfg->encoder = BCH_ENC_AUTO; break;
+    }
+    cfg->slice_bytes = (unsigned int)params->slice_bytes;
+    cfg->kernel = (params->kernel == FE_KERNEL_GENERIC) ? BCH_KERNEL_GENERIC : BCH_KERNEL_AUTO;
+    cfg->reject = (params->reject == FE_REJECT_FULL) ? BCH_REJECT_FULL : BCH_REJECT_EARLY;
+}
+
+FE_Ctx *FE_Ctx_Create(const fe_ctx_params *params) {
+    FE_Ctx *ctx = (FE_Ctx *)calloc(1, sizeof(*ctx));
+    if (!ctx) return NULL;
+
+    if (params) ctx->params = *params;
+    else fe_ctx_params_default(&ctx->params);
+
+    // BCH 옵션 (근 찾기 / 인코더 방식)
+    struct bch_config cfg;
+    fe_params_to_bch(&ctx->params, &cfg);
+
+    // 테이블 파일이 있고 맞으면 매핑해서 사용, 아니면 직접 계산
+    if (ctx->params.tables_path) {
+        ctx->tables = fe_tables_map_file(ctx->params.tables_path);
+        if (ctx->tables) {
+            ctx->bch = fe_bch_create_image(&cfg, fe_tables_data(ctx->tables), fe_tables_size(ctx->tables));
+            if (!ctx->bch) {
+                fe_tables_unmap(ctx->tables);
+                ctx->tables = NULL;
+            }
+        }
+    }
+    if (!ctx->bch) ctx->bch = fe_bch_create(&cfg);
+    if (!ctx->bch) goto fail;
+
+    if (ctx->params.kdf_lanes < 0) goto fail;
+
+    // bitsliced 배치 디코더 (bs_width가 잘못된 값이면 생성 실패)
+    if (ctx->params.decoder == FE_DEC_BITSLICED) {
+        if (ctx->params.bs_width < 0) goto fail;
+        ctx->bs = fe_bch_bs64_create(ctx->bch, (unsigned int)ctx->params.bs_width);
+        if (!ctx->bs) goto fail;
+    }
+
+    // 상수 시간 디코더 (Chien 병렬 구간은 bs_width를 같이 씀)
+    if (ctx->params.decoder == FE_DEC_CONSTTIME) {
+        if (ctx->params.bs_width < 0) goto fail;
+        ctx->ct = fe_bch_ct_create(ctx->bch, (unsigned int)ctx->params.bs_width);
+        if (!ctx->ct) goto fail;
+    }
+
+    // 워커 수 결정 (0 = CPU 코어 수)
+    ctx->workers = ctx->params.num_threads;
+    if (ctx->workers <= 0) ctx->workers = fe_cpu_count();
+    if (ctx->workers <= 1) {
+        ctx->workers = 1;
+        return ctx;
+    }
+
+    ctx->pool = fe_pool_create(ctx->workers, ctx->params.pin_threads);
+    if (!ctx->pool) goto fail;
+    ctx->workers = fe_pool_workers(ctx->pool);
+
+    // 워커별 작업 공간 (풀 실행은 컨텍스트당 하나씩 직렬화되므로 공유 안전)
+    ctx->ws = (struct bch_workspace **)calloc(ctx->workers, sizeof(*ctx->ws));
+    if (!ctx->ws) goto fail;
+    for (int i = 0; i < ctx->workers; i++) {
+        ctx->ws[i] = fe_bch_ws_create(ctx->bch);
+        if (!ctx->ws[i]) goto fail;
+    }
+    if (ctx->bs) {
+        ctx->bs_ws = (struct bch_bs64_ws **)calloc(ctx->workers, sizeof(*ctx->bs_ws));
+        if (!ctx->bs_ws) goto fail;
+        for (int i = 0; i < ctx->workers; i++) {
+            ctx->bs_ws[i] = fe_bch_bs64_ws_create(ctx->bs);
+            if (!ctx->bs_ws[i]) goto fail;
+        }
+    }
+    if (ctx->ct) {
+        ctx->ct_ws = (struct bch_ct_ws **)calloc(ctx->workers, sizeof(*ctx->ct_ws));
+        if (!ctx->ct_ws) goto fail;
+        for (int i = 0; i < ctx->workers; i++) {
+            ctx->ct_ws[i] = fe_bch_ct_ws_create(ctx->ct);
+            if (!ctx->ct_ws[i]) goto fail;
+        }
+    }
+    return ctx;
+
+fail:
+    FE_Ctx_Destroy(ctx);
+    return NULL;
+}
+
+size_t FE_Ctx_Table_Bytes(const fe_ctx_params *params) {
+    fe_ctx_params defaults;
+    struct bch_config cfg;
+    if (!params) {
+        fe_ctx_params_default(&defaults);
+        params = &defaults;
+    }
+    fe_params_to_bch(params, &cfg);
+    return bch_table_bytes(GFBITS, SYS_T, &cfg);
+}
+
+void FE_Ctx_Destroy(FE_Ctx *ctx) {
+    if (!ctx) return;
+    fe_pool_destroy(ctx->pool);
+    if (ctx->ws) {
+        for (int i = 0; i < ctx->workers; i++) fe_bch_ws_destroy(ctx->ws[i]);
+        free(ctx->ws);
+    }
+    if (ctx->bs_ws) {
+        for (int i = 0; i < ctx->workers; i++) fe_bch_bs64_ws_destroy(ctx->bs_ws[i]);
+        free(ctx->bs_ws);
+    }
+    if (ctx->ct_ws) {
+        for (int i = 0; i < ctx->workers; i++) fe_bch_ct_ws_destroy(ctx->ct_ws[i]);
+        free(ctx->ct_ws);
+    }
+    fe_bch_bs64_destroy(ctx->bs);
+    fe_bch_ct_destroy(ctx->ct);
+    fe_bch_destroy(ctx->bch);
+    fe_tables_unmap(ctx->tables);
+    free(ctx);
+}
+
+int FE_Gen_Ws(FE_Ctx *ctx, struct bch_workspace *ws,
+              const uint8_t *input_data, uint8_t *helper_out, FE_Key *key_out) {
+    if (!ctx || !ws || !input_data || !helper_out || !key_out) return -1;
+    // helper = ECC || 새 salt
+    if (fe_random_bytes(helper_out + FE_ECC_BYTES, FE_SALT_BYTES) != 0) return -1;
+    fe_bch_encode(ctx->bch, ws, input_data, helper_out);
+    FE_Derive_Key(input_data, helper_out + FE_ECC_BYTES, key_out);
+    return 0; 
+}
+
+/* =================================================================
+ * [Stream] 조각 단위 enroll (ECC 나머지 / 키 해시를 상태에 이어서 보관)
+ * ================================================================= */
+
+int FE_Gen_Stream_Init(FE_Ctx *ctx, struct bch_workspace *ws, FE_Gen_Stream *st) {
+    if (!ctx || !ws || !st) return -1;
+    memset(st, 0, sizeof(*st));
+    // 1. helper = (ECC 나머지 0) || 새 salt
+    if (fe_random_bytes(st->helper + FE_ECC_BYTES, FE_SALT_BYTES) != 0) return -1;
+    // 2. 키 해시는 salt부터 흡수
+    fe_sha3_init(&st->kdf);
+    fe_sha3_update(&st->kdf, st->helper + FE_ECC_BYTES, FE_SALT_BYTES);
+    st->ctx = ctx;
+    st->ws = ws;
+    return 0;
+}
+
+int FE_Gen_Stream_Update(FE_Gen_Stream *st, const uint8_t *chunk, size_t len) {
+    if (!st || !st->ctx || (!chunk && len > 0)) return -1;
+    if (len > FE_DATA_BYTES - st->len) return -1;
+    if (len == 0) return 0;
+    // 이전 나머지에서 이어서 인코딩
+    fe_bch_encode_update(st->ctx->bch, st->ws, chunk, len, st->helper);
+    fe_sha3_update(&st->kdf, chunk, len);
+    st->len += len;
+    return 0;
+}
+
+int FE_Gen_Stream_Final(FE_Gen_Stream *st, uint8_t *helper_out, FE_Key *key_out) {
+    if (!st || !st->ctx || !helper_out || !key_out) return -1;
+    if (st->len != FE_DATA_BYTES) return -1;
+    memcpy(helper_out, st->helper, FE_HELPER_BYTES);
+    fe_sha3_final(&st->kdf, key_out->key);
+    // 해시 상태에는 입력이 섞여 있으므로 지움
+    memset(st, 0, sizeof(*st));
+    return 0;
+}
+
+int FE_Rep_Ws(FE_Ctx *ctx, struct bch_workspace *ws,
+              const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out) {
+    unsigned int errloc[SYS_T];
+    size_t nflip;
+    if (!ctx || !ws || !noisy_input || !helper_in || !key_out) return -1;
+    FE_TRACE_DECL(tr);
+    FE_TRACE_BEGIN(tr);
+    // 오류 위치만 구하고 정정은 키 유도에서 가상으로 (입력 수정 / 복사 없음)
+    int err_cnt = fe_bch_locate(ctx->bch, ws, noisy_input, helper_in, errloc, &nflip);
+    FE_TRACE_DECODE(tr, ws);
+    if (err_cnt < 0) {
+        FE_TRACE_END(tr, 1);
+        return -1;
+    }
+    FE_Derive_Key_Flip(noisy_input, errloc, nflip, helper_in + FE_ECC_BYTES, key_out);
+    FE_TRACE_STAGE(tr, FE_STAGE_HASH);
+    FE_TRACE_END(tr, 0);
+    return err_cnt;
+}
+
+int FE_Rep_Ct(FE_Ctx *ctx, struct bch_ct_ws *ws,
+              const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out) {
+    uint8_t errvec[FE_DATA_BYTES];
+    if (!ctx || !ctx->ct || !ws || !noisy_input || !helper_in || !key_out) return -1;
+    FE_TRACE_DECL(tr);
+    FE_TRACE_BEGIN(tr);
+    // 1. 오류 벡터 (실패해도 같은 작업량)
+    int err_cnt = fe_bch_decode_ct(ctx->ct, ws, noisy_input, helper_in, errvec);
+    FE_TRACE_LIB(tr, bch_ct_trace(ws));
+    // 2. 성공 여부와 관계없이 키 유도까지 수행하고 실패면 결과를 버림
+    FE_Derive_Key_Xor(noisy_input, errvec, helper_in + FE_ECC_BYTES, key_out);
+    memset(errvec, 0, sizeof(errvec));
+    FE_TRACE_STAGE(tr, FE_STAGE_HASH);
+    FE_TRACE_END(tr, err_cnt < 0);
+    if (err_cnt < 0) {
+        memset(key_out, 0, sizeof(*key_out));
+        return -1;
+    }
+    return err_cnt;
+}
+
+int FE_Rep_Bs64(FE_Ctx *ctx, struct bch_bs64_ws *ws, size_t n,
+                const uint8_t *inputs, const uint8_t *helpers,
+                uint8_t *keys_out, int *status_out) {
+    uint8_t corr[BCH_BS64_LANES * FE_DATA_BYTES];
+    int nerr[BCH_BS64_LANES];
+    const uint8_t *data[BCH_BS64_LANES], *salt[BCH_BS64_LANES];
+    uint8_t *out[BCH_BS64_LANES];
+    if (!ctx || !ctx->bs || !ws || !inputs || !helpers || !keys_out || !status_out) return -1;
+
+    // 1. 정정 (64건 공통 고정 비용, 결과는 corr에)
+    if (fe_bch_decode_bs64(ctx->bs, ws, n, inputs, helpers, FE_HELPER_BYTES, corr, nerr) < 0) {
+        memset(corr, 0, sizeof(corr));
+        return -1;
+    }
+
+    // 2. 성공한 항목만 모아 multi-buffer 키 유도
+    size_t success = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (nerr[i] < 0) {
+            status_out[i] = FE_FAIL_DECODE;
+            continue;
+        }
+        data[success] = corr + i * FE_DATA_BYTES;
+        salt[success] = helpers + i * FE_HELPER_BYTES + FE_ECC_BYTES;
+        out[success] = keys_out + i * FE_KEY_LEN;
+        status_out[i] = FE_SUCCESS;
+        success++;
     }
+    FE_Derive_Keys(ctx, success, data, NULL, NULL, salt, out);
+    memset(corr, 0, sizeof(corr));   // 정정된 템플릿은 남기지 않음
+    return (int)success;
 }
 
+/* =================================================================
+ * [Batch] FE_SHA3_MAX_LANES건씩 BCH 처리 후 키 유도를 한 번에
+ * ================================================================= */
+
+int FE_Gen_Batch(FE_Ctx *ctx, struct bch_workspace *ws, size_t n,
+                 const uint8_t *inputs, uint8_t *helpers_out,
+                 uint8_t *keys_out, int *status_out) {
+    uint8_t salts[FE_SHA3_MAX_LANES * FE_SALT_BYTES];
+    const uint8_t *data[FE_SHA3_MAX_LANES], *salt[FE_SHA3_MAX_LANES];
+    uint8_t *out[FE_SHA3_MAX_LANES];
+    if (!ctx || !ws || !inputs || !helpers_out || !keys_out || !status_out) return -1;
+
+    int success = 0;
+    for (size_t i = 0; i < n; i += FE_SHA3_MAX_LANES) {
+        size_t cnt = (n - i < FE_SHA3_MAX_LANES) ? n - i : FE_SHA3_MAX_LANES;
+
+        // 1. salt는 묶음당 한 번에 뽑음
+        if (fe_random_bytes(salts, cnt * FE_SALT_BYTES) != 0) {
+            for (size_t k = 0; k < cnt; k++) status_out[i + k] = FE_FAIL_PARAM;
+            continue;
+        }
+
+        // 2. 항목별 helper = ECC || salt
+        for (size_t k = 0; k < cnt; k++) {
+            uint8_t *helper = helpers_out + (i + k) * FE_HELPER_BYTES;
+            data[k] = inputs + (i + k) * FE_DATA_BYTES;
+            memcpy(helper + FE_ECC_BYTES, salts + k * FE_SALT_BYTES, FE_SALT_BYTES);
+            fe_bch_encode(ctx->bch, ws, data[k], helper);
+            salt[k] = helper + FE_ECC_BYTES;
+            out[k] = keys_out + (i + k) * FE_KEY_LEN;
+            status_out[i + k] = FE_SUCCESS;
+        }
+
+        // 3. 키 유도
+        FE_Derive_Keys(ctx, cnt, data, NULL, NULL, salt, out);
+        success += (int)cnt;
+    }
+    return success;
+}
+
+int FE_Rep_Batch(FE_Ctx *ctx, struct bch_workspace *ws, size_t n,
+                 const uint8_t *inputs, const uint8_t *helpers,
+                 uint8_t *keys_out, int *status_out) {
+    unsigned int errloc[FE_SHA3_MAX_LANES][SYS_T];
+    const unsigned int *flip[FE_SHA3_MAX_LANES];
+    size_t nflip[FE_SHA3_MAX_LANES];
+    const uint8_t *data[FE_SHA3_MAX_LANES], *salt[FE_SHA3_MAX_LANES];
+    uint8_t *out[FE_SHA3_MAX_LANES];
+    FE_TRACE_POOL(tp, FE_SHA3_MAX_LANES);
+    if (!ctx || !ws || !inputs || !helpers || !keys_out || !status_out) return -1;
+
+    int success = 0;
+    for (size_t i = 0; i < n; i += FE_SHA3_MAX_LANES) {
+        size_t cnt = (n - i < FE_SHA3_MAX_LANES) ? n - i : FE_SHA3_MAX_LANES;
+        size_t k = 0;
+
+        // 1. 항목별 오류 위치 (입력은 읽기만 함)
+        for (size_t j = i; j < i + cnt; j++) {
+            const uint8_t *helper = helpers + j * FE_HELPER_BYTES;
+            FE_TRACE_DECL(tr);
+            FE_TRACE_BEGIN(tr);
+            int err_cnt = fe_bch_locate(ctx->bch, ws, inputs + j * FE_DATA_BYTES, helper,
+                                        errloc[k], &nflip[k]);
+            FE_TRACE_DECODE(tr, ws);
+            if (err_cnt < 0) {
+                FE_TRACE_END(tr, 1);
+                status_out[j] = FE_FAIL_DECODE;
+                continue;
+            }
+            FE_TRACE_SAVE(tp, k, tr);
+            data[k] = inputs + j * FE_DATA_BYTES;
+            flip[k] = errloc[k];
+            salt[k] = helper + FE_ECC_BYTES;
+            out[k] = keys_out + j * FE_KEY_LEN;
+            status_out[j] = FE_SUCCESS;
+            k++;
+        }
+
+        // 2. 성공한 항목만 키 유도 (오류 비트는 흡수 중에 뒤집음)
+        FE_TRACE_POOL_BEGIN(tp);
+        FE_Derive_Keys(ctx, k, data, flip, nflip, salt, out);
+        FE_TRACE_POOL_END(tp, k);
+        success += (int)k;
+    }
+    return success;
+}
+
+int FE_Gen_Ctx(FE_Ctx *ctx, const uint8_t *input_data, uint8_t *helper_out, FE_Key *key_out) {
+    if (!ctx) return -1;
+    struct bch_workspace *ws = fe_bch_ws_create(ctx->bch);
+    if (!ws) return -1;
+    int ret = FE_Gen_Ws(ctx, ws, input_data, helper_out, key_out);
+    fe_bch_ws_destroy(ws);
+    return ret;
+}
+
+int FE_Rep_Ctx(FE_Ctx *ctx, const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out) {
+    if (!ctx) return -1;
+    if (ctx->ct) {
+        struct bch_ct_ws *ct_ws = fe_bch_ct_ws_create(ctx->ct);
+        if (!ct_ws) return -1;
+        int ret = FE_Rep_Ct(ctx, ct_ws, noisy_input, helper_in, key_out);
+        fe_bch_ct_ws_destroy(ct_ws);
+        return ret;
+    }
+    struct bch_workspace *ws = fe_bch_ws_create(ctx->bch);
+    if (!ws) return -1;
+    int ret = FE_Rep_Ws(ctx, ws, noisy_input, helper_in, key_out);
+    fe_bch_ws_destroy(ws);
+    return ret;
+}
+
+/* =================================================================
+ * [Legacy] 공용 BCH 인스턴스 사용
+ * ================================================================= */
+
 int FE_Init(void) {
     return fe_bch_init();
 }
@@ -21,15 +440,18 @@ void FE_Free(void) {
 
 int FE_Gen(const uint8_t *input_data, uint8_t *helper_out, FE_Key *key_out) {
     if (!input_data || !helper_out || !key_out) return -1;
+    if (fe_random_bytes(helper_out + FE_ECC_BYTES, FE_SALT_BYTES) != 0) return -1;
     fe_encode(input_data, helper_out);
-    simple_hash(input_data, FE_DATA_BYTES, key_out->key);
+    FE_Derive_Key(input_data, helper_out + FE_ECC_BYTES, key_out);
     return 0; 
 }
 
-int FE_Rep(uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out) {
+int FE_Rep(const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out) {
+    unsigned int errloc[SYS_T];
+    size_t nflip;
     if (!noisy_input || !helper_in || !key_out) return -1;
-    int err_cnt = fe_decode(noisy_input, helper_in);
+    int err_cnt = fe_locate(noisy_input, helper_in, errloc, &nflip);
     if (err_cnt < 0) return -1;
-    simple_hash(noisy_input, FE_DATA_BYTES, key_out->key);
+    FE_Derive_Key_Flip(noisy_input, errloc, nflip, helper_in + FE_ECC_BYTES, key_out);
     return err_cnt;
-}
\ No newline at end of file
+}
@@ -3,6 +3,10 @@
 
 #include <stdint.h>
 #include "bch_wrapper.h"
+#include "fe_api.h"
+#include "fe_pool.h"
+#include "fe_kdf.h"
+#include "fe_tables.h"
 
 #define FE_KEY_LEN 32 
 
@@ -10,9 +14,110 @@ typedef struct {
     uint8_t key[FE_KEY_LEN];
 } FE_Key;
 
+/* 재사용 가능한 엔진 컨텍스트 (생성 1회, 사용 다회)
+ * 생성 이후 읽기 전용이므로 여러 스레드에서 동시에 사용할 수 있음 */
+struct fe_ctx {
+    struct bch_control *bch;
+    fe_ctx_params params;
+    fe_pool *pool;                  // 배치 API 워커 (workers == 1이면 NULL)
+    int workers;
+    struct bch_workspace **ws;      // 풀 워커별 작업 공간 [workers] (pool 있을 때만)
+    struct bch_bs64 *bs;            // bitsliced 디코더 (decoder == FE_DEC_BITSLICED일 때만)
+    struct bch_bs64_ws **bs_ws;     // 풀 워커별 bitsliced 작업 공간 [workers]
+    struct bch_ct *ct;              // 상수 시간 디코더 (decoder == FE_DEC_CONSTTIME일 때만)
+    struct bch_ct_ws **ct_ws;       // 풀 워커별 상수 시간 작업 공간 [workers]
+    fe_tables_map *tables;          // bch 테이블이 가리키는 매핑 파일 (직접 계산했으면 NULL)
+};
+typedef struct fe_ctx FE_Ctx;
+
+FE_Ctx *FE_Ctx_Create(const fe_ctx_params *params);
+void FE_Ctx_Destroy(FE_Ctx *ctx);
+size_t FE_Ctx_Table_Bytes(const fe_ctx_params *params);   // 읽기 전용 테이블 크기 (0 = 잘못된 옵션)
+
+/* helper_out / helper_in: FE_HELPER_BYTES (ECC || salt), Gen이 salt를 새로 뽑음
+ * Rep은 noisy_input을 수정하지도 복사하지도 않음: 오류 위치만 구해
+ * 키 = SHA3-256(salt || (noisy_input ^ 오류 벡터))를 흡수 중에 비트를 뒤집어 유도 */
+
+/* 호출마다 작업 공간을 할당하는 버전 (재진입 가능) */
+int FE_Gen_Ctx(FE_Ctx *ctx, const uint8_t *input_data, uint8_t *helper_out, FE_Key *key_out);
+int FE_Rep_Ctx(FE_Ctx *ctx, const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out);
+
+/* 호출자가 작업 공간을 넘기는 버전 (스레드당 ws 1개 재사용) */
+int FE_Gen_Ws(FE_Ctx *ctx, struct bch_workspace *ws,
+              const uint8_t *input_data, uint8_t *helper_out, FE_Key *key_out);
+int FE_Rep_Ws(FE_Ctx *ctx, struct bch_workspace *ws,
+              const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out);
+
+/* 상수 시간 reproduce (decoder == FE_DEC_CONSTTIME): 디코딩과 키 유도 모두 에러 수와
+ * 무관한 작업량. 오류 벡터 전체를 흡수하며, 실패해도 키 유도까지 마친 뒤 버림 (-1) */
+int FE_Rep_Ct(FE_Ctx *ctx, struct bch_ct_ws *ws,
+              const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out);
+
+/* 스트리밍 enroll: 입력을 조각으로 받아 BCH 나머지와 키 해시를 이어서 갱신
+ * (encode_bch_ws가 기존 ECC에서 이어서 나눗셈하는 것을 이용, 입력 전체를 모으지 않음)
+ * - Init: salt를 뽑아 해시에 먼저 흡수, ECC 나머지 0
+ * - Update: 조각 길이는 자유, 합계가 FE_DATA_BYTES를 넘으면 실패 (상태 유지)
+ * - Final: 합계가 정확히 FE_DATA_BYTES일 때만 helper / 키 출력, 끝나면 상태를 지움
+ * 결과는 같은 salt로 FE_Gen_Ws를 호출한 것과 같음. ws는 Final까지 이 상태 전용 */
+typedef struct {
+    FE_Ctx *ctx;
+    struct bch_workspace *ws;
+    fe_sha3 kdf;                        // SHA3-256(salt || 지금까지 받은 입력)
+    uint8_t helper[FE_HELPER_BYTES];    // 진행 중인 ECC 나머지 || salt
+    size_t len;                         // 지금까지 받은 입력 바이트
+} FE_Gen_Stream;
+
+int FE_Gen_Stream_Init(FE_Ctx *ctx, struct bch_workspace *ws, FE_Gen_Stream *st);
+int FE_Gen_Stream_Update(FE_Gen_Stream *st, const uint8_t *chunk, size_t len);
+int FE_Gen_Stream_Final(FE_Gen_Stream *st, uint8_t *helper_out, FE_Key *key_out);
+
+/* 배치 enroll / reproduce: 연속 배열 n건 (간격 FE_DATA_BYTES / FE_HELPER_BYTES / FE_KEY_LEN)
+ * FE_SHA3_MAX_LANES건씩 BCH 처리 후 키 유도는 multi-buffer로 한 번에 (입력은 수정하지 않음)
+ * status_out[i] = FE_SUCCESS / FE_FAIL_DECODE / FE_FAIL_PARAM, 반환: 성공 건수 (-1 = 인자 오류) */
+int FE_Gen_Batch(FE_Ctx *ctx, struct bch_workspace *ws, size_t n,
+                 const uint8_t *inputs, uint8_t *helpers_out,
+                 uint8_t *keys_out, int *status_out);
+int FE_Rep_Batch(FE_Ctx *ctx, struct bch_workspace *ws, size_t n,
+                 const uint8_t *inputs, const uint8_t *helpers,
+                 uint8_t *keys_out, int *status_out);
+
+/* bitsliced 배치 reproduce: n <= 64건을 한 번에 정정 (입력은 수정하지 않음)
+ * status_out[i] = FE_SUCCESS / FE_FAIL_DECODE, 반환: 성공 건수 (-1 = 인자 오류) */
+int FE_Rep_Bs64(FE_Ctx *ctx, struct bch_bs64_ws *ws, size_t n,
+                const uint8_t *inputs, const uint8_t *helpers,
+                uint8_t *keys_out, int *status_out);
+
+/* 정정된 데이터 + helper의 salt -> 키 (enroll/reproduce 공통 키 유도 단계, SHA3-256) */
+void FE_Derive_Key(const uint8_t *data, const uint8_t *salt, FE_Key *key_out);
+/* data ^ (flip[0..nflip) 비트 위치의 오류 벡터)에 대한 FE_Derive_Key (정정된 사본 없이) */
+void FE_Derive_Key_Flip(const uint8_t *data, const unsigned int *flip, size_t nflip,
+                        const uint8_t *salt, FE_Key *key_out);
+/* data ^ errvec (FE_DATA_BYTES 오류 벡터)에 대한 FE_Derive_Key, 오류 수와 무관한 작업량 */
+void FE_Derive_Key_Xor(const uint8_t *data, const uint8_t *errvec,
+                       const uint8_t *salt, FE_Key *key_out);
+/* n건 키 유도 (ctx->params.kdf_lanes개씩 SIMD lane에 실어 동시 처리, 결과는 FE_Derive_Key_Flip과 같음)
+ * flip == NULL이면 오류 벡터 없음 */
+void FE_Derive_Keys(const FE_Ctx *ctx, size_t n, const uint8_t *const *data,
+                    const unsigned int *const *flip, const size_t *nflip,
+                    const uint8_t *const *salt, uint8_t *const *key_out);
+/* 키 -> 키 커밋 (갤러리가 키 대신 보관, FE_KEY_LEN 바이트) */
+void FE_Commit_Key(const FE_Key *key, uint8_t *commit_out);
+/* 키 커밋을 계산해 commit과 대조 (일치 0, 불일치 1). 바이트 차이를 OR로 모아
+ * 첫 불일치에서 멈추지 않음 (상수 시간 reproduce의 마지막 단계) */
+int FE_Check_Commit(const FE_Key *key, const uint8_t *commit);
+
+/* 등록 저장소 파일 (fe_store.c): 항목 i의 helper / 커밋은 helpers + i * helper_stride /
+ * commits + i * commit_stride. syn == NULL이면 helper 신드롬을 bch로 계산해 기록 */
+int FE_Store_Write(const struct bch_control *bch, const char *path, size_t count,
+                   const uint8_t *helpers, size_t helper_stride,
+                   const uint8_t *commits, size_t commit_stride,
+                   const uint16_t *syn);
+/* 매핑된 helper 신드롬 열 [count][SYS_T] (갤러리 prescreen용) */
+const uint16_t *FE_Store_Syn(const fe_store *store);
+
 int FE_Init(void);
 void FE_Free(void);
 int FE_Gen(const uint8_t *input_data, uint8_t *helper_out, FE_Key *key_out);
-int FE_Rep(uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out);
+int FE_Rep(const uint8_t *noisy_input, const uint8_t *helper_in, FE_Key *key_out);
 
-#endif // FE_CORE_H
\ No newline at end of file
+#endif // FE_CORE_H
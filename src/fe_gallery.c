@@ -0,0 +1,296 @@
+#include "fe_api.h"
+#include "fe_core.h"
+#include "bch_wrapper.h"
+#include "../lib/bch.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* =================================================================
+ * [Gallery] 1:N 식별용 helper / 키 커밋 저장소
+ * 항목 i의 데이터는 배열별로 연속 배치 (검사 루프가 순서대로 읽음)
+ *   helpers : [capacity][FE_HELPER_BYTES] (ECC || salt)
+ *   commits : [capacity][FE_KEY_LEN]
+ *   syn     : [capacity][SYS_T] helper의 홀수 신드롬 S(1), S(3), .., S(2t-1)
+ * 저장소 파일(fe_store.c)의 열 배치와 같으므로 fe_gallery_open은 매핑된 열을
+ * 그대로 가리킴 (store != NULL 동안 읽기 전용, 추가 시 힙으로 복사)
+ * ================================================================= */
+struct fe_gallery {
+    fe_ctx *ctx;
+    size_t count;
+    size_t capacity;
+    int max_errors;
+    uint8_t *helpers;
+    uint8_t *commits;
+    uint16_t *syn;
+    const fe_store *store;
+};
+
+// 워커별 부분 결과 (풀 실행 후 합침, 공유 변수 없음)
+typedef struct {
+    size_t first;       // 가장 작은 일치 인덱스 (없으면 count)
+    size_t matches;
+    size_t candidates;
+    FE_Key key;
+} gallery_part;
+
+typedef struct {
+    fe_gallery *g;
+    const uint8_t *probe;
+    const unsigned int *psyn;       // probe ecc의 신드롬 [2 * SYS_T]
+    struct bch_workspace **ws;      // 워커 인덱스별 작업 공간
+    gallery_part *part;             // 워커 인덱스별 결과
+} gallery_job;
+
+// 매핑된 열을 cap건짜리 힙 배열로 복사 (첫 추가 시 1회)
+static int gallery_detach(fe_gallery *g, size_t cap) {
+    uint8_t *helpers = (uint8_t *)malloc(cap * FE_HELPER_BYTES);
+    uint8_t *commits = (uint8_t *)malloc(cap * FE_KEY_LEN);
+    uint16_t *syn = (uint16_t *)malloc(cap * SYS_T * sizeof(*syn));
+    if (!helpers || !commits || !syn) {
+        free(helpers);
+        free(commits);
+        free(syn);
+        return -1;
+    }
+    memcpy(helpers, g->helpers, g->count * FE_HELPER_BYTES);
+    memcpy(commits, g->commits, g->count * FE_KEY_LEN);
+    memcpy(syn, g->syn, g->count * SYS_T * sizeof(*syn));
+    g->helpers = helpers;
+    g->commits = commits;
+    g->syn = syn;
+    g->capacity = cap;
+    g->store = NULL;
+    return 0;
+}
+
+static int gallery_reserve(fe_gallery *g, size_t need) {
+    if (need <= g->capacity) return 0;
+    size_t cap = g->capacity ? g->capacity : 64;
+    while (cap < need) cap *= 2;
+    if (g->store) return gallery_detach(g, cap);
+
+    uint8_t *helpers = (uint8_t *)realloc(g->helpers, cap * FE_HELPER_BYTES);
+    if (!helpers) return -1;
+    g->helpers = helpers;
+    uint8_t *commits = (uint8_t *)realloc(g->commits, cap * FE_KEY_LEN);
+    if (!commits) return -1;
+    g->commits = commits;
+    uint16_t *syn = (uint16_t *)realloc(g->syn, cap * SYS_T * sizeof(*syn));
+    if (!syn) return -1;
+    g->syn = syn;
+    g->capacity = cap;
+    return 0;
+}
+
+fe_gallery *fe_gallery_create(fe_ctx *ctx, size_t capacity, int max_errors) {
+    if (!ctx || max_errors < 0 || max_errors > SYS_T) return NULL;
+    fe_gallery *g = (fe_gallery *)calloc(1, sizeof(*g));
+    if (!g) return NULL;
+    g->ctx = ctx;
+    g->max_errors = max_errors ? max_errors : FE_GALLERY_MAX_ERRORS;
+    if (gallery_reserve(g, capacity)) {
+        fe_gallery_destroy(g);
+        return NULL;
+    }
+    return g;
+}
+
+fe_gallery *fe_gallery_open(fe_ctx *ctx, const fe_store *store, int max_errors) {
+    if (!store) return NULL;
+    fe_gallery *g = fe_gallery_create(ctx, 0, max_errors);
+    if (!g) return NULL;
+    // 열 포인터만 연결 (항목 파싱 / 신드롬 재계산 없음)
+    g->helpers = (uint8_t *)fe_store_helpers(store);
+    g->commits = (uint8_t *)fe_store_commits(store);
+    g->syn = (uint16_t *)FE_Store_Syn(store);
+    g->count = g->capacity = fe_store_count(store);
+    g->store = store;
+    return g;
+}
+
+int fe_gallery_save(const fe_gallery *gallery, const char *path) {
+    if (!gallery || !path) return FE_FAIL_PARAM;
+    return FE_Store_Write(gallery->ctx->bch, path, gallery->count,
+                          gallery->helpers, FE_HELPER_BYTES, gallery->commits, FE_KEY_LEN,
+                          gallery->syn) == 0 ? FE_SUCCESS : FE_FAIL_PARAM;
+}
+
+void fe_gallery_destroy(fe_gallery *gallery) {
+    if (!gallery) return;
+    if (!gallery->store) {
+        free(gallery->helpers);
+        free(gallery->commits);
+        free(gallery->syn);
+    }
+    free(gallery);
+}
+
+size_t fe_gallery_count(const fe_gallery *gallery) {
+    return gallery ? gallery->count : 0;
+}
+
+void fe_key_commit(const uint8_t *secret_key, uint8_t *commit_out) {
+    FE_Key key;
+    if (!secret_key || !commit_out) return;
+    memcpy(key.key, secret_key, FE_KEY_LEN);
+    FE_Commit_Key(&key, commit_out);
+}
+
+// helper / 커밋을 다음 칸에 저장하고 helper 신드롬을 미리 계산
+static int gallery_append(fe_gallery *g, struct bch_workspace *ws,
+                          const uint8_t *helper, const uint8_t *commit, size_t *index_out) {
+    unsigned int syn[2 * SYS_T];
+    if (gallery_reserve(g, g->count + 1)) return FE_FAIL_PARAM;
+
+    size_t i = g->count;
+    memcpy(g->helpers + i * FE_HELPER_BYTES, helper, FE_HELPER_BYTES);
+    memcpy(g->commits + i * FE_KEY_LEN, commit, FE_KEY_LEN);
+    fe_bch_ecc_syndromes(g->ctx->bch, ws, helper, syn);
+    for (int j = 0; j < SYS_T; j++) g->syn[i * SYS_T + j] = (uint16_t)syn[2 * j];
+    g->count++;
+    if (index_out) *index_out = i;
+    return FE_SUCCESS;
+}
+
+int fe_gallery_enroll(
+    fe_gallery *gallery,
+    const uint8_t *input,
+    size_t input_len,
+    uint8_t *secret_key,
+    size_t *index_out
+) {
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t commit[FE_KEY_LEN];
+    FE_Key key_struct;
+
+    if (!gallery || !input || input_len != FE_DATA_BYTES) return FE_FAIL_PARAM;
+    struct bch_workspace *ws = fe_bch_ws_create(gallery->ctx->bch);
+    if (!ws) return FE_FAIL_PARAM;
+
+    int ret = FE_Gen_Ws(gallery->ctx, ws, input, helper, &key_struct) < 0 ? FE_FAIL_PARAM : FE_SUCCESS;
+    if (ret == FE_SUCCESS) {
+        FE_Commit_Key(&key_struct, commit);
+        ret = gallery_append(gallery, ws, helper, commit, index_out);
+    }
+    if (ret == FE_SUCCESS && secret_key) memcpy(secret_key, key_struct.key, FE_KEY_LEN);
+    memset(&key_struct, 0, sizeof(key_struct));
+    fe_bch_ws_destroy(ws);
+    return ret;
+}
+
+int fe_gallery_add(
+    fe_gallery *gallery,
+    const uint8_t *helper_data,
+    size_t helper_len,
+    const uint8_t *commit,
+    size_t commit_len,
+    size_t *index_out
+) {
+    if (!gallery || !helper_data || !commit) return FE_FAIL_PARAM;
+    if (helper_len != FE_HELPER_BYTES || commit_len != FE_KEY_LEN) return FE_FAIL_PARAM;
+    struct bch_workspace *ws = fe_bch_ws_create(gallery->ctx->bch);
+    if (!ws) return FE_FAIL_PARAM;
+    int ret = gallery_append(gallery, ws, helper_data, commit, index_out);
+    fe_bch_ws_destroy(ws);
+    return ret;
+}
+
+/* =================================================================
+ * [Identify] 항목 구간 [begin, end) 검사
+ * ================================================================= */
+static void gallery_scan_range(void *arg, int worker, size_t begin, size_t end) {
+    gallery_job *job = (gallery_job *)arg;
+    fe_gallery *g = job->g;
+    const struct bch_control *bch = g->ctx->bch;
+    struct bch_workspace *ws = job->ws[worker];
+    gallery_part *part = &job->part[worker];
+    unsigned int syn[2 * SYS_T];
+    unsigned int errloc[SYS_T];
+    size_t nflip;
+    uint8_t commit[FE_KEY_LEN];
+    FE_Key key_struct;
+
+    for (size_t i = begin; i < end; i++) {
+        // 1. (probe || helper_i) 신드롬: 홀수는 xor, 짝수는 S(2j) = S(j)^2
+        const uint16_t *es = g->syn + i * SYS_T;
+        for (int j = 0; j < SYS_T; j++) syn[2 * j] = job->psyn[2 * j] ^ es[j];
+        for (int j = 0; j < SYS_T; j++) syn[2 * j + 1] = gf_tab_sqr(&bch->gf, syn[j]);
+
+        // 2. prescreen: 차수가 max_errors를 넘으면 BM 도중 제외
+        if (fe_bch_locator_degree(bch, ws, syn, g->max_errors) < 0) continue;
+        part->candidates++;
+
+        // 3. 후보만 근 찾기 + 키 커밋 비교 (probe는 공유, 정정은 키 유도에서 가상으로)
+        if (fe_bch_locate_syn(bch, ws, syn, errloc, &nflip) < 0) continue;
+        FE_Derive_Key_Flip(job->probe, errloc, nflip,
+                           g->helpers + i * FE_HELPER_BYTES + FE_ECC_BYTES, &key_struct);
+        FE_Commit_Key(&key_struct, commit);
+        if (memcmp(commit, g->commits + i * FE_KEY_LEN, FE_KEY_LEN) != 0) continue;
+
+        part->matches++;
+        if (i < part->first) {
+            part->first = i;
+            part->key = key_struct;
+        }
+    }
+    memset(&key_struct, 0, sizeof(key_struct));
+}
+
+int fe_gallery_identify(
+    fe_gallery *gallery,
+    const uint8_t *probe,
+    size_t probe_len,
+    uint8_t *recovered_key,
+    fe_gallery_result *result
+) {
+    uint8_t calc_ecc[FE_ECC_BYTES];
+    unsigned int psyn[2 * SYS_T];
+
+    // 1. 파라미터 유효성 검사
+    if (!gallery || !probe || probe_len != FE_DATA_BYTES) return FE_FAIL_PARAM;
+    fe_ctx *ctx = gallery->ctx;
+    int workers = ctx->pool ? ctx->workers : 1;
+    gallery_part *part = (gallery_part *)calloc(workers, sizeof(*part));
+    struct bch_workspace *local_ws = fe_bch_ws_create(ctx->bch);
+    if (!part || !local_ws) {
+        free(part);
+        fe_bch_ws_destroy(local_ws);
+        return FE_FAIL_PARAM;
+    }
+
+    // 2. probe는 1회만 인코딩해 신드롬 계산
+    fe_bch_encode(ctx->bch, local_ws, probe, calc_ecc);
+    fe_bch_ecc_syndromes(ctx->bch, local_ws, calc_ecc, psyn);
+
+    // 3. 전 항목 검사 (풀이 있으면 work-stealing 병렬)
+    for (int w = 0; w < workers; w++) part[w].first = gallery->count;
+    gallery_job job = { gallery, probe, psyn, NULL, part };
+    if (ctx->pool) {
+        job.ws = ctx->ws;
+        fe_pool_run(ctx->pool, gallery->count, 64, gallery_scan_range, &job);
+    } else {
+        job.ws = &local_ws;
+        gallery_scan_range(&job, 0, 0, gallery->count);
+    }
+
+    // 4. 워커별 결과 합치기
+    fe_gallery_result res = { -1, 0, gallery->count, 0 };
+    int best = -1;
+    for (int w = 0; w < workers; w++) {
+        res.matches += part[w].matches;
+        res.candidates += part[w].candidates;
+        if (part[w].first < gallery->count && (best < 0 || part[w].first < part[best].first))
+            best = w;
+    }
+    if (best >= 0) {
+        res.index = (long)part[best].first;
+        if (recovered_key) memcpy(recovered_key, part[best].key.key, FE_KEY_LEN);
+    }
+    if (result) *result = res;
+
+    // 워커별 복원 키 지우기
+    memset(part, 0, (size_t)workers * sizeof(*part));
+    free(part);
+    fe_bch_ws_destroy(local_ws);
+    return (best >= 0) ? FE_SUCCESS : FE_FAIL_DECODE;
+}
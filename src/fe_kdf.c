@@ -0,0 +1,370 @@
+#include "fe_kdf.h"
+#include "../lib/gf.h"
+#include <string.h>
+#include <stdio.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+    #include <immintrin.h>
+    #define KDF_HAVE_SIMD
+    #define KDF_TARGET_AVX2   __attribute__((target("avx2")))
+    #define KDF_TARGET_AVX512 __attribute__((target("avx512f")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #include <immintrin.h>
+    #define KDF_HAVE_SIMD
+    #define KDF_TARGET_AVX2
+    #define KDF_TARGET_AVX512
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+    #define SystemFunction036 NTAPI SystemFunction036
+    #include <ntsecapi.h>
+    #undef SystemFunction036
+#else
+    #include <sys/types.h>
+    #include <sys/random.h>
+#endif
+
+/* =================================================================
+ * [Keccak-f[1600]] lane (x, y) = s[x + 5y], 바이트 순서는 little-endian
+ * ================================================================= */
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ull, 0x0000000000008082ull, 0x800000000000808aull,
+    0x8000000080008000ull, 0x000000000000808bull, 0x0000000080000001ull,
+    0x8000000080008081ull, 0x8000000000008009ull, 0x000000000000008aull,
+    0x0000000000000088ull, 0x0000000080008009ull, 0x000000008000000aull,
+    0x000000008000808bull, 0x800000000000008bull, 0x8000000000008089ull,
+    0x8000000000008003ull, 0x8000000000008002ull, 0x8000000000000080ull,
+    0x000000000000800aull, 0x800000008000000aull, 0x8000000080008081ull,
+    0x8000000000008080ull, 0x0000000080000001ull, 0x8000000080008008ull,
+};
+
+#define ROL64(_x, _n)   (((_x) << (_n)) | ((_x) >> (64 - (_n))))
+
+/*
+ * 24라운드 본체. lane 연산(xor / 회전 / andnot / 라운드 상수)을 인자로 받아
+ * 스칼라(uint64_t)와 multi-buffer(AVX2 4개, AVX-512 8개 메시지)가 같은 식을 씀.
+ * 사용 측에 T s[25], c0..c4, d, t, u 선언 필요
+ */
+#define KECCAK_THETA_COL(_X, _x, _d) \
+    do { s[_x] = _X(s[_x], _d); s[_x + 5] = _X(s[_x + 5], _d); s[_x + 10] = _X(s[_x + 10], _d); \
+         s[_x + 15] = _X(s[_x + 15], _d); s[_x + 20] = _X(s[_x + 20], _d); } while (0)
+#define KECCAK_PARITY(_X, _x) \
+    _X(_X(_X(s[_x], s[_x + 5]), _X(s[_x + 10], s[_x + 15])), s[_x + 20])
+// rho + pi: lane 하나를 회전해 다음 위치로 옮기는 24단 사슬
+#define KECCAK_RHO_PI(_R, _j, _n) \
+    do { u = s[_j]; s[_j] = _R(t, _n); t = u; } while (0)
+// chi: 행 (s[_y] .. s[_y + 4]) 단위 비선형, _N(a, b) = ~a & b
+#define KECCAK_CHI(_X, _N, _y) \
+    do { c0 = s[_y]; c1 = s[_y + 1]; c2 = s[_y + 2]; c3 = s[_y + 3]; c4 = s[_y + 4]; \
+         s[_y]     = _X(c0, _N(c1, c2)); \
+         s[_y + 1] = _X(c1, _N(c2, c3)); \
+         s[_y + 2] = _X(c2, _N(c3, c4)); \
+         s[_y + 3] = _X(c3, _N(c4, c0)); \
+         s[_y + 4] = _X(c4, _N(c0, c1)); } while (0)
+
+#define KECCAK_ROUNDS(_X, _R, _N, _RC) \
+    for (int r = 0; r < 24; r++) { \
+        /* 1. theta: 열 패리티를 이웃 열에 섞음 */ \
+        c0 = KECCAK_PARITY(_X, 0); c1 = KECCAK_PARITY(_X, 1); c2 = KECCAK_PARITY(_X, 2); \
+        c3 = KECCAK_PARITY(_X, 3); c4 = KECCAK_PARITY(_X, 4); \
+        d = _X(c4, _R(c1, 1)); KECCAK_THETA_COL(_X, 0, d); \
+        d = _X(c0, _R(c2, 1)); KECCAK_THETA_COL(_X, 1, d); \
+        d = _X(c1, _R(c3, 1)); KECCAK_THETA_COL(_X, 2, d); \
+        d = _X(c2, _R(c4, 1)); KECCAK_THETA_COL(_X, 3, d); \
+        d = _X(c3, _R(c0, 1)); KECCAK_THETA_COL(_X, 4, d); \
+        /* 2. rho + pi */ \
+        t = s[1]; \
+        KECCAK_RHO_PI(_R, 10,  1); KECCAK_RHO_PI(_R,  7,  3); KECCAK_RHO_PI(_R, 11,  6); \
+        KECCAK_RHO_PI(_R, 17, 10); KECCAK_RHO_PI(_R, 18, 15); KECCAK_RHO_PI(_R,  3, 21); \
+        KECCAK_RHO_PI(_R,  5, 28); KECCAK_RHO_PI(_R, 16, 36); KECCAK_RHO_PI(_R,  8, 45); \
+        KECCAK_RHO_PI(_R, 21, 55); KECCAK_RHO_PI(_R, 24,  2); KECCAK_RHO_PI(_R,  4, 14); \
+        KECCAK_RHO_PI(_R, 15, 27); KECCAK_RHO_PI(_R, 23, 41); KECCAK_RHO_PI(_R, 19, 56); \
+        KECCAK_RHO_PI(_R, 13,  8); KECCAK_RHO_PI(_R, 12, 25); KECCAK_RHO_PI(_R,  2, 43); \
+        KECCAK_RHO_PI(_R, 20, 62); KECCAK_RHO_PI(_R, 14, 18); KECCAK_RHO_PI(_R, 22, 39); \
+        KECCAK_RHO_PI(_R,  9, 61); KECCAK_RHO_PI(_R,  6, 20); KECCAK_RHO_PI(_R,  1, 44); \
+        /* 3. chi + iota */ \
+        KECCAK_CHI(_X, _N, 0); KECCAK_CHI(_X, _N, 5); KECCAK_CHI(_X, _N, 10); \
+        KECCAK_CHI(_X, _N, 15); KECCAK_CHI(_X, _N, 20); \
+        s[0] = _X(s[0], _RC(r)); \
+    }
+
+#define S_XOR(_a, _b)   ((_a) ^ (_b))
+#define S_ANDN(_a, _b)  (~(_a) & (_b))
+#define S_RC(_r)        keccak_rc[_r]
+
+void fe_keccak_f1600(uint64_t *state) {
+    uint64_t s[25], c0, c1, c2, c3, c4, d, t, u;
+    // 지역 배열로 복사해 lane을 레지스터에 둠 (인덱스가 모두 상수)
+    memcpy(s, state, sizeof(s));
+    KECCAK_ROUNDS(S_XOR, ROL64, S_ANDN, S_RC)
+    memcpy(state, s, sizeof(s));
+}
+
+/* =================================================================
+ * [SHA3-256] 흡수 / 패딩 / 출력
+ * ================================================================= */
+
+static inline uint64_t load64_le(const uint8_t *p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) |
+           ((uint64_t)p[3] << 24) | ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) |
+           ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+void fe_sha3_init(fe_sha3 *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+// 현재 블록 안에서만 흡수 (len <= RATE - pos, 순열은 호출자가)
+static void sha3_absorb(fe_sha3 *h, const uint8_t *in, size_t len) {
+    while (len > 0) {
+        // lane 경계에서는 8바이트씩, 아니면 바이트 단위로 흡수
+        if (h->pos % 8 == 0 && len >= 8) {
+            h->s[h->pos / 8] ^= load64_le(in);
+            in += 8;
+            len -= 8;
+            h->pos += 8;
+        } else {
+            h->s[h->pos / 8] ^= (uint64_t)*in++ << (8 * (h->pos % 8));
+            len--;
+            h->pos++;
+        }
+    }
+}
+
+void fe_sha3_update(fe_sha3 *h, const uint8_t *in, size_t len) {
+    fe_sha3_update_flip(h, in, len, NULL, 0);
+}
+
+void fe_sha3_update_flip(fe_sha3 *h, const uint8_t *in, size_t len,
+                         const unsigned int *flip, size_t nflip) {
+    size_t off = 0;
+    while (off < len) {
+        size_t piece = FE_SHA3_256_RATE - h->pos;
+        if (piece > len - off) piece = len - off;
+
+        // 1. 블록 안의 조각 흡수 + 그 구간에 떨어지는 오류 비트를 상태에 직접 xor
+        unsigned int base = h->pos;
+        sha3_absorb(h, in + off, piece);
+        for (size_t k = 0; k < nflip; k++) {
+            size_t byte = flip[k] / 8;
+            if (byte < off || byte >= off + piece) continue;
+            size_t p = base + (byte - off);
+            h->s[p / 8] ^= (uint64_t)(1u << (flip[k] % 8)) << (8 * (p % 8));
+        }
+        off += piece;
+
+        // 2. 블록이 차면 순열
+        if (h->pos == FE_SHA3_256_RATE) {
+            fe_keccak_f1600(h->s);
+            h->pos = 0;
+        }
+    }
+}
+
+void fe_sha3_update_xor(fe_sha3 *h, const uint8_t *in, const uint8_t *mask, size_t len) {
+    size_t off = 0;
+    while (off < len) {
+        size_t piece = FE_SHA3_256_RATE - h->pos;
+        if (piece > len - off) piece = len - off;
+
+        // 흡수는 xor이므로 같은 자리에 in과 mask를 차례로 흡수
+        unsigned int base = h->pos;
+        sha3_absorb(h, in + off, piece);
+        h->pos = base;
+        sha3_absorb(h, mask + off, piece);
+        off += piece;
+
+        if (h->pos == FE_SHA3_256_RATE) {
+            fe_keccak_f1600(h->s);
+            h->pos = 0;
+        }
+    }
+}
+
+void fe_sha3_final(fe_sha3 *h, uint8_t *out) {
+    // SHA3 도메인 비트 01 + pad10*1
+    h->s[h->pos / 8] ^= (uint64_t)0x06 << (8 * (h->pos % 8));
+    h->s[(FE_SHA3_256_RATE - 1) / 8] ^= (uint64_t)0x80 << (8 * ((FE_SHA3_256_RATE - 1) % 8));
+    fe_keccak_f1600(h->s);
+    for (int i = 0; i < FE_SHA3_256_BYTES; i++)
+        out[i] = (uint8_t)(h->s[i / 8] >> (8 * (i % 8)));
+    memset(h, 0, sizeof(*h));
+}
+
+void fe_sha3_256(const uint8_t *in, size_t len, uint8_t *out) {
+    fe_sha3 h;
+    fe_sha3_init(&h);
+    fe_sha3_update(&h, in, len);
+    fe_sha3_final(&h, out);
+}
+
+/* =================================================================
+ * [Multi-buffer] lane l = 메시지 l, 흡수 블록은 lane별로 만들어 워드 단위로 전치
+ * ================================================================= */
+
+#define SHA3_RATE_WORDS (FE_SHA3_256_RATE / 8)
+
+// 메시지 a || (b ^ 오류 비트) 의 blk번째 흡수 블록 (마지막 블록이면 패딩 포함)
+static void sha3_block(const uint8_t *a, size_t alen, const uint8_t *b, size_t blen,
+                       const unsigned int *flip, size_t nflip, size_t blk, uint8_t *out) {
+    const size_t total = alen + blen;
+    const size_t off = blk * FE_SHA3_256_RATE;
+    const size_t end = (off + FE_SHA3_256_RATE < total) ? off + FE_SHA3_256_RATE : total;
+    memset(out, 0, FE_SHA3_256_RATE);
+    if (off < alen)
+        memcpy(out, a + off, ((end < alen) ? end : alen) - off);
+    if (end > alen) {
+        size_t from = (off > alen) ? off : alen;
+        memcpy(out + (from - off), b + (from - alen), end - from);
+        for (size_t k = 0; k < nflip; k++) {
+            size_t p = alen + flip[k] / 8;
+            if (p >= from && p < end)
+                out[p - off] ^= (uint8_t)(1u << (flip[k] % 8));
+        }
+    }
+    if (off + FE_SHA3_256_RATE > total) {
+        out[total - off] ^= 0x06;
+        out[FE_SHA3_256_RATE - 1] ^= 0x80;
+    }
+}
+
+// lanes개 메시지의 blk번째 블록을 w[워드][lane] 순서로 (빈 lane은 0번 메시지 복제)
+static void sha3_gather(unsigned int lanes, size_t cnt,
+                        const uint8_t *const *a, size_t alen,
+                        const uint8_t *const *b, size_t blen,
+                        const unsigned int *const *flip, const size_t *nflip,
+                        size_t blk, uint64_t *w) {
+    uint8_t buf[FE_SHA3_256_RATE];
+    for (unsigned int l = 0; l < lanes; l++) {
+        size_t i = (l < cnt) ? l : 0;
+        sha3_block(a[i], alen, b[i], blen, flip ? flip[i] : NULL, flip ? nflip[i] : 0, blk, buf);
+        for (int k = 0; k < SHA3_RATE_WORDS; k++)
+            w[k * lanes + l] = load64_le(buf + 8 * k);
+    }
+}
+
+// 출력: st[워드][lane]의 앞 4워드를 lane별 32바이트로
+static void sha3_scatter(unsigned int lanes, size_t cnt, const uint64_t *st, uint8_t *const *out) {
+    for (size_t l = 0; l < cnt; l++)
+        for (int i = 0; i < FE_SHA3_256_BYTES; i++)
+            out[l][i] = (uint8_t)(st[(i / 8) * lanes + l] >> (8 * (i % 8)));
+}
+
+#ifdef KDF_HAVE_SIMD
+#define V4_XOR(_a, _b)  _mm256_xor_si256(_a, _b)
+#define V4_ROL(_x, _n)  _mm256_or_si256(_mm256_slli_epi64(_x, _n), _mm256_srli_epi64(_x, 64 - (_n)))
+#define V4_ANDN(_a, _b) _mm256_andnot_si256(_a, _b)
+#define V4_RC(_r)       _mm256_set1_epi64x((long long)keccak_rc[_r])
+
+static KDF_TARGET_AVX2 void sha3_x4_avx2(size_t cnt, const uint8_t *const *a, size_t alen,
+                                         const uint8_t *const *b, size_t blen,
+                                         const unsigned int *const *flip, const size_t *nflip,
+                                         uint8_t *const *out) {
+    __m256i s[25], c0, c1, c2, c3, c4, d, t, u;
+    uint64_t w[SHA3_RATE_WORDS * 4];
+    const size_t nblk = (alen + blen) / FE_SHA3_256_RATE + 1;
+    for (int k = 0; k < 25; k++) s[k] = _mm256_setzero_si256();
+    for (size_t blk = 0; blk < nblk; blk++) {
+        sha3_gather(4, cnt, a, alen, b, blen, flip, nflip, blk, w);
+        for (int k = 0; k < SHA3_RATE_WORDS; k++)
+            s[k] = V4_XOR(s[k], _mm256_loadu_si256((const __m256i *)(w + 4 * k)));
+        KECCAK_ROUNDS(V4_XOR, V4_ROL, V4_ANDN, V4_RC)
+    }
+    for (int k = 0; k < 4; k++) _mm256_storeu_si256((__m256i *)(w + 4 * k), s[k]);
+    sha3_scatter(4, cnt, w, out);
+}
+
+#define V8_XOR(_a, _b)  _mm512_xor_si512(_a, _b)
+#define V8_ROL(_x, _n)  _mm512_rol_epi64(_x, _n)
+#define V8_ANDN(_a, _b) _mm512_andnot_si512(_a, _b)
+#define V8_RC(_r)       _mm512_set1_epi64((long long)keccak_rc[_r])
+
+static KDF_TARGET_AVX512 void sha3_x8_avx512(size_t cnt, const uint8_t *const *a, size_t alen,
+                                             const uint8_t *const *b, size_t blen,
+                                             const unsigned int *const *flip, const size_t *nflip,
+                                             uint8_t *const *out) {
+    __m512i s[25], c0, c1, c2, c3, c4, d, t, u;
+    uint64_t w[SHA3_RATE_WORDS * 8];
+    const size_t nblk = (alen + blen) / FE_SHA3_256_RATE + 1;
+    for (int k = 0; k < 25; k++) s[k] = _mm512_setzero_si512();
+    for (size_t blk = 0; blk < nblk; blk++) {
+        sha3_gather(8, cnt, a, alen, b, blen, flip, nflip, blk, w);
+        for (int k = 0; k < SHA3_RATE_WORDS; k++)
+            s[k] = V8_XOR(s[k], _mm512_loadu_si512((const void *)(w + 8 * k)));
+        KECCAK_ROUNDS(V8_XOR, V8_ROL, V8_ANDN, V8_RC)
+    }
+    for (int k = 0; k < 4; k++) _mm512_storeu_si512((void *)(w + 8 * k), s[k]);
+    sha3_scatter(8, cnt, w, out);
+}
+#endif
+
+unsigned int fe_sha3_lanes(unsigned int lanes) {
+    int level = gf13_simd_level();
+    if (lanes == 0 || lanes > FE_SHA3_MAX_LANES) lanes = FE_SHA3_MAX_LANES;
+    if (lanes >= 8 && level >= GF13_SIMD_AVX512) return 8;
+    if (lanes >= 4 && level >= GF13_SIMD_AVX2) return 4;
+    return 1;
+}
+
+void fe_sha3_256_multi(unsigned int lanes, size_t n,
+                       const uint8_t *const *a, size_t alen,
+                       const uint8_t *const *b, size_t blen,
+                       uint8_t *const *out) {
+    fe_sha3_256_multi_flip(lanes, n, a, alen, b, blen, NULL, NULL, out);
+}
+
+void fe_sha3_256_multi_flip(unsigned int lanes, size_t n,
+                            const uint8_t *const *a, size_t alen,
+                            const uint8_t *const *b, size_t blen,
+                            const unsigned int *const *flip, const size_t *nflip,
+                            uint8_t *const *out) {
+    size_t i = 0;
+    lanes = fe_sha3_lanes(lanes);
+#ifdef KDF_HAVE_SIMD
+    // 남은 메시지가 lane 수의 절반 이하면 한 단계 좁은 경로가 더 빠름
+    for (; lanes == 8 && i + 4 < n; i += 8) {
+        size_t cnt = (n - i < 8) ? n - i : 8;
+        sha3_x8_avx512(cnt, a + i, alen, b + i, blen,
+                       flip ? flip + i : NULL, flip ? nflip + i : NULL, out + i);
+    }
+    if (lanes == 8) lanes = 4;
+    for (; lanes == 4 && i + 1 < n; i += 4) {
+        size_t cnt = (n - i < 4) ? n - i : 4;
+        sha3_x4_avx2(cnt, a + i, alen, b + i, blen,
+                     flip ? flip + i : NULL, flip ? nflip + i : NULL, out + i);
+    }
+#endif
+    for (; i < n; i++) {
+        fe_sha3 h;
+        fe_sha3_init(&h);
+        fe_sha3_update(&h, a[i], alen);
+        fe_sha3_update_flip(&h, b[i], blen, flip ? flip[i] : NULL, flip ? nflip[i] : 0);
+        fe_sha3_final(&h, out[i]);
+    }
+}
+
+/* =================================================================
+ * [Random] salt용 OS 난수 (RtlGenRandom / getentropy, 실패 시 /dev/urandom)
+ * ================================================================= */
+
+int fe_random_bytes(uint8_t *buf, size_t len) {
+#if defined(_WIN32) || defined(_WIN64)
+    return RtlGenRandom(buf, (ULONG)len) ? 0 : -1;
+#else
+    size_t done = 0;
+    while (done < len) {
+        size_t chunk = (len - done < 256) ? len - done : 256;   // getentropy 1회 상한
+        if (getentropy(buf + done, chunk) != 0) break;
+        done += chunk;
+    }
+    if (done == len) return 0;
+
+    FILE *fp = fopen("/dev/urandom", "rb");
+    if (!fp) return -1;
+    size_t got = fread(buf + done, 1, len - done, fp);
+    fclose(fp);
+    return (got == len - done) ? 0 : -1;
+#endif
+}
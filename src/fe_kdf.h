@@ -0,0 +1,63 @@
+#ifndef FE_KDF_H
+#define FE_KDF_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* =================================================================
+ * [KDF] SHA3-256 (FIPS 202) 키 유도 / 키 커밋
+ * - 외부 라이브러리 없는 이식 가능한 Keccak-f[1600] (64비트 lane)
+ * - 키     = SHA3-256(salt || 정정된 데이터)
+ *   salt는 등록마다 새로 뽑아 helper 뒤에 붙여 저장 (같은 생체 입력도
+ *   등록마다 다른 키, 사전 계산 공격 방지)
+ * - 커밋   = SHA3-256(키 || 0xC0)
+ * ================================================================= */
+
+#define FE_SHA3_256_BYTES   32
+#define FE_SHA3_256_RATE    136     // 흡수 블록 (1600 - 2 * 256) / 8
+
+/* 점진적 해시 상태 (호출자 소유, 스택 배치 가능) */
+typedef struct {
+    uint64_t s[25];
+    unsigned int pos;       // 현재 블록에 흡수한 바이트 수
+} fe_sha3;
+
+void fe_sha3_init(fe_sha3 *h);
+void fe_sha3_update(fe_sha3 *h, const uint8_t *in, size_t len);
+/* in을 흡수하되 flip[k] (in 기준 비트 위치 byte * 8 + bit) 비트는 뒤집어 흡수.
+ * 흡수는 상태에 xor하는 것이므로 뒤집은 사본 없이 상태에 직접 xor해도 결과가 같음 */
+void fe_sha3_update_flip(fe_sha3 *h, const uint8_t *in, size_t len,
+                         const unsigned int *flip, size_t nflip);
+/* in[i] ^ mask[i]를 흡수 (상수 시간 reproduce: 오류 위치 목록 대신 오류 벡터 전체,
+ * 작업량이 오류 수와 무관) */
+void fe_sha3_update_xor(fe_sha3 *h, const uint8_t *in, const uint8_t *mask, size_t len);
+void fe_sha3_final(fe_sha3 *h, uint8_t *out);
+void fe_sha3_256(const uint8_t *in, size_t len, uint8_t *out);
+
+/* Keccak-f[1600] 순열 24라운드 */
+void fe_keccak_f1600(uint64_t *s);
+
+/* =================================================================
+ * [Multi-buffer] 같은 길이의 메시지 여러 개를 SIMD lane에 하나씩 실어 동시 해시
+ * - 메시지 i = a[i] (alen 바이트) || b[i] (blen 바이트), 출력 out[i] 32바이트
+ * - lanes: 한 번에 처리할 메시지 수 1 / 4 (AVX2) / 8 (AVX-512), 0 = CPU별 자동.
+ *   CPU가 지원하지 않으면 한 단계씩 낮춤. n은 lanes의 배수가 아니어도 됨
+ * ================================================================= */
+#define FE_SHA3_MAX_LANES   8
+
+unsigned int fe_sha3_lanes(unsigned int lanes);    // 실제로 쓰일 lane 수
+void fe_sha3_256_multi(unsigned int lanes, size_t n,
+                       const uint8_t *const *a, size_t alen,
+                       const uint8_t *const *b, size_t blen,
+                       uint8_t *const *out);
+/* 위와 같되 메시지 i의 b 부분에서 flip[i][0..nflip[i]) 비트를 뒤집어 해시 (flip == NULL이면 없음) */
+void fe_sha3_256_multi_flip(unsigned int lanes, size_t n,
+                            const uint8_t *const *a, size_t alen,
+                            const uint8_t *const *b, size_t blen,
+                            const unsigned int *const *flip, const size_t *nflip,
+                            uint8_t *const *out);
+
+/* OS 난수 (salt용): 성공 0, 실패 -1 */
+int fe_random_bytes(uint8_t *buf, size_t len);
+
+#endif // FE_KDF_H
@@ -0,0 +1,285 @@
+#include "fe_api.h"
+#include "fe_core.h"
+#include "bch_wrapper.h"
+#include "fe_kdf.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* =================================================================
+ * [Multi-block Record] 다중 블록 helper 레코드 (바이트 단위 정의, 바이트 순서 무관)
+ *   [0..4)     magic "FEHM"
+ *   [4]        버전 (MB_VERSION)
+ *   [5] [6]    m, t
+ *   [7]        flags (FE_MULTI_INTERLEAVE)
+ *   [8..12)    템플릿 바이트 수 (little-endian)
+ *   [12]       블록 수 n
+ *   [13] [14]  블록당 ECC / salt 바이트 수 (104 / 32)
+ *   [15]       키 커밋 바이트 수 (32)
+ *   [16..)     ECC[n][104] || salt || 키 커밋 SHA3-256(키 || 0xC0)
+ * ================================================================= */
+#define MB_HDR_BYTES    16
+#define MB_VERSION      1
+
+static const uint8_t mb_magic[4] = { 'F', 'E', 'H', 'M' };
+
+size_t fe_multi_blocks(size_t input_len) {
+    size_t n = (input_len + FE_DATA_BYTES - 1) / FE_DATA_BYTES;
+    return (n == 0 || n > FE_MULTI_MAX_BLOCKS) ? 0 : n;
+}
+
+size_t fe_multi_record_bytes(size_t input_len) {
+    size_t n = fe_multi_blocks(input_len);
+    return n ? MB_HDR_BYTES + n * FE_ECC_BYTES + FE_SALT_BYTES + FE_KEY_LEN : 0;
+}
+
+static void mb_header(uint8_t *hdr, size_t len, size_t n, int flags) {
+    memset(hdr, 0, MB_HDR_BYTES);
+    memcpy(hdr, mb_magic, 4);
+    hdr[4] = MB_VERSION;
+    hdr[5] = GFBITS;
+    hdr[6] = SYS_T;
+    hdr[7] = (uint8_t)flags;
+    for (int i = 0; i < 4; i++) hdr[8 + i] = (uint8_t)(len >> (8 * i));
+    hdr[12] = (uint8_t)n;
+    hdr[13] = FE_ECC_BYTES;
+    hdr[14] = FE_SALT_BYTES;
+    hdr[15] = FE_KEY_LEN;
+}
+
+/* 템플릿 -> 블록 [n][FE_DATA_BYTES] (남는 자리 0)
+ * 인터리브: 템플릿 바이트 i = 블록 i % n의 바이트 i / n */
+static void mb_split(const uint8_t *in, size_t len, size_t n, int flags, uint8_t *blocks) {
+    memset(blocks, 0, n * FE_DATA_BYTES);
+    if (!(flags & FE_MULTI_INTERLEAVE)) {
+        memcpy(blocks, in, len);
+        return;
+    }
+    for (size_t b = 0; b < n; b++) {
+        uint8_t *dst = blocks + b * FE_DATA_BYTES;
+        for (size_t i = b, k = 0; i < len; i += n, k++) dst[k] = in[i];
+    }
+}
+
+// mb_split의 역 (블록 -> 템플릿 순서, 남는 자리는 버림)
+static void mb_merge(const uint8_t *blocks, size_t len, size_t n, int flags, uint8_t *out) {
+    if (!(flags & FE_MULTI_INTERLEAVE)) {
+        memcpy(out, blocks, len);
+        return;
+    }
+    for (size_t b = 0; b < n; b++) {
+        const uint8_t *src = blocks + b * FE_DATA_BYTES;
+        for (size_t i = b, k = 0; i < len; i += n, k++) out[i] = src[k];
+    }
+}
+
+// 헤더 검사 (이 빌드의 파라미터, 템플릿 길이, 레코드 크기가 모두 맞아야 함)
+static int mb_parse(const uint8_t *record, size_t record_len, size_t input_len, int *flags) {
+    uint8_t hdr[MB_HDR_BYTES];
+    size_t n = fe_multi_blocks(input_len);
+    if (!record || n == 0 || record_len != fe_multi_record_bytes(input_len)) return FE_FAIL_PARAM;
+    if (record[7] & ~FE_MULTI_INTERLEAVE) return FE_FAIL_PARAM;
+    mb_header(hdr, input_len, n, record[7]);
+    if (memcmp(record, hdr, MB_HDR_BYTES) != 0) return FE_FAIL_PARAM;
+    *flags = record[7];
+    return FE_SUCCESS;
+}
+
+// 키 = SHA3-256(salt || (템플릿 ^ errv)), errv == NULL이면 템플릿 그대로
+static void mb_derive(const uint8_t *in, const uint8_t *errv, size_t len,
+                      const uint8_t *salt, FE_Key *key_out) {
+    fe_sha3 h;
+    fe_sha3_init(&h);
+    fe_sha3_update(&h, salt, FE_SALT_BYTES);
+    if (errv) fe_sha3_update_xor(&h, in, errv, len);
+    else fe_sha3_update(&h, in, len);
+    fe_sha3_final(&h, key_out->key);
+}
+
+int fe_enroll_multi(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    int flags,
+    uint8_t *record_out,
+    size_t *record_len,
+    uint8_t *secret_key,
+    size_t *key_len
+) {
+    FE_Key key_struct;
+    size_t n = fe_multi_blocks(input_len);
+
+    // 1. 파라미터 유효성 검사
+    if (!ctx || !input || !record_out || !record_len || !secret_key || !key_len) return FE_FAIL_PARAM;
+    if (n == 0 || (flags & ~FE_MULTI_INTERLEAVE)) return FE_FAIL_PARAM;
+    if (*record_len < fe_multi_record_bytes(input_len)) return FE_FAIL_PARAM;
+
+    uint8_t *blocks = (uint8_t *)malloc(n * FE_DATA_BYTES);
+    struct bch_workspace *ws = fe_bch_ws_create(ctx->bch);
+    uint8_t *ecc = record_out + MB_HDR_BYTES;
+    uint8_t *salt = ecc + n * FE_ECC_BYTES;
+    int ret = FE_FAIL_PARAM;
+    if (!blocks || !ws) goto out;
+
+    // 2. 블록별 ECC (레코드 안에 바로 생성) + salt
+    mb_header(record_out, input_len, n, flags);
+    mb_split(input, input_len, n, flags, blocks);
+    for (size_t b = 0; b < n; b++)
+        fe_bch_encode(ctx->bch, ws, blocks + b * FE_DATA_BYTES, ecc + b * FE_ECC_BYTES);
+    if (fe_random_bytes(salt, FE_SALT_BYTES) != 0) goto out;
+
+    // 3. 템플릿 전체에서 키 1개 + 키 커밋
+    mb_derive(input, NULL, input_len, salt, &key_struct);
+    FE_Commit_Key(&key_struct, salt + FE_SALT_BYTES);
+
+    memcpy(secret_key, key_struct.key, FE_KEY_LEN);
+    memset(&key_struct, 0, sizeof(key_struct));
+    *record_len = fe_multi_record_bytes(input_len);
+    *key_len = FE_KEY_LEN;
+    ret = FE_SUCCESS;
+
+out:
+    if (blocks) memset(blocks, 0, n * FE_DATA_BYTES);
+    free(blocks);
+    fe_bch_ws_destroy(ws);
+    return ret;
+}
+
+/* =================================================================
+ * [Multi-block Decode] 블록 [begin, end)를 워커 작업 공간으로 복호
+ * 블록마다 오류 벡터 err[b] (FE_DATA_BYTES)를 따로 채우고, 템플릿 순서로
+ * 합치는 것은 모든 블록이 끝난 뒤 호출 스레드에서 (인터리브면 블록들이
+ * 같은 바이트 구간에 섞여 있으므로)
+ * ================================================================= */
+typedef struct {
+    fe_ctx *ctx;
+    size_t n;
+    const uint8_t *blocks;          // [n][FE_DATA_BYTES] probe 블록
+    const uint8_t *ecc;             // [n][FE_ECC_BYTES] 레코드 안
+    uint8_t *err;                   // [n][FE_DATA_BYTES] 블록별 오류 벡터
+    int *nerr;                      // [n] 오류 수 또는 음수 (실패)
+    struct bch_workspace **ws;      // 워커 인덱스별 작업 공간
+    struct bch_bs64_ws **bs_ws;
+    struct bch_ct_ws **ct_ws;
+} mb_job;
+
+static void mb_decode_range(void *arg, int worker, size_t begin, size_t end) {
+    mb_job *job = (mb_job *)arg;
+    unsigned int errloc[SYS_T];
+    size_t nflip;
+
+    for (size_t b = begin; b < end; b++) {
+        const uint8_t *blk = job->blocks + b * FE_DATA_BYTES;
+        const uint8_t *ecc = job->ecc + b * FE_ECC_BYTES;
+        uint8_t *err = job->err + b * FE_DATA_BYTES;
+
+        // 상수 시간: 오류 벡터를 바로 받음
+        if (job->ctx->ct) {
+            job->nerr[b] = fe_bch_decode_ct(job->ctx->ct, job->ct_ws[worker], blk, ecc, err);
+            continue;
+        }
+        memset(err, 0, FE_DATA_BYTES);
+        job->nerr[b] = fe_bch_locate(job->ctx->bch, job->ws[worker], blk, ecc, errloc, &nflip);
+        if (job->nerr[b] < 0) continue;
+        for (size_t k = 0; k < nflip; k++) err[errloc[k] / 8] ^= (uint8_t)(1 << (errloc[k] % 8));
+    }
+}
+
+// bitsliced: 모든 블록을 한 번에 (블록 = lane, n <= 64)
+static void mb_decode_bs64(void *arg, int worker, size_t begin, size_t end) {
+    mb_job *job = (mb_job *)arg;
+    (void)begin;
+    (void)end;
+    if (fe_bch_decode_bs64(job->ctx->bs, job->bs_ws[worker], job->n, job->blocks,
+                           job->ecc, FE_ECC_BYTES, job->err, job->nerr) < 0) {
+        for (size_t b = 0; b < job->n; b++) job->nerr[b] = -1;
+        return;
+    }
+    // 정정 결과 -> 오류 벡터
+    for (size_t i = 0; i < job->n * FE_DATA_BYTES; i++) job->err[i] ^= job->blocks[i];
+}
+
+// 풀이 있으면 워커들이 블록을 나눠 복호, 없으면 호출 스레드에서 (batch_run과 같은 방식)
+static int mb_decode(mb_job *job) {
+    fe_ctx *ctx = job->ctx;
+    fe_pool_job_fn fn = ctx->bs ? mb_decode_bs64 : mb_decode_range;
+    size_t items = ctx->bs ? 1 : job->n;
+
+    if (ctx->pool) {
+        job->ws = ctx->ws;
+        job->bs_ws = ctx->bs_ws;
+        job->ct_ws = ctx->ct_ws;
+        fe_pool_run(ctx->pool, items, 1, fn, job);
+        return 0;
+    }
+
+    struct bch_workspace *local_ws = NULL;
+    struct bch_bs64_ws *local_bs_ws = NULL;
+    struct bch_ct_ws *local_ct_ws = NULL;
+    if (ctx->bs) local_bs_ws = fe_bch_bs64_ws_create(ctx->bs);
+    else if (ctx->ct) local_ct_ws = fe_bch_ct_ws_create(ctx->ct);
+    else local_ws = fe_bch_ws_create(ctx->bch);
+    if (!local_ws && !local_bs_ws && !local_ct_ws) return -1;
+    job->ws = &local_ws;
+    job->bs_ws = &local_bs_ws;
+    job->ct_ws = &local_ct_ws;
+    fn(job, 0, 0, items);
+    fe_bch_ws_destroy(local_ws);
+    fe_bch_bs64_ws_destroy(local_bs_ws);
+    fe_bch_ct_ws_destroy(local_ct_ws);
+    return 0;
+}
+
+int fe_reproduce_multi(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    const uint8_t *record,
+    size_t record_len,
+    uint8_t *recovered_key,
+    size_t *key_len
+) {
+    int nerr[FE_MULTI_MAX_BLOCKS];
+    FE_Key key_struct;
+    int flags;
+
+    // 1. 파라미터 / 레코드 헤더 검사
+    if (!ctx || !input || !recovered_key || !key_len) return FE_FAIL_PARAM;
+    if (mb_parse(record, record_len, input_len, &flags) != FE_SUCCESS) return FE_FAIL_PARAM;
+
+    size_t n = fe_multi_blocks(input_len);
+    const uint8_t *ecc = record + MB_HDR_BYTES;
+    const uint8_t *salt = ecc + n * FE_ECC_BYTES;
+    const uint8_t *commit = salt + FE_SALT_BYTES;
+
+    // probe 블록 / 블록별 오류 벡터 / 템플릿 순서 오류 벡터
+    uint8_t *buf = (uint8_t *)malloc(2 * n * FE_DATA_BYTES + input_len);
+    if (!buf) return FE_FAIL_PARAM;
+    uint8_t *blocks = buf, *err = buf + n * FE_DATA_BYTES, *errv = err + n * FE_DATA_BYTES;
+    mb_job job = { ctx, n, blocks, ecc, err, nerr, NULL, NULL, NULL };
+    int ret = FE_FAIL_DECODE;
+
+    // 2. 분할 + 블록 동시 복호
+    mb_split(input, input_len, n, flags, blocks);
+    if (mb_decode(&job) != 0) {
+        ret = FE_FAIL_PARAM;
+        goto out;
+    }
+    int failed = 0;
+    for (size_t b = 0; b < n; b++) failed |= (nerr[b] < 0);
+    if (failed && !ctx->ct) goto out;
+
+    // 3. 템플릿 전체 키 유도 (상수 시간 모드는 실패해도 수행) + 키 커밋 대조
+    mb_merge(err, input_len, n, flags, errv);
+    mb_derive(input, errv, input_len, salt, &key_struct);
+    if (FE_Check_Commit(&key_struct, commit) | failed) goto out;
+
+    memcpy(recovered_key, key_struct.key, FE_KEY_LEN);
+    *key_len = FE_KEY_LEN;
+    ret = FE_SUCCESS;
+
+out:
+    memset(&key_struct, 0, sizeof(key_struct));
+    memset(buf, 0, 2 * n * FE_DATA_BYTES + input_len);
+    free(buf);
+    return ret;
+}
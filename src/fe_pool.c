@@ -0,0 +1,251 @@
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE   // pthread_setaffinity_np
+#endif
+
+#include "fe_pool.h"
+#include "fe_thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64) && defined(__linux__)
+#include <sched.h>
+#endif
+
+/* 워커별 작업 구간 (다른 워커가 뒤쪽을 훔쳐 감) */
+typedef struct {
+    fe_mutex_t lock;
+    size_t begin;
+    size_t end;
+    char pad[64];   // 인접 워커 구간과의 false sharing 방지
+} fe_pool_range;
+
+typedef struct {
+    fe_pool *pool;
+    int id;
+} fe_pool_worker;
+
+struct fe_pool {
+    int workers;
+    int pin_cpus;
+    fe_thread_t *threads;        // workers-1 개 (워커 0은 호출 스레드)
+    fe_pool_worker *args;
+    fe_pool_range *ranges;
+
+    fe_mutex_t lock;
+    fe_cond_t start_cv;
+    fe_cond_t done_cv;
+    unsigned long generation;    // fe_pool_run 호출마다 증가
+    int pending;                 // 아직 끝나지 않은 백그라운드 워커 수
+    int shutdown;
+
+    fe_mutex_t run_lock;         // 동시에 하나의 배치만 실행
+
+    // 현재 작업
+    fe_pool_job_fn fn;
+    void *arg;
+    size_t grain;
+};
+
+// 호출 스레드를 지정한 CPU에 고정 (실패해도 동작에는 영향 없음)
+int fe_thread_pin(int cpu) {
+#if defined(_WIN32) || defined(_WIN64)
+    if (cpu < 0 || cpu >= (int)(8 * sizeof(DWORD_PTR))) return -1;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) ? 0 : -1;
+#elif defined(__linux__)
+    cpu_set_t set;
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return -1;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) ? -1 : 0;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+// 자기 구간 앞쪽에서 grain 만큼 꺼냄
+static int pool_pop(fe_pool *pool, int id, size_t *begin, size_t *end) {
+    fe_pool_range *r = &pool->ranges[id];
+    int ok = 0;
+    fe_mutex_lock(&r->lock);
+    if (r->begin < r->end) {
+        *begin = r->begin;
+        *end = (r->end - r->begin > pool->grain) ? r->begin + pool->grain : r->end;
+        r->begin = *end;
+        ok = 1;
+    }
+    fe_mutex_unlock(&r->lock);
+    return ok;
+}
+
+// 다른 워커 구간의 뒤쪽 절반을 자기 구간으로 가져옴
+static int pool_steal(fe_pool *pool, int id) {
+    for (int k = 1; k < pool->workers; k++) {
+        int victim = (id + k) % pool->workers;
+        fe_pool_range *v = &pool->ranges[victim];
+        size_t b = 0, e = 0;
+
+        fe_mutex_lock(&v->lock);
+        if (v->begin < v->end) {
+            size_t remain = v->end - v->begin;
+            size_t take = (remain > 1) ? remain / 2 : 1;
+            e = v->end;
+            b = e - take;
+            v->end = b;
+        }
+        fe_mutex_unlock(&v->lock);
+
+        if (b < e) {
+            fe_pool_range *own = &pool->ranges[id];
+            fe_mutex_lock(&own->lock);
+            own->begin = b;
+            own->end = e;
+            fe_mutex_unlock(&own->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void pool_work(fe_pool *pool, int id) {
+    size_t b, e;
+    for (;;) {
+        if (pool_pop(pool, id, &b, &e)) {
+            pool->fn(pool->arg, id, b, e);
+            continue;
+        }
+        // 모든 구간이 비었으면 종료 (처리 중인 항목은 각 워커가 마무리)
+        if (!pool_steal(pool, id)) break;
+    }
+}
+
+static void *pool_thread(void *p) {
+    fe_pool_worker *w = (fe_pool_worker *)p;
+    fe_pool *pool = w->pool;
+    unsigned long seen = 0;
+
+    if (pool->pin_cpus) fe_thread_pin(w->id % fe_cpu_count());
+
+    for (;;) {
+        fe_mutex_lock(&pool->lock);
+        while (!pool->shutdown && pool->generation == seen)
+            fe_cond_wait(&pool->start_cv, &pool->lock);
+        if (pool->shutdown) {
+            fe_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        fe_mutex_unlock(&pool->lock);
+
+        pool_work(pool, w->id);
+
+        fe_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) fe_cond_broadcast(&pool->done_cv);
+        fe_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+fe_pool *fe_pool_create(int workers, int pin_cpus) {
+    if (workers < 1) workers = 1;
+
+    fe_pool *pool = (fe_pool *)calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    pool->workers = workers;
+    pool->pin_cpus = pin_cpus;
+    pool->ranges = (fe_pool_range *)calloc(workers, sizeof(fe_pool_range));
+    pool->args = (fe_pool_worker *)calloc(workers, sizeof(fe_pool_worker));
+    pool->threads = (fe_thread_t *)calloc(workers, sizeof(fe_thread_t));
+    if (!pool->ranges || !pool->args || !pool->threads) {
+        free(pool->threads);
+        free(pool->args);
+        free(pool->ranges);
+        free(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < workers; i++) fe_mutex_init(&pool->ranges[i].lock);
+    fe_mutex_init(&pool->lock);
+    fe_mutex_init(&pool->run_lock);
+    fe_cond_init(&pool->start_cv);
+    fe_cond_init(&pool->done_cv);
+
+    // 워커 0(호출 스레드)을 제외한 백그라운드 스레드 생성
+    for (int i = 1; i < workers; i++) {
+        pool->args[i].pool = pool;
+        pool->args[i].id = i;
+        if (fe_thread_start(&pool->threads[i], pool_thread, &pool->args[i]) < 0) {
+            // 생성된 스레드만큼만 사용
+            pool->workers = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void fe_pool_destroy(fe_pool *pool) {
+    if (!pool) return;
+
+    fe_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    fe_cond_broadcast(&pool->start_cv);
+    fe_mutex_unlock(&pool->lock);
+    for (int i = 1; i < pool->workers; i++) fe_thread_join(pool->threads[i]);
+
+    for (int i = 0; i < pool->workers; i++) fe_mutex_destroy(&pool->ranges[i].lock);
+    fe_mutex_destroy(&pool->lock);
+    fe_mutex_destroy(&pool->run_lock);
+    fe_cond_destroy(&pool->start_cv);
+    fe_cond_destroy(&pool->done_cv);
+    free(pool->threads);
+    free(pool->args);
+    free(pool->ranges);
+    free(pool);
+}
+
+int fe_pool_workers(const fe_pool *pool) {
+    return pool ? pool->workers : 1;
+}
+
+void fe_pool_run(fe_pool *pool, size_t n, size_t grain, fe_pool_job_fn fn, void *arg) {
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+
+    // 워커 1개면 스레드 전환 없이 바로 실행
+    if (pool->workers == 1) {
+        fn(arg, 0, 0, n);
+        return;
+    }
+
+    fe_mutex_lock(&pool->run_lock);
+
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->grain = grain;
+
+    // 1. 초기 배정: 연속 구간으로 균등 분할
+    size_t per = n / pool->workers, extra = n % pool->workers, pos = 0;
+    for (int i = 0; i < pool->workers; i++) {
+        size_t len = per + ((size_t)i < extra ? 1 : 0);
+        pool->ranges[i].begin = pos;
+        pool->ranges[i].end = pos + len;
+        pos += len;
+    }
+
+    // 2. 백그라운드 워커 깨우기
+    fe_mutex_lock(&pool->lock);
+    pool->pending = pool->workers - 1;
+    pool->generation++;
+    fe_cond_broadcast(&pool->start_cv);
+    fe_mutex_unlock(&pool->lock);
+
+    // 3. 호출 스레드도 워커 0으로 참여
+    pool_work(pool, 0);
+
+    // 4. 모든 워커 종료 대기
+    fe_mutex_lock(&pool->lock);
+    while (pool->pending > 0) fe_cond_wait(&pool->done_cv, &pool->lock);
+    fe_mutex_unlock(&pool->lock);
+
+    fe_mutex_unlock(&pool->run_lock);
+}
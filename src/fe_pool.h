@@ -0,0 +1,31 @@
+#ifndef FE_POOL_H
+#define FE_POOL_H
+
+#include <stddef.h>
+
+/* =================================================================
+ * [Work-Stealing Thread Pool]
+ * 배치 작업 [0, n)을 워커 수만큼 연속 구간으로 나눠 배정하고,
+ * 자기 구간을 다 처리한 워커는 다른 워커 구간의 뒤쪽 절반을 가져옵니다.
+ * (에러 0개 probe는 즉시 끝나고 60개 probe는 오래 걸리므로
+ *  정적 분할만으로는 코어가 놀게 됨)
+ *
+ * 워커 0은 fe_pool_run을 호출한 스레드이며, 나머지는 풀이 소유합니다.
+ * ================================================================= */
+
+typedef struct fe_pool fe_pool;
+
+/* [begin, end) 구간 처리 콜백. worker는 0..workers-1 (워커별 자원 인덱스) */
+typedef void (*fe_pool_job_fn)(void *arg, int worker, size_t begin, size_t end);
+
+fe_pool *fe_pool_create(int workers, int pin_cpus);
+void fe_pool_destroy(fe_pool *pool);
+int fe_pool_workers(const fe_pool *pool);
+
+/* n개 항목을 grain 단위로 나눠 모든 워커에서 실행 (완료 시 반환) */
+void fe_pool_run(fe_pool *pool, size_t n, size_t grain, fe_pool_job_fn fn, void *arg);
+
+/* 호출 스레드를 cpu번 코어에 고정 (0 성공, -1 실패/미지원). 벤치마크에서도 사용 */
+int fe_thread_pin(int cpu);
+
+#endif // FE_POOL_H
@@ -0,0 +1,104 @@
+#include "fe_stats.h"
+#include "fe_api.h"
+#include "fe_thread.h"
+#include <string.h>
+
+/* =================================================================
+ * [Stats] 프로세스 전역 집계 (기록 1회 = 잠금 1회)
+ * ================================================================= */
+
+static fe_stats g_stats;
+static fe_mutex_t g_stats_lock;
+static fe_once_t g_stats_once = FE_ONCE_INIT;
+
+static void stats_init(void) {
+    fe_mutex_init(&g_stats_lock);
+}
+
+static int log2_bucket(uint64_t v) {
+    int b = 0;
+    while (v > 1 && b < FE_STATS_CYCLE_BUCKETS - 1) {
+        v >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void fe_stats_record(const fe_trace *tr) {
+    unsigned int deg = tr->failed ? FE_STATS_DEG_BUCKETS - 1 : tr->elp_deg;
+    unsigned int depth = tr->depth;
+    if (deg >= FE_STATS_DEG_BUCKETS) deg = FE_STATS_DEG_BUCKETS - 1;
+    if (depth >= FE_STATS_DEPTH_BUCKETS) depth = FE_STATS_DEPTH_BUCKETS - 1;
+
+    fe_once(&g_stats_once, stats_init);
+    fe_mutex_lock(&g_stats_lock);
+    g_stats.calls++;
+    if (tr->failed) g_stats.failures++;
+    for (int s = 0; s < FE_STAGE_MAX; s++) {
+        g_stats.cycle_sum[s] += tr->cycles[s];
+        g_stats.cycle_hist[s][log2_bucket(tr->cycles[s])]++;
+    }
+    g_stats.deg_hist[deg]++;
+    g_stats.depth_hist[depth]++;
+    fe_mutex_unlock(&g_stats_lock);
+}
+
+void fe_stats_snapshot(fe_stats *out) {
+    fe_once(&g_stats_once, stats_init);
+    fe_mutex_lock(&g_stats_lock);
+    *out = g_stats;
+    fe_mutex_unlock(&g_stats_lock);
+}
+
+void fe_stats_reset(void) {
+    fe_once(&g_stats_once, stats_init);
+    fe_mutex_lock(&g_stats_lock);
+    memset(&g_stats, 0, sizeof(g_stats));
+    fe_mutex_unlock(&g_stats_lock);
+}
+
+#ifdef FE_STATS
+static const char *stage_names[FE_STAGE_MAX] = {
+    "encode", "syndrome", "bm", "roots", "correct", "hash"
+};
+
+// 0이 아닌 구간만 "구간:개수;..." 형태로 출력
+static void dump_hist(FILE *fp, const uint64_t *hist, int n) {
+    int first = 1;
+    for (int i = 0; i < n; i++) {
+        if (!hist[i]) continue;
+        fprintf(fp, "%s%d:%llu", first ? "" : ";", i, (unsigned long long)hist[i]);
+        first = 0;
+    }
+    fputc('\n', fp);
+}
+
+int fe_stats_dump(FILE *fp) {
+    fe_stats st;
+    if (!fp) return FE_FAIL_PARAM;
+    fe_stats_snapshot(&st);
+
+    // 1. 단계별 사이클 (히스토그램 구간 k = [2^k, 2^(k+1)) 사이클)
+    fprintf(fp, "# fe_stats calls=%llu failures=%llu\n",
+            (unsigned long long)st.calls, (unsigned long long)st.failures);
+    fprintf(fp, "stage,calls,mean_cycles,log2_cycles_hist\n");
+    for (int s = 0; s < FE_STAGE_MAX; s++) {
+        fprintf(fp, "%s,%llu,%.1f,", stage_names[s], (unsigned long long)st.calls,
+                st.calls ? (double)st.cycle_sum[s] / st.calls : 0.0);
+        dump_hist(fp, st.cycle_hist[s], FE_STATS_CYCLE_BUCKETS);
+    }
+
+    // 2. 카운터 (차수 t+1 = 복구 실패)
+    fprintf(fp, "counter,hist\n");
+    fprintf(fp, "elp_degree,");
+    dump_hist(fp, st.deg_hist, FE_STATS_DEG_BUCKETS);
+    fprintf(fp, "factor_depth,");
+    dump_hist(fp, st.depth_hist, FE_STATS_DEPTH_BUCKETS);
+    return FE_SUCCESS;
+}
+#else
+int fe_stats_dump(FILE *fp) {
+    if (fp) fprintf(fp, "# fe_stats: disabled (build with -DFE_STATS=ON)\n");
+    return FE_FAIL_PARAM;
+}
+#endif
@@ -0,0 +1,89 @@
+#ifndef FE_STATS_H
+#define FE_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "bch_wrapper.h"
+
+/* =================================================================
+ * [Instrumentation] reproduce 단계별 사이클 / 카운터 히스토그램
+ * FE_STATS 빌드(cmake -DFE_STATS=ON)에서만 기록하며, 끄면 아래 매크로가
+ * 모두 빈 문장이 되어 측정 코드가 남지 않습니다.
+ * 집계는 프로세스 전역이며 여러 스레드에서 동시에 기록해도 됩니다.
+ * ================================================================= */
+
+#define FE_STAGE_ENCODE     0   // 재인코딩 + 수신 ECC xor
+#define FE_STAGE_SYNDROME   1
+#define FE_STAGE_BM         2   // 오류 위치 다항식
+#define FE_STAGE_ROOTS      3   // 근 찾기
+#define FE_STAGE_CORRECT    4   // 오류 위치 정리 (fe_bch_locate - 라이브러리 단계, 정정은 키 유도에서)
+#define FE_STAGE_HASH       5   // 키 유도
+#define FE_STAGE_MAX        6
+
+#define FE_STATS_CYCLE_BUCKETS  40            // log2(cycles) 구간
+#define FE_STATS_DEG_BUCKETS    (SYS_T + 2)   // 0..t, t+1 = 복구 실패
+#define FE_STATS_DEPTH_BUCKETS  (GFBITS + 2)  // BTA 재귀 깊이 0..m+1
+
+/* 호출 1회 기록 */
+typedef struct {
+    uint64_t cycles[FE_STAGE_MAX];
+    unsigned int elp_deg;
+    unsigned int depth;
+    int failed;
+} fe_trace;
+
+/* 누적 집계 */
+typedef struct {
+    uint64_t calls;
+    uint64_t failures;
+    uint64_t cycle_sum[FE_STAGE_MAX];
+    uint64_t cycle_hist[FE_STAGE_MAX][FE_STATS_CYCLE_BUCKETS];
+    uint64_t deg_hist[FE_STATS_DEG_BUCKETS];
+    uint64_t depth_hist[FE_STATS_DEPTH_BUCKETS];
+} fe_stats;
+
+void fe_stats_record(const fe_trace *tr);
+void fe_stats_snapshot(fe_stats *out);
+
+#ifdef FE_STATS
+#include "fe_timer.h"
+
+#define FE_TRACE_DECL(_tr)      fe_trace _tr; uint64_t _tr##_t = 0
+#define FE_TRACE_BEGIN(_tr) \
+    do { memset(&(_tr), 0, sizeof(_tr)); _tr##_t = fe_cycles(); } while (0)
+/* 라이브러리 복호 직후: 라이브러리 단계(struct bch_trace)를 복사하고 나머지를 정정 단계로 */
+#define FE_TRACE_LIB(_tr, _lt) \
+    do { uint64_t _now = fe_cycles(), _lib = 0; \
+         for (int _s = 0; _s < BCH_STAGE_MAX; _s++) { \
+             (_tr).cycles[_s] = (_lt)->cycles[_s]; _lib += (_lt)->cycles[_s]; } \
+         (_tr).cycles[FE_STAGE_CORRECT] = (_now - _tr##_t > _lib) ? _now - _tr##_t - _lib : 0; \
+         (_tr).elp_deg = (_lt)->elp_deg; \
+         (_tr).depth = (_lt)->depth; \
+         _tr##_t = _now; } while (0)
+#define FE_TRACE_DECODE(_tr, _ws)   FE_TRACE_LIB(_tr, &(_ws)->trace)
+#define FE_TRACE_STAGE(_tr, _s) \
+    do { uint64_t _now = fe_cycles(); (_tr).cycles[_s] += _now - _tr##_t; _tr##_t = _now; } while (0)
+#define FE_TRACE_END(_tr, _failed) \
+    do { (_tr).failed = (_failed); fe_stats_record(&(_tr)); } while (0)
+/* multi-buffer 키 유도: 복호 기록을 모아 두었다가 함께 쓴 해시 사이클을 건수로 나눠 기록 */
+#define FE_TRACE_POOL(_p, _n)       fe_trace _p[_n]; uint64_t _p##_t = 0
+#define FE_TRACE_SAVE(_p, _k, _tr)  do { (_p)[_k] = (_tr); } while (0)
+#define FE_TRACE_POOL_BEGIN(_p)     do { _p##_t = fe_cycles(); } while (0)
+#define FE_TRACE_POOL_END(_p, _n) \
+    do { uint64_t _c = (_n) ? (fe_cycles() - _p##_t) / (_n) : 0; \
+         for (size_t _k = 0; _k < (size_t)(_n); _k++) { \
+             (_p)[_k].cycles[FE_STAGE_HASH] = _c; FE_TRACE_END((_p)[_k], 0); } } while (0)
+#else
+#define FE_TRACE_DECL(_tr)
+#define FE_TRACE_BEGIN(_tr)         do { } while (0)
+#define FE_TRACE_LIB(_tr, _lt)      do { } while (0)
+#define FE_TRACE_DECODE(_tr, _ws)   do { } while (0)
+#define FE_TRACE_STAGE(_tr, _s)     do { } while (0)
+#define FE_TRACE_END(_tr, _failed)  do { } while (0)
+#define FE_TRACE_POOL(_p, _n)
+#define FE_TRACE_SAVE(_p, _k, _tr)  do { } while (0)
+#define FE_TRACE_POOL_BEGIN(_p)     do { } while (0)
+#define FE_TRACE_POOL_END(_p, _n)   do { } while (0)
+#endif
+
+#endif // FE_STATS_H
@@ -0,0 +1,339 @@
+#include "fe_api.h"
+#include "fe_core.h"
+#include "bch_wrapper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#endif
+
+/* =================================================================
+ * [Helper Record] 버전이 있는 단건 helper 레코드 (바이트 단위 정의, 바이트 순서 무관)
+ *   [0..4)     magic "FEHR"
+ *   [4]        버전 (FE_RECORD_VERSION)
+ *   [5] [6]    m, t
+ *   [7]        예약 (0)
+ *   [8..10)    데이터 비트 수 (little-endian, 3488)
+ *   [10] [11]  ECC / salt 바이트 수 (104 / 32)
+ *   [12]       키 커밋 바이트 수 (32)
+ *   [13..16)   예약 (0)
+ *   [16..152)  helper = ECC || salt (그대로 reproduce에 넘길 수 있음)
+ *   [152..184) 키 커밋 SHA3-256(키 || 0xC0)
+ * ================================================================= */
+#define REC_HDR_BYTES   16
+#define REC_COMMIT_OFF  (REC_HDR_BYTES + FE_HELPER_BYTES)
+
+typedef char fe_record_size_ok[(REC_COMMIT_OFF + FE_KEY_LEN == FE_RECORD_BYTES) ? 1 : -1];
+
+static const uint8_t rec_magic[4] = { 'F', 'E', 'H', 'R' };
+
+static void record_header(uint8_t *hdr) {
+    memset(hdr, 0, REC_HDR_BYTES);
+    memcpy(hdr, rec_magic, 4);
+    hdr[4] = FE_RECORD_VERSION;
+    hdr[5] = GFBITS;
+    hdr[6] = SYS_T;
+    hdr[8] = (uint8_t)((FE_DATA_BYTES * 8) & 0xFF);
+    hdr[9] = (uint8_t)((FE_DATA_BYTES * 8) >> 8);
+    hdr[10] = FE_ECC_BYTES;
+    hdr[11] = FE_SALT_BYTES;
+    hdr[12] = FE_KEY_LEN;
+}
+
+int fe_record_pack(
+    const uint8_t *helper_data,
+    size_t helper_len,
+    const uint8_t *commit,
+    size_t commit_len,
+    uint8_t *record_out,
+    size_t *record_len
+) {
+    if (!helper_data || !commit || !record_out || !record_len) return FE_FAIL_PARAM;
+    if (helper_len != FE_HELPER_BYTES || commit_len != FE_KEY_LEN) return FE_FAIL_PARAM;
+    record_header(record_out);
+    memcpy(record_out + REC_HDR_BYTES, helper_data, FE_HELPER_BYTES);
+    memcpy(record_out + REC_COMMIT_OFF, commit, FE_KEY_LEN);
+    *record_len = FE_RECORD_BYTES;
+    return FE_SUCCESS;
+}
+
+int fe_record_parse(
+    const uint8_t *record,
+    size_t record_len,
+    const uint8_t **helper_data,
+    const uint8_t **commit
+) {
+    uint8_t hdr[REC_HDR_BYTES];
+    if (!record || record_len != FE_RECORD_BYTES) return FE_FAIL_PARAM;
+    // 헤더 전체(예약 바이트 포함)가 이 빌드의 파라미터와 같아야 함
+    record_header(hdr);
+    if (memcmp(record, hdr, REC_HDR_BYTES) != 0) return FE_FAIL_PARAM;
+    if (helper_data) *helper_data = record + REC_HDR_BYTES;
+    if (commit) *commit = record + REC_COMMIT_OFF;
+    return FE_SUCCESS;
+}
+
+int fe_enroll_record(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    uint8_t *record_out,
+    size_t *record_len,
+    uint8_t *secret_key,
+    size_t *key_len
+) {
+    FE_Key key_struct;
+    if (!ctx || !input || !record_out || !record_len || !secret_key || !key_len) return FE_FAIL_PARAM;
+    if (input_len != FE_DATA_BYTES) return FE_FAIL_PARAM;
+
+    // helper는 레코드 안에 바로 생성
+    record_header(record_out);
+    if (FE_Gen_Ctx(ctx, input, record_out + REC_HDR_BYTES, &key_struct) < 0) {
+        memset(&key_struct, 0, sizeof(key_struct));
+        return FE_FAIL_PARAM;
+    }
+    FE_Commit_Key(&key_struct, record_out + REC_COMMIT_OFF);
+
+    memcpy(secret_key, key_struct.key, FE_KEY_LEN);
+    memset(&key_struct, 0, sizeof(key_struct));
+    *record_len = FE_RECORD_BYTES;
+    *key_len = FE_KEY_LEN;
+    return FE_SUCCESS;
+}
+
+int fe_reproduce_record(
+    fe_ctx *ctx,
+    const uint8_t *input,
+    size_t input_len,
+    const uint8_t *record,
+    size_t record_len,
+    uint8_t *recovered_key,
+    size_t *key_len
+) {
+    const uint8_t *helper, *commit;
+    FE_Key key_struct = { { 0 } };
+
+    // 1. 파라미터 / 레코드 헤더 검사
+    if (!ctx || !input || !recovered_key || !key_len) return FE_FAIL_PARAM;
+    if (input_len != FE_DATA_BYTES) return FE_FAIL_PARAM;
+    if (fe_record_parse(record, record_len, &helper, &commit) != FE_SUCCESS) return FE_FAIL_PARAM;
+
+    // 2. 복원 후 키 커밋 확인 (t를 넘는 오류가 다른 코드워드로 잘못 정정된 경우 거절).
+    //    상수 시간 모드는 복호 실패 (키 0)에도 같은 대조를 거침
+    int failed = FE_Rep_Ctx(ctx, input, helper, &key_struct) < 0;
+    if (failed && !ctx->ct) return FE_FAIL_DECODE;
+    if (FE_Check_Commit(&key_struct, commit) | failed) {
+        memset(&key_struct, 0, sizeof(key_struct));
+        return FE_FAIL_DECODE;
+    }
+
+    memcpy(recovered_key, key_struct.key, FE_KEY_LEN);
+    memset(&key_struct, 0, sizeof(key_struct));
+    *key_len = FE_KEY_LEN;
+    return FE_SUCCESS;
+}
+
+/* =================================================================
+ * [Store] 열 단위 등록 저장소 파일 (native-endian, mmap 후 그대로 사용)
+ *   헤더 64바이트 (store_hdr)
+ *   helpers : [count][FE_HELPER_BYTES] ECC || salt   (배치 reproduce의 helpers 배열)
+ *   commits : [count][FE_KEY_LEN]                     (키 커밋)
+ *   syn     : [count][SYS_T] uint16                    (갤러리 prescreen용 helper 신드롬)
+ * 각 열은 STORE_ALIGN 경계에서 시작하며 항목 간격은 고정.
+ * 열 배치가 갤러리 메모리 배치와 같아서 파싱 / 복사 없이 포인터만 연결
+ * ================================================================= */
+#define STORE_MAGIC     0x54534546u     // "FEST"
+#define STORE_VERSION   1
+#define STORE_ALIGN     64
+
+struct store_hdr {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t m;
+    uint8_t t;
+    uint32_t data_bits;
+    uint16_t helper_bytes;
+    uint16_t commit_bytes;
+    uint64_t count;
+    uint64_t off_helpers;
+    uint64_t off_commits;
+    uint64_t off_syn;
+    uint64_t size;
+    uint64_t check;         // 위 필드의 FNV-1a
+};
+
+typedef char store_hdr_size_ok[(sizeof(struct store_hdr) == STORE_ALIGN) ? 1 : -1];
+
+struct fe_store {
+    fe_tables_map *map;
+    size_t count;
+    const uint8_t *helpers;
+    const uint8_t *commits;
+    const uint16_t *syn;
+};
+
+static uint64_t store_align(uint64_t off) {
+    return (off + STORE_ALIGN - 1) & ~(uint64_t)(STORE_ALIGN - 1);
+}
+
+static uint64_t store_hdr_check(const struct store_hdr *hdr) {
+    const uint8_t *p = (const uint8_t *)hdr;
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < offsetof(struct store_hdr, check); i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// 열 배치 계산 (쓰기 / 검사 공용)
+static void store_layout(struct store_hdr *hdr, uint64_t count) {
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = STORE_MAGIC;
+    hdr->version = STORE_VERSION;
+    hdr->m = GFBITS;
+    hdr->t = SYS_T;
+    hdr->data_bits = FE_DATA_BYTES * 8;
+    hdr->helper_bytes = FE_HELPER_BYTES;
+    hdr->commit_bytes = FE_KEY_LEN;
+    hdr->count = count;
+    hdr->off_helpers = sizeof(*hdr);
+    hdr->off_commits = store_align(hdr->off_helpers + count * FE_HELPER_BYTES);
+    hdr->off_syn = store_align(hdr->off_commits + count * FE_KEY_LEN);
+    hdr->size = store_align(hdr->off_syn + count * SYS_T * sizeof(uint16_t));
+    hdr->check = store_hdr_check(hdr);
+}
+
+static int store_pad(FILE *fp, uint64_t from, uint64_t to) {
+    static const uint8_t zero[STORE_ALIGN];
+    return (to > from && fwrite(zero, 1, (size_t)(to - from), fp) != (size_t)(to - from)) ? -1 : 0;
+}
+
+int FE_Store_Write(const struct bch_control *bch, const char *path, size_t count,
+                   const uint8_t *helpers, size_t helper_stride,
+                   const uint8_t *commits, size_t commit_stride,
+                   const uint16_t *syn) {
+    struct store_hdr hdr;
+    struct bch_workspace *ws = NULL;
+    unsigned int s[2 * SYS_T];
+    uint16_t row[SYS_T];
+    int ret = -1;
+
+    if (!path || (count && (!helpers || !commits))) return -1;
+    if (!syn) {
+        ws = fe_bch_ws_create(bch);
+        if (!ws) return -1;
+    }
+    char *tmp = (char *)malloc(strlen(path) + 5);
+    if (!tmp) goto out;
+    sprintf(tmp, "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) goto out;
+
+    // 1. 헤더
+    store_layout(&hdr, count);
+    int err = fwrite(&hdr, sizeof(hdr), 1, fp) != 1;
+
+    // 2. 열별 기록 (입력 간격은 레코드 배열 / 갤러리 열 모두 허용)
+    for (size_t i = 0; i < count && !err; i++)
+        err = fwrite(helpers + i * helper_stride, FE_HELPER_BYTES, 1, fp) != 1;
+    if (!err) err = store_pad(fp, hdr.off_helpers + count * FE_HELPER_BYTES, hdr.off_commits);
+    for (size_t i = 0; i < count && !err; i++)
+        err = fwrite(commits + i * commit_stride, FE_KEY_LEN, 1, fp) != 1;
+    if (!err) err = store_pad(fp, hdr.off_commits + count * FE_KEY_LEN, hdr.off_syn);
+    for (size_t i = 0; i < count && !err; i++) {
+        if (syn) {
+            err = fwrite(syn + i * SYS_T, sizeof(row), 1, fp) != 1;
+            continue;
+        }
+        fe_bch_ecc_syndromes(bch, ws, helpers + i * helper_stride, s);
+        for (int j = 0; j < SYS_T; j++) row[j] = (uint16_t)s[2 * j];
+        err = fwrite(row, sizeof(row), 1, fp) != 1;
+    }
+    if (!err) err = store_pad(fp, hdr.off_syn + count * SYS_T * sizeof(uint16_t), hdr.size);
+
+    // 3. 완성된 파일로 교체 (이미 연 프로세스는 이전 파일을 계속 봄)
+    if (fclose(fp) != 0 || err) {
+        remove(tmp);
+        goto out;
+    }
+#if defined(_WIN32) || defined(_WIN64)
+    if (!MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (rename(tmp, path) != 0) {
+#endif
+        remove(tmp);
+        goto out;
+    }
+    ret = 0;
+
+out:
+    free(tmp);
+    fe_bch_ws_destroy(ws);
+    return ret;
+}
+
+int fe_store_write(fe_ctx *ctx, const char *path, const uint8_t *records, size_t count) {
+    if (!ctx || !path || !records) return FE_FAIL_PARAM;
+    for (size_t i = 0; i < count; i++) {
+        if (fe_record_parse(records + i * FE_RECORD_BYTES, FE_RECORD_BYTES, NULL, NULL) != FE_SUCCESS)
+            return FE_FAIL_PARAM;
+    }
+    return FE_Store_Write(ctx->bch, path, count,
+                          records + REC_HDR_BYTES, FE_RECORD_BYTES,
+                          records + REC_COMMIT_OFF, FE_RECORD_BYTES, NULL) == 0 ? FE_SUCCESS : FE_FAIL_PARAM;
+}
+
+fe_store *fe_store_open(const char *path) {
+    struct store_hdr hdr, want;
+    fe_tables_map *map = fe_tables_map_file(path);
+    if (!map) return NULL;
+    const uint8_t *base = (const uint8_t *)fe_tables_data(map);
+    size_t size = fe_tables_size(map);
+
+    // 1. 헤더 검사: 항목 수로 다시 계산한 배치와 완전히 같아야 함 (항목은 검사하지 않음)
+    if (size < sizeof(hdr)) goto fail;
+    memcpy(&hdr, base, sizeof(hdr));
+    if (hdr.magic != STORE_MAGIC || hdr.version != STORE_VERSION) goto fail;
+    if (hdr.count > size / (FE_HELPER_BYTES + FE_KEY_LEN + SYS_T * sizeof(uint16_t))) goto fail;
+    store_layout(&want, hdr.count);
+    if (memcmp(&hdr, &want, sizeof(hdr)) != 0 || hdr.size > size) goto fail;
+
+    // 2. 열 포인터는 매핑 안을 직접 가리킴
+    fe_store *store = (fe_store *)calloc(1, sizeof(*store));
+    if (!store) goto fail;
+    store->map = map;
+    store->count = (size_t)hdr.count;
+    store->helpers = base + hdr.off_helpers;
+    store->commits = base + hdr.off_commits;
+    store->syn = (const uint16_t *)(base + hdr.off_syn);
+    return store;
+
+fail:
+    fe_tables_unmap(map);
+    return NULL;
+}
+
+void fe_store_close(fe_store *store) {
+    if (!store) return;
+    fe_tables_unmap(store->map);
+    free(store);
+}
+
+size_t fe_store_count(const fe_store *store) {
+    return store ? store->count : 0;
+}
+
+const uint8_t *fe_store_helpers(const fe_store *store) {
+    return store ? store->helpers : NULL;
+}
+
+const uint8_t *fe_store_commits(const fe_store *store) {
+    return store ? store->commits : NULL;
+}
+
+const uint16_t *FE_Store_Syn(const fe_store *store) {
+    return store ? store->syn : NULL;
+}
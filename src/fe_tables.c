@@ -0,0 +1,140 @@
+#include "fe_tables.h"
+#include "../lib/bch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+struct fe_tables_map {
+    const void *data;
+    size_t size;
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+/* =================================================================
+ * [Save] 이미지를 임시 파일에 쓴 뒤 교체
+ * ================================================================= */
+int fe_tables_save(const struct bch_control *bch, const char *path) {
+    if (!bch || !path) return -1;
+    size_t size = bch_image_size(bch);
+    void *image = malloc(size);
+    char *tmp = (char *)malloc(strlen(path) + 5);
+    int ret = -1;
+    if (!image || !tmp) goto out;
+
+    // 1. 메모리에 직렬화
+    if (bch_image_write(bch, image, size) != size) goto out;
+
+    // 2. path.tmp에 기록
+    sprintf(tmp, "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    if (!fp) goto out;
+    size_t written = fwrite(image, 1, size, fp);
+    if (fclose(fp) != 0 || written != size) {
+        remove(tmp);
+        goto out;
+    }
+
+    // 3. 완성된 파일로 교체 (이미 매핑한 프로세스는 이전 파일을 계속 봄)
+#if defined(_WIN32) || defined(_WIN64)
+    if (!MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING)) {
+#else
+    if (rename(tmp, path) != 0) {
+#endif
+        remove(tmp);
+        goto out;
+    }
+    ret = 0;
+
+out:
+    free(tmp);
+    free(image);
+    return ret;
+}
+
+/* =================================================================
+ * [Map] 읽기 전용 매핑
+ * ================================================================= */
+#if defined(_WIN32) || defined(_WIN64)
+
+fe_tables_map *fe_tables_map_file(const char *path) {
+    LARGE_INTEGER len;
+    if (!path) return NULL;
+    fe_tables_map *map = (fe_tables_map *)calloc(1, sizeof(*map));
+    if (!map) return NULL;
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(map->file, &len) || len.QuadPart <= 0)
+        goto fail;
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map->mapping) goto fail;
+    map->data = MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) goto fail;
+    map->size = (size_t)len.QuadPart;
+    return map;
+
+fail:
+    fe_tables_unmap(map);
+    return NULL;
+}
+
+void fe_tables_unmap(fe_tables_map *map) {
+    if (!map) return;
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle(map->mapping);
+    if (map->file && map->file != INVALID_HANDLE_VALUE) CloseHandle(map->file);
+    free(map);
+}
+
+#else
+
+fe_tables_map *fe_tables_map_file(const char *path) {
+    struct stat st;
+    if (!path) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    // MAP_SHARED + PROT_READ: 페이지 캐시를 그대로 공유 (매핑 후 fd는 필요 없음)
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+
+    fe_tables_map *map = (fe_tables_map *)calloc(1, sizeof(*map));
+    if (!map) {
+        munmap(data, (size_t)st.st_size);
+        return NULL;
+    }
+    map->data = data;
+    map->size = (size_t)st.st_size;
+    return map;
+}
+
+void fe_tables_unmap(fe_tables_map *map) {
+    if (!map) return;
+    munmap((void *)map->data, map->size);
+    free(map);
+}
+
+#endif
+
+const void *fe_tables_data(const fe_tables_map *map) {
+    return map ? map->data : NULL;
+}
+
+size_t fe_tables_size(const fe_tables_map *map) {
+    return map ? map->size : 0;
+}
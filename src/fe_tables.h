@@ -0,0 +1,24 @@
+#ifndef FE_TABLES_H
+#define FE_TABLES_H
+
+#include <stddef.h>
+
+/* =================================================================
+ * [Table File] 미리 만든 BCH 테이블 이미지 파일 (lib/bch.h bch_image_write 형식)
+ * - 저장: 임시 파일에 다 쓴 뒤 rename (읽는 프로세스가 쓰는 중인 파일을 보지 않음)
+ * - 로드: 읽기 전용 mmap. 한 호스트의 모든 프로세스가 같은 물리 페이지를 공유하고
+ *   테이블 생성(생성 다항식, mod8_tab, deg2 base) 없이 바로 시작
+ * - 버전 / 파라미터 / 인코더 / 체크섬 검사는 init_bch_image가 하며,
+ *   맞지 않으면 호출자(FE_Ctx_Create)가 테이블을 직접 계산
+ * ================================================================= */
+
+struct bch_control;
+typedef struct fe_tables_map fe_tables_map;
+
+int fe_tables_save(const struct bch_control *bch, const char *path);   // 0 성공, -1 실패
+fe_tables_map *fe_tables_map_file(const char *path);                    // 파일 없음 / 실패 시 NULL
+const void *fe_tables_data(const fe_tables_map *map);
+size_t fe_tables_size(const fe_tables_map *map);
+void fe_tables_unmap(fe_tables_map *map);
+
+#endif // FE_TABLES_H
@@ -0,0 +1,114 @@
+#ifndef FE_THREAD_H
+#define FE_THREAD_H
+
+#include <stdlib.h>
+
+/* =================================================================
+ * [Portable Thread] Windows / POSIX 공통 최소 스레드 래퍼
+ * ================================================================= */
+
+typedef void *(*fe_thread_fn)(void *);
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+
+    typedef HANDLE             fe_thread_t;
+    typedef INIT_ONCE          fe_once_t;
+    typedef CRITICAL_SECTION   fe_mutex_t;
+    typedef CONDITION_VARIABLE fe_cond_t;
+    #define FE_ONCE_INIT INIT_ONCE_STATIC_INIT
+
+    typedef struct {
+        fe_thread_fn fn;
+        void *arg;
+    } fe_thread_start_arg;
+
+    static DWORD WINAPI fe_thread_trampoline(LPVOID p) {
+        fe_thread_start_arg a = *(fe_thread_start_arg *)p;
+        free(p);
+        a.fn(a.arg);
+        return 0;
+    }
+
+    static inline int fe_thread_start(fe_thread_t *th, fe_thread_fn fn, void *arg) {
+        fe_thread_start_arg *a = (fe_thread_start_arg *)malloc(sizeof(*a));
+        if (!a) return -1;
+        a->fn = fn;
+        a->arg = arg;
+        *th = CreateThread(NULL, 0, fe_thread_trampoline, a, 0, NULL);
+        if (!*th) {
+            free(a);
+            return -1;
+        }
+        return 0;
+    }
+
+    static inline void fe_thread_join(fe_thread_t th) {
+        WaitForSingleObject(th, INFINITE);
+        CloseHandle(th);
+    }
+
+    static BOOL CALLBACK fe_once_trampoline(PINIT_ONCE once, PVOID fn, PVOID *ctx) {
+        (void)once; (void)ctx;
+        ((void (*)(void))fn)();
+        return TRUE;
+    }
+
+    static inline void fe_once(fe_once_t *once, void (*fn)(void)) {
+        InitOnceExecuteOnce(once, fe_once_trampoline, (PVOID)fn, NULL);
+    }
+
+    static inline int fe_cpu_count(void) {
+        SYSTEM_INFO si;
+        GetSystemInfo(&si);
+        return (int)si.dwNumberOfProcessors;
+    }
+
+    static inline void fe_mutex_init(fe_mutex_t *m)    { InitializeCriticalSection(m); }
+    static inline void fe_mutex_destroy(fe_mutex_t *m) { DeleteCriticalSection(m); }
+    static inline void fe_mutex_lock(fe_mutex_t *m)    { EnterCriticalSection(m); }
+    static inline void fe_mutex_unlock(fe_mutex_t *m)  { LeaveCriticalSection(m); }
+
+    static inline void fe_cond_init(fe_cond_t *c)      { InitializeConditionVariable(c); }
+    static inline void fe_cond_destroy(fe_cond_t *c)   { (void)c; }
+    static inline void fe_cond_wait(fe_cond_t *c, fe_mutex_t *m) { SleepConditionVariableCS(c, m, INFINITE); }
+    static inline void fe_cond_broadcast(fe_cond_t *c) { WakeAllConditionVariable(c); }
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+
+    typedef pthread_t       fe_thread_t;
+    typedef pthread_once_t  fe_once_t;
+    typedef pthread_mutex_t fe_mutex_t;
+    typedef pthread_cond_t  fe_cond_t;
+    #define FE_ONCE_INIT PTHREAD_ONCE_INIT
+
+    static inline int fe_thread_start(fe_thread_t *th, fe_thread_fn fn, void *arg) {
+        return pthread_create(th, NULL, fn, arg) ? -1 : 0;
+    }
+
+    static inline void fe_thread_join(fe_thread_t th) {
+        pthread_join(th, NULL);
+    }
+
+    static inline void fe_once(fe_once_t *once, void (*fn)(void)) {
+        pthread_once(once, fn);
+    }
+
+    static inline int fe_cpu_count(void) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        return (n > 0) ? (int)n : 1;
+    }
+
+    static inline void fe_mutex_init(fe_mutex_t *m)    { pthread_mutex_init(m, NULL); }
+    static inline void fe_mutex_destroy(fe_mutex_t *m) { pthread_mutex_destroy(m); }
+    static inline void fe_mutex_lock(fe_mutex_t *m)    { pthread_mutex_lock(m); }
+    static inline void fe_mutex_unlock(fe_mutex_t *m)  { pthread_mutex_unlock(m); }
+
+    static inline void fe_cond_init(fe_cond_t *c)      { pthread_cond_init(c, NULL); }
+    static inline void fe_cond_destroy(fe_cond_t *c)   { pthread_cond_destroy(c); }
+    static inline void fe_cond_wait(fe_cond_t *c, fe_mutex_t *m) { pthread_cond_wait(c, m); }
+    static inline void fe_cond_broadcast(fe_cond_t *c) { pthread_cond_broadcast(c); }
+#endif
+
+#endif // FE_THREAD_H
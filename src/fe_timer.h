@@ -0,0 +1,48 @@
+#ifndef FE_TIMER_H
+#define FE_TIMER_H
+
+#include <stdint.h>
+
+/* =================================================================
+ * [Portable Timer] 벤치마크용 단조 시계 / 사이클 카운터
+ * - fe_time_ns : 단조 증가 나노초 (QPC / CLOCK_MONOTONIC)
+ * - fe_cycles  : x86이면 rdtsc, 아니면 fe_time_ns 값
+ * ================================================================= */
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+
+    static inline uint64_t fe_time_ns(void) {
+        static double ns_per_tick = 0.0;
+        LARGE_INTEGER li;
+        if (ns_per_tick == 0.0) {
+            QueryPerformanceFrequency(&li);
+            ns_per_tick = 1e9 / (double)li.QuadPart;
+        }
+        QueryPerformanceCounter(&li);
+        return (uint64_t)((double)li.QuadPart * ns_per_tick);
+    }
+#else
+    #include <time.h>
+
+    static inline uint64_t fe_time_ns(void) {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    }
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define FE_HAVE_TSC 1
+    static inline uint64_t fe_cycles(void) { return __rdtsc(); }
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define FE_HAVE_TSC 1
+    static inline uint64_t fe_cycles(void) { return __rdtsc(); }
+#else
+    #define FE_HAVE_TSC 0
+    static inline uint64_t fe_cycles(void) { return fe_time_ns(); }
+#endif
+
+#endif // FE_TIMER_H
@@ -3,38 +3,32 @@
 #include <string.h>
 #include <stdint.h>
 #include <math.h>
-#include <windows.h> // 고정밀 타이머용 (Windows)
 
 #include "fe_api.h"
 #include "fe_core.h" 
 #include "bch_wrapper.h"
+#include "fe_thread.h"
+#include "fe_timer.h"
+#include "../lib/bch.h"
 
 
 #define MAX_ERRORS  63    // 0 ~ 63 비트 에러까지 측정
 #define NUM_TRIALS  100   // 반복 횟수 100회
 
 // [유틸리티] 시간 측정 및 통계
-// 윈도우 고정밀 타이머 주파수
-double pc_freq = 0.0;
-int64_t timer_start = 0;
+// 단조 시계 (fe_timer.h: Windows QPC / POSIX CLOCK_MONOTONIC)
+uint64_t timer_start = 0;
 
 void timer_init() {
-    LARGE_INTEGER li;
-    if(!QueryPerformanceFrequency(&li))
-        printf("QueryPerformanceFrequency failed!\n");
-    pc_freq = (double)li.QuadPart / 1000000.0; // 마이크로초(us) 단위
+    fe_time_ns();   // Windows: QPC 주파수 1회 조회
 }
 
 void timer_tic() {
-    LARGE_INTEGER li;
-    QueryPerformanceCounter(&li);
-    timer_start = li.QuadPart;
+    timer_start = fe_time_ns();
 }
 
 double timer_toc() {
-    LARGE_INTEGER li;
-    QueryPerformanceCounter(&li);
-    return (double)(li.QuadPart - timer_start) / pc_freq;
+    return (double)(fe_time_ns() - timer_start) / 1000.0;   // 마이크로초(us) 단위
 }
 
 // 정렬을 위한 비교 함수 (qsort용)
@@ -69,19 +63,475 @@ void inject_random_noise(uint8_t *data, int len, int error_cnt) {
     free(indices);
 }
 
+// 측정 결과 요약 (정렬 후 평균/중앙값/백분위/표준편차)
+typedef struct {
+    double mean, median, p05, p95, stddev;
+} TimeStats;
+
+void summarize(double *times, int n, TimeStats *st) {
+    qsort(times, n, sizeof(double), compare_doubles);
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += times[i];
+    st->mean = sum / n;
+
+    st->median = times[n / 2];
+    st->p05 = times[(int)(n * 0.05)];
+    st->p95 = times[(int)(n * 0.95)];
+
+    double variance_sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        variance_sum += pow(times[i] - st->mean, 2);
+    }
+    st->stddev = sqrt(variance_sum / n);
+}
+
+// [벤치마크] 호출당 비용: 매 호출마다 테이블 재생성(before) vs 컨텍스트 재사용(after)
+#define CTX_TRIALS  200
+#define CTX_ERRORS  32
+
+void run_ctx_bench(void) {
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t noisy_input[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t h_len = FE_HELPER_BYTES;
+    size_t k_len = FE_KEY_LEN;
+    double enroll_cold[CTX_TRIALS], enroll_warm[CTX_TRIALS];
+    double rep_cold[CTX_TRIALS], rep_warm[CTX_TRIALS];
+    TimeStats st;
+
+    fe_ctx *ctx = fe_ctx_create();
+    if (!ctx) {
+        printf("fe_ctx_create failed!\n");
+        return;
+    }
+
+    for (int t = 0; t < CTX_TRIALS; t++) {
+        for (int i = 0; i < FE_DATA_BYTES; i++) input[i] = rand() & 0xFF;
+
+        // before: 호출마다 컨텍스트(테이블) 생성 + 해제
+        timer_tic();
+        fe_ctx *tmp = fe_ctx_create();
+        fe_enroll_ctx(tmp, input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len);
+        fe_ctx_destroy(tmp);
+        enroll_cold[t] = timer_toc();
+
+        // after: 영속 컨텍스트 재사용
+        timer_tic();
+        fe_enroll_ctx(ctx, input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len);
+        enroll_warm[t] = timer_toc();
+
+        memcpy(noisy_input, input, FE_DATA_BYTES);
+        inject_random_noise(noisy_input, FE_DATA_BYTES, CTX_ERRORS);
+        timer_tic();
+        tmp = fe_ctx_create();
+        fe_reproduce_ctx(tmp, noisy_input, FE_DATA_BYTES, helper, h_len, key_rec, &k_len);
+        fe_ctx_destroy(tmp);
+        rep_cold[t] = timer_toc();
+
+        memcpy(noisy_input, input, FE_DATA_BYTES);
+        inject_random_noise(noisy_input, FE_DATA_BYTES, CTX_ERRORS);
+        timer_tic();
+        fe_reproduce_ctx(ctx, noisy_input, FE_DATA_BYTES, helper, h_len, key_rec, &k_len);
+        rep_warm[t] = timer_toc();
+    }
+    fe_ctx_destroy(ctx);
+
+    printf("op,mode,calls,mean_us,median_us,p05_us,p95_us,stddev_us\n");
+    summarize(enroll_cold, CTX_TRIALS, &st);
+    printf("enroll,rebuild,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", CTX_TRIALS, st.mean, st.median, st.p05, st.p95, st.stddev);
+    summarize(enroll_warm, CTX_TRIALS, &st);
+    printf("enroll,ctx,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", CTX_TRIALS, st.mean, st.median, st.p05, st.p95, st.stddev);
+    summarize(rep_cold, CTX_TRIALS, &st);
+    printf("reproduce,rebuild,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", CTX_TRIALS, st.mean, st.median, st.p05, st.p95, st.stddev);
+    summarize(rep_warm, CTX_TRIALS, &st);
+    printf("reproduce,ctx,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", CTX_TRIALS, st.mean, st.median, st.p05, st.p95, st.stddev);
+}
+
+// [벤치마크] 멀티스레드 처리량: 하나의 컨텍스트(공유 테이블)를 N개 스레드가 동시 사용
+#define MT_POOL     64     // 사전 생성 (input, helper) 쌍
+#define MT_PROBES   2000   // 스레드당 reproduce 호출 수
+#define MT_ERRORS   32
+
+typedef struct {
+    fe_ctx *ctx;
+    const uint8_t *noisy;    // MT_POOL * FE_DATA_BYTES
+    const uint8_t *helpers;  // MT_POOL * FE_HELPER_BYTES
+    int success;
+} MtArg;
+
+void *mt_worker(void *p) {
+    MtArg *a = (MtArg *)p;
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t k_len = FE_KEY_LEN;
+
+    for (int i = 0; i < MT_PROBES; i++) {
+        int idx = i % MT_POOL;
+        // reproduce는 입력을 수정하지 않으므로 공유 풀을 그대로 넘김
+        if (fe_reproduce_ctx(a->ctx, a->noisy + idx * FE_DATA_BYTES, FE_DATA_BYTES,
+                             a->helpers + idx * FE_HELPER_BYTES, FE_HELPER_BYTES,
+                             key_rec, &k_len) == FE_SUCCESS)
+            a->success++;
+    }
+    return NULL;
+}
+
+void run_mt_bench(int max_threads) {
+    static uint8_t noisy[MT_POOL * FE_DATA_BYTES];
+    static uint8_t helpers[MT_POOL * FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    size_t h_len = FE_HELPER_BYTES;
+    size_t k_len = FE_KEY_LEN;
+    double base_rate = 0.0;
+
+    fe_ctx *ctx = fe_ctx_create();
+    MtArg *args = (MtArg *)calloc(max_threads, sizeof(MtArg));
+    fe_thread_t *th = (fe_thread_t *)calloc(max_threads, sizeof(fe_thread_t));
+    if (!ctx || !args || !th) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+
+    for (int p = 0; p < MT_POOL; p++) {
+        uint8_t *in = noisy + p * FE_DATA_BYTES;
+        for (int i = 0; i < FE_DATA_BYTES; i++) in[i] = rand() & 0xFF;
+        fe_enroll_ctx(ctx, in, FE_DATA_BYTES, helpers + p * FE_HELPER_BYTES, &h_len, key_org, &k_len);
+        inject_random_noise(in, FE_DATA_BYTES, MT_ERRORS);
+    }
+
+    printf("threads,probes,elapsed_us,probes_per_sec,speedup,efficiency\n");
+    for (int n = 1; n <= max_threads; n++) {
+        int success = 0;
+        timer_tic();
+        for (int i = 0; i < n; i++) {
+            args[i].ctx = ctx;
+            args[i].noisy = noisy;
+            args[i].helpers = helpers;
+            args[i].success = 0;
+            fe_thread_start(&th[i], mt_worker, &args[i]);
+        }
+        for (int i = 0; i < n; i++) {
+            fe_thread_join(th[i]);
+            success += args[i].success;
+        }
+        double elapsed_us = timer_toc();
+
+        double rate = (double)n * MT_PROBES / (elapsed_us / 1e6);
+        if (n == 1) base_rate = rate;
+        if (success != n * MT_PROBES)
+            printf("# warning: %d/%d probes failed\n", n * MT_PROBES - success, n * MT_PROBES);
+        printf("%d,%d,%.1f,%.1f,%.2f,%.2f\n", n, n * MT_PROBES, elapsed_us,
+               rate, rate / base_rate, rate / base_rate / n);
+    }
+
+out:
+    free(th);
+    free(args);
+    fe_ctx_destroy(ctx);
+}
+
+// [벤치마크] 배치 처리량: 단건 호출 반복 vs fe_reproduce_batch (probes/sec)
+#define BATCH_POOL     1024   // 사전 생성 probe 수 (에러 0..63 균등)
+#define BATCH_ROUNDS   4
+
+void run_batch_bench(void) {
+    static const int batch_sizes[] = { 1, 8, 64, 256, 1024 };
+    uint8_t *inputs = (uint8_t *)malloc(BATCH_POOL * FE_DATA_BYTES);
+    uint8_t *helpers = (uint8_t *)malloc(BATCH_POOL * FE_HELPER_BYTES);
+    uint8_t *keys = (uint8_t *)malloc(BATCH_POOL * FE_KEY_LEN);
+    int *status = (int *)malloc(BATCH_POOL * sizeof(int));
+    size_t k_len = FE_KEY_LEN;
+    fe_ctx *ctx = fe_ctx_create();
+
+    if (!inputs || !helpers || !keys || !status || !ctx) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+
+    for (int i = 0; i < BATCH_POOL * FE_DATA_BYTES; i++) inputs[i] = rand() & 0xFF;
+    fe_enroll_batch(ctx, inputs, BATCH_POOL, helpers, keys, status);
+    for (int p = 0; p < BATCH_POOL; p++)
+        inject_random_noise(inputs + p * FE_DATA_BYTES, FE_DATA_BYTES, rand() % (MAX_ERRORS + 1));
+
+    printf("mode,batch,probes,elapsed_us,probes_per_sec\n");
+
+    // 단건 호출 기준선
+    timer_tic();
+    for (int r = 0; r < BATCH_ROUNDS; r++) {
+        for (int p = 0; p < BATCH_POOL; p++) {
+            fe_reproduce_ctx(ctx, inputs + p * FE_DATA_BYTES, FE_DATA_BYTES, helpers + p * FE_HELPER_BYTES,
+                             FE_HELPER_BYTES, keys + p * FE_KEY_LEN, &k_len);
+        }
+    }
+    double elapsed_us = timer_toc();
+    printf("single,1,%d,%.1f,%.1f\n", BATCH_ROUNDS * BATCH_POOL, elapsed_us,
+           BATCH_ROUNDS * BATCH_POOL / (elapsed_us / 1e6));
+
+    for (size_t b = 0; b < sizeof(batch_sizes) / sizeof(batch_sizes[0]); b++) {
+        int bs = batch_sizes[b];
+        timer_tic();
+        for (int r = 0; r < BATCH_ROUNDS; r++) {
+            for (int p = 0; p < BATCH_POOL; p += bs) {
+                fe_reproduce_batch(ctx, inputs + p * FE_DATA_BYTES, helpers + p * FE_HELPER_BYTES,
+                                   bs, keys + p * FE_KEY_LEN, status + p);
+            }
+        }
+        elapsed_us = timer_toc();
+        printf("batch,%d,%d,%.1f,%.1f\n", bs, BATCH_ROUNDS * BATCH_POOL, elapsed_us,
+               BATCH_ROUNDS * BATCH_POOL / (elapsed_us / 1e6));
+    }
+
+out:
+    fe_ctx_destroy(ctx);
+    free(status);
+    free(keys);
+    free(helpers);
+    free(inputs);
+}
+
+// [벤치마크] 배치 엔진 스케일링: 워커 1..N, 에러 수가 치우친 배치
+// 앞쪽 절반은 에러 0개(즉시 종료), 뒤쪽 절반은 에러 40~63개(전체 디코딩)
+#define POOL_PROBES    1024
+#define POOL_ROUNDS    4
+
+void run_pool_bench(int max_threads, int pin) {
+    uint8_t *inputs = (uint8_t *)malloc(POOL_PROBES * FE_DATA_BYTES);
+    uint8_t *helpers = (uint8_t *)malloc(POOL_PROBES * FE_HELPER_BYTES);
+    uint8_t *keys = (uint8_t *)malloc(POOL_PROBES * FE_KEY_LEN);
+    int *status = (int *)malloc(POOL_PROBES * sizeof(int));
+    double base_rate = 0.0;
+
+    if (!inputs || !helpers || !keys || !status) {
+        printf("allocation failed!\n");
+        goto out;
+    }
+
+    fe_ctx *gen = fe_ctx_create();
+    if (!gen) goto out;
+    for (int i = 0; i < POOL_PROBES * FE_DATA_BYTES; i++) inputs[i] = rand() & 0xFF;
+    fe_enroll_batch(gen, inputs, POOL_PROBES, helpers, keys, status);
+    fe_ctx_destroy(gen);
+    for (int p = POOL_PROBES / 2; p < POOL_PROBES; p++)
+        inject_random_noise(inputs + p * FE_DATA_BYTES, FE_DATA_BYTES, 40 + rand() % 24);
+
+    printf("threads,pin,probes,elapsed_us,probes_per_sec,speedup,efficiency\n");
+    for (int n = 1; n <= max_threads; n++) {
+        fe_ctx_params params;
+        fe_ctx_params_default(&params);
+        params.num_threads = n;
+        params.pin_threads = pin;
+        fe_ctx *ctx = fe_ctx_create_ex(&params);
+        if (!ctx) {
+            printf("fe_ctx_create_ex failed!\n");
+            break;
+        }
+
+        int success = 0;
+        timer_tic();
+        for (int r = 0; r < POOL_ROUNDS; r++)
+            success += fe_reproduce_batch(ctx, inputs, helpers, POOL_PROBES, keys, status);
+        double elapsed_us = timer_toc();
+        fe_ctx_destroy(ctx);
+
+        double rate = (double)POOL_ROUNDS * POOL_PROBES / (elapsed_us / 1e6);
+        if (n == 1) base_rate = rate;
+        if (success != POOL_ROUNDS * POOL_PROBES)
+            printf("# warning: %d probes failed\n", POOL_ROUNDS * POOL_PROBES - success);
+        printf("%d,%d,%d,%.1f,%.1f,%.2f,%.2f\n", n, pin, POOL_ROUNDS * POOL_PROBES,
+               elapsed_us, rate, rate / base_rate, rate / base_rate / n);
+    }
+
+out:
+    free(status);
+    free(keys);
+    free(helpers);
+    free(inputs);
+}
+
+// [벤치마크] 근 찾기 방식 비교: 에러 수(=오류 위치 다항식 차수) 0..64별 중앙값
+#define ROOTS_TRIALS   100
+
+void run_roots_bench(void) {
+    static const int finders[] = { FE_ROOTS_BTA, FE_ROOTS_CHIEN, FE_ROOTS_AUTO };
+    fe_ctx *ctx[3] = { NULL, NULL, NULL };
+    uint8_t input[FE_DATA_BYTES];
+    uint8_t noisy[FE_DATA_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
+    uint8_t key_org[FE_KEY_LEN];
+    uint8_t key_rec[FE_KEY_LEN];
+    size_t h_len = FE_HELPER_BYTES;
+    size_t k_len = FE_KEY_LEN;
+    double times[3][ROOTS_TRIALS];
+    TimeStats st;
+
+    for (int f = 0; f < 3; f++) {
+        fe_ctx_params params;
+        fe_ctx_params_default(&params);
+        params.root_finder = finders[f];
+        ctx[f] = fe_ctx_create_ex(&params);
+        if (!ctx[f]) {
+            printf("fe_ctx_create_ex failed!\n");
+            goto out;
+        }
+    }
+
+    printf("errors,bta_median_us,chien_median_us,auto_median_us,faster\n");
+    for (int err = 0; err <= SYS_T; err++) {
+        int fail = 0;
+        for (int t = 0; t < ROOTS_TRIALS; t++) {
+            for (int i = 0; i < FE_DATA_BYTES; i++) input[i] = rand() & 0xFF;
+            fe_enroll_ctx(ctx[0], input, FE_DATA_BYTES, helper, &h_len, key_org, &k_len);
+            memcpy(noisy, input, FE_DATA_BYTES);
+            inject_random_noise(noisy, FE_DATA_BYTES, err);
+
+            // 같은 probe를 세 방식으로 측정
+            for (int f = 0; f < 3; f++) {
+                timer_tic();
+                int ret = fe_reproduce_ctx(ctx[f], noisy, FE_DATA_BYTES, helper, h_len, key_rec, &k_len);
+                times[f][t] = timer_toc();
+                if (ret != FE_SUCCESS || memcmp(key_rec, key_org, FE_KEY_LEN) != 0) fail++;
+            }
+        }
+
+        double med[3];
+        for (int f = 0; f < 3; f++) {
+            summarize(times[f], ROOTS_TRIALS, &st);
+            med[f] = st.median;
+        }
+        if (fail) printf("# warning: %d failures at %d errors\n", fail, err);
+        printf("%d,%.3f,%.3f,%.3f,%s\n", err, med[0], med[1], med[2],
+               (med[1] < med[0]) ? "chien" : "bta");
+    }
+
+out:
+    for (int f = 0; f < 3; f++) fe_ctx_destroy(ctx[f]);
+}
+
+// [벤치마크] 인코더 비교: 테이블(slicing-by-4/8/16) vs CLMUL, 436바이트 블록당 ns
+#define ENC_BLOCKS     1024
+#define ENC_ROUNDS     50
+#define ENC_KINDS      4
+
+void run_encode_bench(void) {
+    static const int encoders[ENC_KINDS] = { BCH_ENC_TABLE, BCH_ENC_TABLE, BCH_ENC_TABLE, BCH_ENC_CLMUL };
+    static const unsigned int slices[ENC_KINDS] = { 4, 8, 16, 4 };
+    static const char *names[ENC_KINDS] = { "table4", "table8", "table16", "clmul" };
+    uint8_t *inputs = (uint8_t *)malloc(ENC_BLOCKS * FE_DATA_BYTES);
+    uint8_t *eccs[ENC_KINDS];
+    for (int e = 0; e < ENC_KINDS; e++)
+        eccs[e] = (uint8_t *)malloc(ENC_BLOCKS * FE_ECC_BYTES);
+    for (int e = 0; e < ENC_KINDS; e++) {
+        if (!inputs || !eccs[e]) {
+            printf("allocation failed!\n");
+            goto out;
+        }
+    }
+    for (int i = 0; i < ENC_BLOCKS * FE_DATA_BYTES; i++) inputs[i] = rand() & 0xFF;
+
+    printf("encoder,kernel,blocks,table_bytes,ns_per_block,mb_per_sec\n");
+    for (int e = 0; e < ENC_KINDS; e++) {
+        // 범용 경로 / m=13,t=64 특화 커널을 같은 테이블 설정으로 번갈아 측정
+        for (int k = 0; k < 2; k++) {
+            struct bch_config cfg = { 0 };
+            cfg.encoder = encoders[e];
+            cfg.slice_bytes = slices[e];
+            cfg.kernel = k ? BCH_KERNEL_AUTO : BCH_KERNEL_GENERIC;
+            struct bch_control *bch = fe_bch_create(&cfg);
+            struct bch_workspace *ws = fe_bch_ws_create(bch);
+            if (!bch || !ws) {
+                printf("fe_bch_create failed!\n");
+                fe_bch_ws_destroy(ws);
+                fe_bch_destroy(bch);
+                goto out;
+            }
+            if (bch->encoder != encoders[e]) {
+                printf("# %s: not supported on this CPU\n", names[e]);
+                fe_bch_ws_destroy(ws);
+                fe_bch_destroy(bch);
+                break;
+            }
+
+            // 워밍업 겸 결과 저장
+            for (int b = 0; b < ENC_BLOCKS; b++)
+                fe_bch_encode(bch, ws, inputs + b * FE_DATA_BYTES, eccs[e] + b * FE_ECC_BYTES);
+
+            timer_tic();
+            for (int r = 0; r < ENC_ROUNDS; r++)
+                for (int b = 0; b < ENC_BLOCKS; b++)
+                    fe_bch_encode(bch, ws, inputs + b * FE_DATA_BYTES, eccs[e] + b * FE_ECC_BYTES);
+            double elapsed_us = timer_toc();
+
+            double ns = elapsed_us * 1000.0 / ((double)ENC_ROUNDS * ENC_BLOCKS);
+            printf("%s,%s,%d,%zu,%.1f,%.1f\n", names[e],
+                   (bch->kernel == BCH_KERNEL_M13T64) ? "m13t64" : "generic",
+                   ENC_BLOCKS, bch_table_bytes(GFBITS, SYS_T, &cfg),
+                   ns, FE_DATA_BYTES / ns * 1000.0);
+            if ((e > 0 || k > 0) && memcmp(eccs[0], eccs[e], ENC_BLOCKS * FE_ECC_BYTES) != 0)
+                printf("# warning: %s ECC differs from table encoder\n", names[e]);
+
+            fe_bch_ws_destroy(ws);
+            fe_bch_destroy(bch);
+        }
+    }
+
+out:
+    for (int e = 0; e < ENC_KINDS; e++) free(eccs[e]);
+    free(inputs);
+}
+
 // MAIN
-int main() {
+// 사용법: fe_system        -> 에러 개수별 Reproduce 시간 분포 (CSV)
+//         fe_system ctx    -> 호출당 비용 비교 (테이블 재생성 vs 컨텍스트 재사용)
+//         fe_system mt [N] -> 1..N 스레드 처리량 (기본 N = CPU 수)
+//         fe_system batch  -> 배치 크기별 reproduce 처리량 (probes/sec)
+//         fe_system pool [N] [pin] -> 배치 엔진 워커 1..N 스케일링 (pin: CPU 고정)
+//         fe_system roots  -> 근 찾기 방식(BTA / Chien / Auto) 에러 수별 비교
+//         fe_system encode -> 인코더(slicing-by-4/8/16 / CLMUL) x 커널(범용 / 특화) 블록당 ns, 테이블 크기
+// 디코더 / API별 비교 측정(bitsliced, ct, stream, multi, gallery, store, tables)은 fe_bench MODE
+int main(int argc, char **argv) {
     // 1. 초기화
     srand(12345); // 재현 가능성을 위해 시드 고정
     timer_init();
+
+    if (argc > 1 && strcmp(argv[1], "ctx") == 0) {
+        run_ctx_bench();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "batch") == 0) {
+        run_batch_bench();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "pool") == 0) {
+        int max_threads = (argc > 2) ? atoi(argv[2]) : fe_cpu_count();
+        int pin = (argc > 3) && strcmp(argv[3], "pin") == 0;
+        if (max_threads < 1) max_threads = 1;
+        run_pool_bench(max_threads, pin);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "roots") == 0) {
+        run_roots_bench();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "encode") == 0) {
+        run_encode_bench();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "mt") == 0) {
+        int max_threads = (argc > 2) ? atoi(argv[2]) : fe_cpu_count();
+        if (max_threads < 1) max_threads = 1;
+        run_mt_bench(max_threads);
+        return 0;
+    }
     
     // 변수 준비
     uint8_t input[FE_DATA_BYTES];
     uint8_t noisy_input[FE_DATA_BYTES];
-    uint8_t helper[FE_ECC_BYTES];
+    uint8_t helper[FE_HELPER_BYTES];
     uint8_t key_org[FE_KEY_LEN];
     uint8_t key_rec[FE_KEY_LEN];
-    size_t h_len = FE_ECC_BYTES;
+    size_t h_len = FE_HELPER_BYTES;
     size_t k_len = FE_KEY_LEN;
     
     // 2. CSV 헤더 출력 (팀원 요청 포맷)
@@ -0,0 +1,52 @@
+#ifndef FE_TEST_H
+#define FE_TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* =================================================================
+ * [fe_test] 테스트 공용 (검사 매크로, PRNG)
+ * - CHECK 실패는 위치와 메시지를 출력하고 g_fail을 늘림 (계속 진행)
+ * - 종료 코드는 FE_TEST_RESULT: 실패가 하나라도 있으면 1 (ctest 실패)
+ * ================================================================= */
+
+static int g_fail = 0;
+
+#define CHECK(_c, ...) \
+    do { if (!(_c)) { g_fail++; printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                      printf(__VA_ARGS__); printf("\n"); } } while (0)
+
+#define FE_TEST_RESULT(_name) \
+    (printf("%s: %s (%d failures)\n", (_name), g_fail ? "FAIL" : "ok", g_fail), g_fail ? 1 : 0)
+
+/* ===== [PRNG] splitmix64 (고정 seed, 실행마다 같은 입력) ===== */
+static uint64_t rng_state = 20240611;
+
+static inline uint64_t rng_next(void) {
+    uint64_t z = (rng_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline void rng_fill(uint8_t *buf, size_t len) {
+    for (size_t i = 0; i < len; i++) buf[i] = (uint8_t)rng_next();
+}
+
+// 앞쪽 nbits 안에서 서로 다른 비트 w개 반전, pos != NULL이면 위치 기록 (정렬 안 함)
+static inline void flip_bits(uint8_t *data, unsigned int nbits, unsigned int w, unsigned int *pos) {
+    unsigned int local[256], *p = pos ? pos : local;
+    if (!pos && w > 256) w = 256;
+    for (unsigned int i = 0; i < w; i++) {
+        unsigned int b, dup;
+        do {
+            b = (unsigned int)(rng_next() % nbits);
+            dup = 0;
+            for (unsigned int j = 0; j < i; j++) dup |= (p[j] == b);
+        } while (dup);
+        p[i] = b;
+        data[b / 8] ^= (uint8_t)(1 << (b % 8));
+    }
+}
+
+#endif // FE_TEST_H
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "bch.h"
+#include "fe_test.h"
+
+/* =================================================================
+ * [test_bch] BCH 디코더 정합성 테스트 (ctest)
+ * - Chien vs BTA: 작은 m (t * 63 > n인 파라미터 포함)에서 두 근 찾기가
+ *   같은 오류 위치를 돌려주는지, 넣은 오류와 일치하는지 비교
+ * 실패가 하나라도 있으면 종료 코드 1
+ * ================================================================= */
+
+#define TEST_TRIALS 200
+
+static int cmp_uint(const void *a, const void *b) {
+    unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+/* ===== [Chien vs BTA] ===== */
+static void test_chien_vs_bta(int m, int t) {
+    struct bch_config cb = { 0 }, cc = { 0 };
+    struct bch_control *bta, *chien;
+    struct bch_workspace *wb, *wc;
+    unsigned int len, w;
+    uint8_t *data, *ecc;
+    unsigned int *pos, *lb, *lc;
+
+    cb.root_finder = BCH_ROOTS_BTA;
+    cc.root_finder = BCH_ROOTS_CHIEN;
+    cb.kernel = cc.kernel = BCH_KERNEL_GENERIC;
+    bta = init_bch_cfg(m, t, 0, &cb);
+    chien = init_bch_cfg(m, t, 0, &cc);
+    CHECK(bta && chien, "init_bch_cfg m=%d t=%d", m, t);
+    if (!bta || !chien) goto out;
+    wb = bch_alloc_workspace(bta);
+    wc = bch_alloc_workspace(chien);
+    len = (bta->n - bta->ecc_bits) / 8;
+    data = malloc(len);
+    ecc = malloc(bta->ecc_bytes);
+    pos = malloc(t * sizeof(*pos));
+    lb = malloc(t * sizeof(*lb));
+    lc = malloc(t * sizeof(*lc));
+
+    for (int r = 0; r < TEST_TRIALS; r++) {
+        for (unsigned int i = 0; i < len; i++) data[i] = (uint8_t)rng_next();
+        memset(ecc, 0, bta->ecc_bytes);
+        encode_bch_ws(bta, wb, data, len, ecc);
+        w = (unsigned int)(rng_next() % (t + 1));
+        if (w > len * 8) w = len * 8;
+        flip_bits(data, len * 8, w, pos);
+        qsort(pos, w, sizeof(*pos), cmp_uint);
+
+        int nb = decode_bch_ws(bta, wb, data, len, ecc, NULL, NULL, lb);
+        int nc = decode_bch_ws(chien, wc, data, len, ecc, NULL, NULL, lc);
+        CHECK(nb == (int)w && nc == (int)w, "m=%d t=%d w=%u: bta %d chien %d", m, t, w, nb, nc);
+        if (nb != (int)w || nc != (int)w) continue;
+        qsort(lb, w, sizeof(*lb), cmp_uint);
+        qsort(lc, w, sizeof(*lc), cmp_uint);
+        CHECK(!memcmp(lb, pos, w * sizeof(*pos)) && !memcmp(lc, pos, w * sizeof(*pos)),
+              "m=%d t=%d w=%u: error positions differ", m, t, w);
+    }
+
+    free(data); free(ecc); free(pos); free(lb); free(lc);
+    bch_free_workspace(wb);
+    bch_free_workspace(wc);
+out:
+    free_bch(bta);
+    free_bch(chien);
+}
+
+int main(void) {
+    // t * (BCH_CHIEN_BLOCK - 1) > n인 조합 (5/4, 8/8, 10/32)과 실사용 13/64
+    static const int params[][2] = {
+        { 5, 2 }, { 5, 4 }, { 6, 4 }, { 7, 8 }, { 8, 8 }, { 8, 16 },
+        { 9, 16 }, { 10, 32 }, { 11, 32 }, { 13, 64 },
+    };
+
+    for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++)
+        test_chien_vs_bta(params[i][0], params[i][1]);
+
+    return FE_TEST_RESULT("test_bch");
+}
@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "fe_api.h"
+#include "fe_core.h"
+#include "../lib/bch.h"
+#include "fe_test.h"
+
+/* =================================================================
+ * [test_fe] 디코더별 enroll -> reproduce 왕복 테스트 (ctest)
+ * - 디코더: scalar (범용 BTA / 범용 Chien / m13t64 특화 BTA / m13t64 Chien),
+ *   bitsliced 64블록 배치, 상수 시간
+ * - 오류 0..t개는 같은 키, t를 넘는 오류 / 타인 probe는 원래 키가 나오면 안 됨
+ * - 배치 / 단건 / 레코드 / 다중 블록 API 모두 같은 컨텍스트로 확인
+ * - 스트리밍 enroll: 인코더(table4/8/16, clmul)별로 1바이트 / 홀수 길이 조각을 섞어
+ *   helper ECC가 한 번에 인코딩한 값과 같고 reproduce가 키를 복원하는지
+ * - 갤러리: 워커 1 / 2개로 본인 probe의 인덱스 / 키, 타인 거절, 저장소로 다시 열기
+ * ================================================================= */
+
+#define FE_TEST_PROBES   96     // bitsliced: 64건 블록 1개 + 남는 32건
+#define FE_TEST_FAIL_ERR (SYS_T + 16)
+#define FE_TEST_MULTI    1000   // 다중 블록 템플릿 바이트 (블록 3개)
+
+typedef struct {
+    const char *name;
+    int decoder;
+    int root_finder;
+    int kernel;
+} test_cfg;
+
+static const test_cfg cfgs[] = {
+    { "scalar-generic",  FE_DEC_SCALAR,    FE_ROOTS_BTA,   FE_KERNEL_GENERIC },
+    { "chien-generic",   FE_DEC_SCALAR,    FE_ROOTS_CHIEN, FE_KERNEL_GENERIC },
+    { "m13t64",          FE_DEC_SCALAR,    FE_ROOTS_BTA,   FE_KERNEL_AUTO },
+    { "m13t64-chien",    FE_DEC_SCALAR,    FE_ROOTS_CHIEN, FE_KERNEL_AUTO },
+    { "bs64",            FE_DEC_BITSLICED, FE_ROOTS_AUTO,  FE_KERNEL_AUTO },
+    { "consttime",       FE_DEC_CONSTTIME, FE_ROOTS_AUTO,  FE_KERNEL_AUTO },
+};
+
+// probe i의 오류 수: 앞 t+1건은 0..t, 다음은 무작위 0..t, 마지막 8건은 복구 불가
+static int probe_errors(int i) {
+    if (i <= SYS_T) return i;
+    if (i < FE_TEST_PROBES - 8) return (int)(rng_next() % (SYS_T + 1));
+    return FE_TEST_FAIL_ERR;
+}
+
+/* ===== [Batch / 단건] ===== */
+static void test_roundtrip(const test_cfg *c, fe_ctx *ctx) {
+    uint8_t *inputs = (uint8_t *)malloc(FE_TEST_PROBES * FE_DATA_BYTES);
+    uint8_t *noisy = (uint8_t *)malloc(FE_TEST_PROBES * FE_DATA_BYTES);
+    uint8_t *helpers = (uint8_t *)malloc(FE_TEST_PROBES * FE_HELPER_BYTES);
+    uint8_t *keys_org = (uint8_t *)malloc(FE_TEST_PROBES * FE_KEY_LEN);
+    uint8_t *keys = (uint8_t *)malloc(FE_TEST_PROBES * FE_KEY_LEN);
+    uint8_t key_rec[FE_KEY_LEN];
+    int errors[FE_TEST_PROBES], status[FE_TEST_PROBES];
+    size_t k_len = FE_KEY_LEN;
+
+    rng_fill(inputs, FE_TEST_PROBES * FE_DATA_BYTES);
+    int ok = fe_enroll_batch(ctx, inputs, FE_TEST_PROBES, helpers, keys_org, status);
+    CHECK(ok == FE_TEST_PROBES, "%s: fe_enroll_batch %d", c->name, ok);
+    memcpy(noisy, inputs, FE_TEST_PROBES * FE_DATA_BYTES);
+    for (int i = 0; i < FE_TEST_PROBES; i++) {
+        errors[i] = probe_errors(i);
+        flip_bits(noisy + i * FE_DATA_BYTES, FE_DATA_BYTES * 8, (unsigned int)errors[i], NULL);
+    }
+
+    // 1. 배치 (bitsliced는 여기서만 쓰임)
+    fe_reproduce_batch(ctx, noisy, helpers, FE_TEST_PROBES, keys, status);
+    for (int i = 0; i < FE_TEST_PROBES; i++) {
+        int same = (status[i] == FE_SUCCESS) &&
+                   memcmp(keys + i * FE_KEY_LEN, keys_org + i * FE_KEY_LEN, FE_KEY_LEN) == 0;
+        if (errors[i] <= SYS_T)
+            CHECK(same, "%s: batch probe %d (%d errors) status %d", c->name, i, errors[i], status[i]);
+        else
+            CHECK(!same, "%s: batch probe %d (%d errors) recovered the key", c->name, i, errors[i]);
+    }
+
+    // 2. 단건 (4건마다 + 복구 불가 전부)
+    for (int i = 0; i < FE_TEST_PROBES; i++) {
+        if ((i % 4) && errors[i] <= SYS_T) continue;
+        int ret = fe_reproduce_ctx(ctx, noisy + i * FE_DATA_BYTES, FE_DATA_BYTES,
+                                   helpers + i * FE_HELPER_BYTES, FE_HELPER_BYTES, key_rec, &k_len);
+        int same = (ret == FE_SUCCESS) && memcmp(key_rec, keys_org + i * FE_KEY_LEN, FE_KEY_LEN) == 0;
+        if (errors[i] <= SYS_T)
+            CHECK(same, "%s: single probe %d (%d errors) ret %d", c->name, i, errors[i], ret);
+        else
+            CHECK(!same, "%s: single probe %d (%d errors) recovered the key", c->name, i, errors[i]);
+    }
+
+    // 3. 타인 probe: 실패 (레코드 경로는 커밋 대조로 FE_FAIL_DECODE가 되어야 함)
+    uint8_t record[FE_RECORD_BYTES], key_enr[FE_KEY_LEN];
+    size_t r_len = sizeof(record);
+    CHECK(fe_enroll_record(ctx, inputs, FE_DATA_BYTES, record, &r_len, key_enr, &k_len) == FE_SUCCESS,
+          "%s: fe_enroll_record", c->name);
+    int ret = fe_reproduce_record(ctx, noisy + SYS_T * FE_DATA_BYTES, FE_DATA_BYTES, record, r_len,
+                                  key_rec, &k_len);
+    CHECK(ret == FE_FAIL_DECODE, "%s: record impostor ret %d", c->name, ret);
+    memcpy(noisy, inputs, FE_DATA_BYTES);
+    flip_bits(noisy, FE_DATA_BYTES * 8, SYS_T, NULL);
+    ret = fe_reproduce_record(ctx, noisy, FE_DATA_BYTES, record, r_len, key_rec, &k_len);
+    CHECK(ret == FE_SUCCESS && memcmp(key_rec, key_enr, FE_KEY_LEN) == 0,
+          "%s: record genuine ret %d", c->name, ret);
+
+    free(keys);
+    free(keys_org);
+    free(helpers);
+    free(noisy);
+    free(inputs);
+}
+
+/* ===== [다중 블록] 분할 방식별 왕복 ===== */
+static void test_multi(const test_cfg *c, fe_ctx *ctx) {
+    uint8_t input[FE_TEST_MULTI], noisy[FE_TEST_MULTI];
+    uint8_t record[1024], key_org[FE_KEY_LEN], key_rec[FE_KEY_LEN];
+    size_t n = fe_multi_blocks(FE_TEST_MULTI), k_len;
+
+    for (int flags = 0; flags <= FE_MULTI_INTERLEAVE; flags++) {
+        size_t r_len = sizeof(record);
+        rng_fill(input, sizeof(input));
+        int ret = fe_enroll_multi(ctx, input, sizeof(input), flags, record, &r_len, key_org, &k_len);
+        CHECK(ret == FE_SUCCESS && r_len == fe_multi_record_bytes(sizeof(input)),
+              "%s: fe_enroll_multi flags %d ret %d", c->name, flags, ret);
+
+        // 블록당 평균 t/2개: 모든 블록이 t 이하
+        memcpy(noisy, input, sizeof(input));
+        flip_bits(noisy, sizeof(input) * 8, (unsigned int)(n * SYS_T / 2), NULL);
+        ret = fe_reproduce_multi(ctx, noisy, sizeof(input), record, r_len, key_rec, &k_len);
+        CHECK(ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0,
+              "%s: multi flags %d genuine ret %d", c->name, flags, ret);
+
+        // 타인 템플릿
+        rng_fill(noisy, sizeof(noisy));
+        ret = fe_reproduce_multi(ctx, noisy, sizeof(input), record, r_len, key_rec, &k_len);
+        CHECK(ret == FE_FAIL_DECODE, "%s: multi flags %d impostor ret %d", c->name, flags, ret);
+    }
+}
+
+/* ===== [스트리밍 enroll] 인코더별 조각 크기 무작위 ===== */
+#define STREAM_ROUNDS 24
+
+typedef struct {
+    const char *name;
+    int encoder;
+    int slice_bytes;
+} stream_cfg;
+
+static const stream_cfg stream_cfgs[] = {
+    { "table4",  FE_ENC_TABLE, 4 },
+    { "table8",  FE_ENC_TABLE, 8 },
+    { "table16", FE_ENC_TABLE, 16 },
+    { "clmul",   FE_ENC_CLMUL, 4 },
+};
+
+// 조각 길이: 1바이트 / 홀수 / 짝수 / 남은 전부를 섞어서
+static size_t stream_chunk(int round, size_t left) {
+    size_t len;
+    switch (round % 4) {
+    case 0:  len = 1; break;
+    case 1:  len = 1 + 2 * (size_t)(rng_next() % 55); break;
+    case 2:  len = 1 + (size_t)(rng_next() % FE_DATA_BYTES); break;
+    default: len = (rng_next() & 1) ? left : 1 + (size_t)(rng_next() % 16); break;
+    }
+    return (len > left) ? left : len;
+}
+
+static void test_stream(const stream_cfg *c) {
+    uint8_t input[FE_DATA_BYTES], noisy[FE_DATA_BYTES], ecc[FE_ECC_BYTES];
+    uint8_t helper[FE_HELPER_BYTES], key_org[FE_KEY_LEN], key_rec[FE_KEY_LEN];
+    fe_enroll_stream st;
+    fe_ctx_params params;
+
+    fe_ctx_params_default(&params);
+    params.num_threads = 1;
+    params.encoder = c->encoder;
+    params.slice_bytes = c->slice_bytes;
+    fe_ctx *ctx = fe_ctx_create_ex(&params);
+    struct bch_workspace *ws = ctx ? fe_bch_ws_create(ctx->bch) : NULL;
+    CHECK(ws != NULL, "stream %s: fe_ctx_create_ex", c->name);
+    if (!ws) goto out;
+    CHECK(c->encoder != FE_ENC_TABLE ||
+          (ctx->bch->encoder == BCH_ENC_TABLE && ctx->bch->slice_bytes == (unsigned int)c->slice_bytes),
+          "stream %s: encoder %d slice %u", c->name, ctx->bch->encoder, ctx->bch->slice_bytes);
+
+    for (int r = 0; r < STREAM_ROUNDS; r++) {
+        size_t h_len = sizeof(helper), k_len = sizeof(key_org), fed = 0;
+        rng_fill(input, sizeof(input));
+        CHECK(fe_enroll_stream_init(ctx, &st) == FE_SUCCESS, "stream %s: init", c->name);
+        while (fed < FE_DATA_BYTES) {
+            size_t len = stream_chunk(r, FE_DATA_BYTES - fed);
+            CHECK(fe_enroll_stream_update(&st, input + fed, len) == FE_SUCCESS,
+                  "stream %s round %d: update %zu at %zu", c->name, r, len, fed);
+            fed += len;
+        }
+        // 합계를 넘는 조각은 거절하고 상태는 그대로
+        CHECK(fe_enroll_stream_update(&st, input, 1) == FE_FAIL_PARAM, "stream %s: overflow accepted", c->name);
+        int ret = fe_enroll_stream_final(&st, helper, &h_len, key_org, &k_len);
+        CHECK(ret == FE_SUCCESS && h_len == FE_HELPER_BYTES && k_len == FE_KEY_LEN,
+              "stream %s round %d: final ret %d", c->name, r, ret);
+
+        // 1. helper의 ECC = 한 번에 인코딩
+        fe_bch_encode(ctx->bch, ws, input, ecc);
+        CHECK(memcmp(helper, ecc, FE_ECC_BYTES) == 0, "stream %s round %d: ECC differs", c->name, r);
+
+        // 2. reproduce로 스트리밍 키 복원
+        memcpy(noisy, input, sizeof(noisy));
+        flip_bits(noisy, FE_DATA_BYTES * 8, (unsigned int)(rng_next() % (SYS_T + 1)), NULL);
+        ret = fe_reproduce_ctx(ctx, noisy, sizeof(noisy), helper, h_len, key_rec, &k_len);
+        CHECK(ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0,
+              "stream %s round %d: reproduce ret %d", c->name, r, ret);
+    }
+
+    // 모자란 입력은 final에서 거절, abort는 끝난 상태에도 허용
+    size_t h_len = sizeof(helper), k_len = sizeof(key_org);
+    CHECK(fe_enroll_stream_init(ctx, &st) == FE_SUCCESS, "stream %s: init", c->name);
+    fe_enroll_stream_update(&st, input, FE_DATA_BYTES - 1);
+    CHECK(fe_enroll_stream_final(&st, helper, &h_len, key_org, &k_len) == FE_FAIL_PARAM,
+          "stream %s: short input accepted", c->name);
+    fe_enroll_stream_abort(&st);
+    CHECK(fe_enroll_stream_init(ctx, &st) == FE_SUCCESS, "stream %s: init", c->name);
+    fe_enroll_stream_update(&st, input, 100);
+    fe_enroll_stream_abort(&st);
+    fe_enroll_stream_abort(&st);
+
+out:
+    fe_bch_ws_destroy(ws);
+    fe_ctx_destroy(ctx);
+}
+
+/* ===== [갤러리] 1:N 식별 (prescreen 신드롬 결합, 워커별 결과 합치기, 저장소 열기) ===== */
+#define GALLERY_ENTRIES 300     // 워커 2개가 64건 단위로 나눠 가질 만큼
+#define GALLERY_PATH    "test_fe_gallery.bin"
+
+static void gallery_check(fe_gallery *g, const char *name, const uint8_t *inputs, const uint8_t *keys,
+                          const uint8_t *impostor) {
+    static const int probes[][2] = { { 0, 0 }, { 7, 20 }, { 150, 40 }, { GALLERY_ENTRIES - 1, 56 } };
+    uint8_t noisy[FE_DATA_BYTES], key_rec[FE_KEY_LEN];
+    fe_gallery_result res;
+
+    for (size_t j = 0; j < sizeof(probes) / sizeof(probes[0]); j++) {
+        int idx = probes[j][0];
+        memcpy(noisy, inputs + idx * FE_DATA_BYTES, FE_DATA_BYTES);
+        flip_bits(noisy, FE_DATA_BYTES * 8, (unsigned int)probes[j][1], NULL);
+        int ret = fe_gallery_identify(g, noisy, FE_DATA_BYTES, key_rec, &res);
+        CHECK(ret == FE_SUCCESS && res.index == idx && res.matches == 1 &&
+              memcmp(key_rec, keys + idx * FE_KEY_LEN, FE_KEY_LEN) == 0,
+              "%s: entry %d (%d errors) ret %d index %ld matches %zu", name, idx, probes[j][1], ret,
+              res.index, res.matches);
+        CHECK(res.scanned == fe_gallery_count(g) && res.candidates < res.scanned,
+              "%s: entry %d scanned %zu candidates %zu", name, idx, res.scanned, res.candidates);
+    }
+
+    int ret = fe_gallery_identify(g, impostor, FE_DATA_BYTES, key_rec, &res);
+    CHECK(ret == FE_FAIL_DECODE && res.index == -1 && res.matches == 0,
+          "%s: impostor ret %d index %ld", name, ret, res.index);
+}
+
+static void test_gallery(int threads) {
+    uint8_t *inputs = (uint8_t *)malloc(GALLERY_ENTRIES * FE_DATA_BYTES);
+    uint8_t *keys = (uint8_t *)malloc(GALLERY_ENTRIES * FE_KEY_LEN);
+    uint8_t impostor[FE_DATA_BYTES], noisy[FE_DATA_BYTES], key_rec[FE_KEY_LEN];
+    char name[32];
+    fe_ctx_params params;
+    fe_gallery_result res;
+    size_t idx;
+
+    snprintf(name, sizeof(name), "gallery-t%d", threads);
+    fe_ctx_params_default(&params);
+    params.num_threads = threads;
+    fe_ctx *ctx = fe_ctx_create_ex(&params);
+    fe_gallery *g = ctx ? fe_gallery_create(ctx, 16, 0) : NULL;
+    CHECK(g != NULL, "%s: fe_gallery_create", name);
+    if (!g) goto out;
+
+    rng_fill(inputs, GALLERY_ENTRIES * FE_DATA_BYTES);
+    rng_fill(impostor, sizeof(impostor));
+    for (int i = 0; i < GALLERY_ENTRIES; i++) {
+        int ret = fe_gallery_enroll(g, inputs + i * FE_DATA_BYTES, FE_DATA_BYTES, keys + i * FE_KEY_LEN, &idx);
+        CHECK(ret == FE_SUCCESS && idx == (size_t)i, "%s: enroll %d ret %d", name, i, ret);
+    }
+    CHECK(fe_gallery_count(g) == GALLERY_ENTRIES, "%s: count %zu", name, fe_gallery_count(g));
+    gallery_check(g, name, inputs, keys, impostor);
+
+    // 1. 저장 -> 저장소로 다시 열기 (매핑된 helper 신드롬 열 사용)
+    CHECK(fe_gallery_save(g, GALLERY_PATH) == FE_SUCCESS, "%s: fe_gallery_save", name);
+    fe_store *store = fe_store_open(GALLERY_PATH);
+    fe_gallery *g2 = store ? fe_gallery_open(ctx, store, 0) : NULL;
+    CHECK(g2 != NULL && fe_gallery_count(g2) == GALLERY_ENTRIES, "%s: fe_gallery_open", name);
+    if (g2) gallery_check(g2, "gallery-store", inputs, keys, impostor);
+
+    // 2. 같은 템플릿을 뒤쪽에 다시 등록: 다른 워커 구간에서도 가장 작은 인덱스
+    fe_gallery *dup = g2 ? g2 : g;
+    CHECK(fe_gallery_enroll(dup, inputs + 3 * FE_DATA_BYTES, FE_DATA_BYTES, NULL, &idx) == FE_SUCCESS &&
+          idx == GALLERY_ENTRIES, "%s: enroll duplicate", name);
+    memcpy(noisy, inputs + 3 * FE_DATA_BYTES, FE_DATA_BYTES);
+    flip_bits(noisy, FE_DATA_BYTES * 8, 10, NULL);
+    int ret = fe_gallery_identify(dup, noisy, FE_DATA_BYTES, key_rec, &res);
+    CHECK(ret == FE_SUCCESS && res.index == 3 && res.matches == 2 &&
+          memcmp(key_rec, keys + 3 * FE_KEY_LEN, FE_KEY_LEN) == 0,
+          "%s: duplicate ret %d index %ld matches %zu", name, ret, res.index, res.matches);
+
+    fe_gallery_destroy(g2);
+    fe_store_close(store);
+    remove(GALLERY_PATH);
+out:
+    fe_gallery_destroy(g);
+    fe_ctx_destroy(ctx);
+    free(keys);
+    free(inputs);
+}
+
+int main(void) {
+    for (size_t i = 0; i < sizeof(cfgs) / sizeof(cfgs[0]); i++) {
+        const test_cfg *c = &cfgs[i];
+        fe_ctx_params params;
+        fe_ctx_params_default(&params);
+        params.num_threads = 2;
+        params.decoder = c->decoder;
+        params.root_finder = c->root_finder;
+        params.kernel = c->kernel;
+        fe_ctx *ctx = fe_ctx_create_ex(&params);
+        CHECK(ctx != NULL, "%s: fe_ctx_create_ex", c->name);
+        if (!ctx) continue;
+        int want = (c->kernel == FE_KERNEL_GENERIC) ? BCH_KERNEL_GENERIC : BCH_KERNEL_M13T64;
+        CHECK(ctx->bch->kernel == want, "%s: kernel %d", c->name, ctx->bch->kernel);
+        test_roundtrip(c, ctx);
+        test_multi(c, ctx);
+        fe_ctx_destroy(ctx);
+    }
+    for (size_t i = 0; i < sizeof(stream_cfgs) / sizeof(stream_cfgs[0]); i++)
+        test_stream(&stream_cfgs[i]);
+    test_gallery(1);
+    test_gallery(2);
+    return FE_TEST_RESULT("test_fe");
+}
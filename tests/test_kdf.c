@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "fe_kdf.h"
+#include "fe_test.h"
+
+/* =================================================================
+ * [test_kdf] SHA3-256 키 유도 정합성 테스트 (ctest)
+ * - FIPS 202 알려진 답: 빈 문자열, "abc", 0xA3 x 200 (여러 블록)
+ * - 조각 단위 update / update_flip / update_xor가 한 번에 해시와 같은지
+ * - multi-buffer (lane 1 / 4 / 8)가 단건 update_flip 경로와 같은지
+ * Keccak이 깨지면 모든 키가 조용히 바뀌므로 여기서 막음
+ * ================================================================= */
+
+#define KDF_MSGS    11      // lane 수의 배수가 아닌 개수
+#define KDF_SALT    32
+#define KDF_DATA    436
+#define KDF_FLIPS   64
+
+static const uint8_t kat_empty[FE_SHA3_256_BYTES] = {
+    0xa7, 0xff, 0xc6, 0xf8, 0xbf, 0x1e, 0xd7, 0x66, 0x51, 0xc1, 0x47, 0x56, 0xa0, 0x61, 0xd6, 0x62,
+    0xf5, 0x80, 0xff, 0x4d, 0xe4, 0x3b, 0x49, 0xfa, 0x82, 0xd8, 0x0a, 0x4b, 0x80, 0xf8, 0x43, 0x4a,
+};
+static const uint8_t kat_abc[FE_SHA3_256_BYTES] = {
+    0x3a, 0x98, 0x5d, 0xa7, 0x4f, 0xe2, 0x25, 0xb2, 0x04, 0x5c, 0x17, 0x2d, 0x6b, 0xd3, 0x90, 0xbd,
+    0x85, 0x5f, 0x08, 0x6e, 0x3e, 0x9d, 0x52, 0x5b, 0x46, 0xbf, 0xe2, 0x45, 0x11, 0x43, 0x15, 0x32,
+};
+static const uint8_t kat_a3x200[FE_SHA3_256_BYTES] = {
+    0x79, 0xf3, 0x8a, 0xde, 0xc5, 0xc2, 0x03, 0x07, 0xa9, 0x8e, 0xf7, 0x6e, 0x83, 0x24, 0xaf, 0xbf,
+    0xd4, 0x6c, 0xfd, 0x81, 0xb2, 0x2e, 0x39, 0x73, 0xc6, 0x5f, 0xa1, 0xbd, 0x9d, 0xe3, 0x17, 0x87,
+};
+
+/* ===== [KAT] FIPS 202 ===== */
+static void test_kat(void) {
+    uint8_t msg[200], digest[FE_SHA3_256_BYTES];
+    fe_sha3 h;
+
+    fe_sha3_256((const uint8_t *)"", 0, digest);
+    CHECK(memcmp(digest, kat_empty, sizeof(digest)) == 0, "SHA3-256(\"\")");
+    fe_sha3_256((const uint8_t *)"abc", 3, digest);
+    CHECK(memcmp(digest, kat_abc, sizeof(digest)) == 0, "SHA3-256(\"abc\")");
+    memset(msg, 0xA3, sizeof(msg));
+    fe_sha3_256(msg, sizeof(msg), digest);
+    CHECK(memcmp(digest, kat_a3x200, sizeof(digest)) == 0, "SHA3-256(0xA3 x 200)");
+
+    // 1바이트씩 흡수 (블록 경계 136을 조각 중간에 넘김)
+    fe_sha3_init(&h);
+    for (size_t i = 0; i < sizeof(msg); i++) fe_sha3_update(&h, msg + i, 1);
+    fe_sha3_final(&h, digest);
+    CHECK(memcmp(digest, kat_a3x200, sizeof(digest)) == 0, "SHA3-256(0xA3 x 200) byte by byte");
+}
+
+/* ===== [update_flip / update_xor] 뒤집은 사본을 한 번에 해시한 값과 비교 ===== */
+static void test_flip_xor(void) {
+    uint8_t data[KDF_DATA], copy[KDF_DATA], mask[KDF_DATA];
+    uint8_t want[FE_SHA3_256_BYTES], got[FE_SHA3_256_BYTES];
+    unsigned int flip[KDF_FLIPS];
+    fe_sha3 h;
+
+    for (int r = 0; r < 20; r++) {
+        rng_fill(data, sizeof(data));
+        memcpy(copy, data, sizeof(copy));
+        unsigned int nflip = (unsigned int)(rng_next() % (KDF_FLIPS + 1));
+        flip_bits(copy, KDF_DATA * 8, nflip, flip);
+        fe_sha3_256(copy, sizeof(copy), want);
+
+        // 조각 크기를 바꿔 가며 update_flip (flip은 조각 안의 위치로 옮김)
+        size_t split = (size_t)(rng_next() % KDF_DATA);
+        unsigned int f0[KDF_FLIPS], f1[KDF_FLIPS];
+        size_t n0 = 0, n1 = 0;
+        for (unsigned int k = 0; k < nflip; k++) {
+            if (flip[k] < split * 8) f0[n0++] = flip[k];
+            else f1[n1++] = flip[k] - (unsigned int)(split * 8);
+        }
+        fe_sha3_init(&h);
+        fe_sha3_update_flip(&h, data, split, f0, n0);
+        fe_sha3_update_flip(&h, data + split, KDF_DATA - split, f1, n1);
+        fe_sha3_final(&h, got);
+        CHECK(memcmp(got, want, sizeof(got)) == 0, "update_flip round %d (%u flips, split %zu)", r, nflip, split);
+
+        for (size_t i = 0; i < KDF_DATA; i++) mask[i] = data[i] ^ copy[i];
+        fe_sha3_init(&h);
+        fe_sha3_update_xor(&h, data, mask, split);
+        fe_sha3_update_xor(&h, data + split, mask + split, KDF_DATA - split);
+        fe_sha3_final(&h, got);
+        CHECK(memcmp(got, want, sizeof(got)) == 0, "update_xor round %d", r);
+    }
+}
+
+/* ===== [Multi-buffer] lane 1 / 4 / 8 vs 단건 ===== */
+static void test_multi(void) {
+    static const unsigned int lanes[] = { 1, 4, 8 };
+    uint8_t salt[KDF_MSGS][KDF_SALT], data[KDF_MSGS][KDF_DATA];
+    uint8_t want[KDF_MSGS][FE_SHA3_256_BYTES], plain[KDF_MSGS][FE_SHA3_256_BYTES];
+    uint8_t got[KDF_MSGS][FE_SHA3_256_BYTES];
+    unsigned int flip[KDF_MSGS][KDF_FLIPS];
+    size_t nflip[KDF_MSGS];
+    const uint8_t *a[KDF_MSGS], *b[KDF_MSGS];
+    const unsigned int *f[KDF_MSGS];
+    uint8_t *out[KDF_MSGS];
+    uint8_t tmp[KDF_DATA] = { 0 };   // flip 위치만 뽑는 용도
+    fe_sha3 h;
+
+    for (int i = 0; i < KDF_MSGS; i++) {
+        rng_fill(salt[i], KDF_SALT);
+        rng_fill(data[i], KDF_DATA);
+        nflip[i] = (size_t)(rng_next() % (KDF_FLIPS + 1));
+        flip_bits(tmp, KDF_DATA * 8, (unsigned int)nflip[i], flip[i]);
+        a[i] = salt[i];
+        b[i] = data[i];
+        f[i] = flip[i];
+        out[i] = got[i];
+        fe_sha3_init(&h);
+        fe_sha3_update(&h, salt[i], KDF_SALT);
+        fe_sha3_update_flip(&h, data[i], KDF_DATA, flip[i], nflip[i]);
+        fe_sha3_final(&h, want[i]);
+        fe_sha3_init(&h);
+        fe_sha3_update(&h, salt[i], KDF_SALT);
+        fe_sha3_update(&h, data[i], KDF_DATA);
+        fe_sha3_final(&h, plain[i]);
+    }
+
+    for (size_t l = 0; l < sizeof(lanes) / sizeof(lanes[0]); l++) {
+        memset(got, 0, sizeof(got));
+        fe_sha3_256_multi_flip(lanes[l], KDF_MSGS, a, KDF_SALT, b, KDF_DATA, f, nflip, out);
+        for (int i = 0; i < KDF_MSGS; i++)
+            CHECK(memcmp(got[i], want[i], FE_SHA3_256_BYTES) == 0, "multi_flip lanes %u (used %u) msg %d",
+                  lanes[l], fe_sha3_lanes(lanes[l]), i);
+
+        memset(got, 0, sizeof(got));
+        fe_sha3_256_multi(lanes[l], KDF_MSGS, a, KDF_SALT, b, KDF_DATA, out);
+        for (int i = 0; i < KDF_MSGS; i++)
+            CHECK(memcmp(got[i], plain[i], FE_SHA3_256_BYTES) == 0, "multi lanes %u msg %d", lanes[l], i);
+    }
+}
+
+int main(void) {
+    test_kat();
+    test_flip_xor();
+    test_multi();
+    return FE_TEST_RESULT("test_kdf");
+}
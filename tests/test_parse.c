@@ -0,0 +1,343 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "fe_api.h"
+#include "fe_core.h"
+#include "fe_tables.h"
+#include "../lib/bch.h"
+#include "fe_test.h"
+
+/* =================================================================
+ * [test_parse] 손상된 입력에 대한 파서 테스트 (ctest)
+ * - 레코드 / 다중 블록 레코드: 헤더 비트 하나만 바뀌어도 FE_FAIL_PARAM,
+ *   helper / 커밋 손상은 FE_FAIL_DECODE (키를 돌려주면 안 됨)
+ * - 저장소 파일: 헤더 손상 / 잘린 파일 / 빈 파일 / 없는 파일은 열기 실패,
+ *   커밋이 손상된 항목만 배치 reproduce에서 실패
+ * - BCH 테이블 이미지: 헤더 비트 반전 / 본문 손상 / 크기 / 정렬 오류는 거절,
+ *   손상된 tables_path 파일은 직접 계산으로 대체되어 그대로 동작
+ * 파일은 현재 디렉터리(ctest: 빌드 디렉터리)에 만들고 끝나면 지움
+ * ================================================================= */
+
+#define STORE_PATH      "test_parse_store.bin"
+#define TABLES_PATH     "test_parse_tables.bin"
+#define STORE_ENTRIES   8
+#define STORE_HDR_BYTES 64      // fe_store.c store_hdr
+#define MULTI_BYTES     1000
+
+static int write_file(const char *path, const uint8_t *buf, size_t len) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return -1;
+    size_t written = len ? fwrite(buf, 1, len, fp) : 0;
+    return (fclose(fp) != 0 || written != len) ? -1 : 0;
+}
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *buf = (size > 0) ? (uint8_t *)malloc((size_t)size) : NULL;
+    if (buf && fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(fp);
+    *len = buf ? (size_t)size : 0;
+    return buf;
+}
+
+/* ===== [Record] 단건 레코드 ===== */
+static void test_record(fe_ctx *ctx) {
+    uint8_t input[FE_DATA_BYTES], noisy[FE_DATA_BYTES];
+    uint8_t record[FE_RECORD_BYTES + 1], bad[FE_RECORD_BYTES + 1];
+    uint8_t key_org[FE_KEY_LEN], key_rec[FE_KEY_LEN];
+    size_t r_len = FE_RECORD_BYTES, k_len;
+
+    rng_fill(input, sizeof(input));
+    CHECK(fe_enroll_record(ctx, input, sizeof(input), record, &r_len, key_org, &k_len) == FE_SUCCESS,
+          "fe_enroll_record");
+    memcpy(noisy, input, sizeof(noisy));
+    flip_bits(noisy, FE_DATA_BYTES * 8, SYS_T / 2, NULL);
+
+    // 1. 헤더 16바이트: 모든 비트 반전 거절
+    for (int i = 0; i < 16 * 8; i++) {
+        memcpy(bad, record, FE_RECORD_BYTES);
+        bad[i / 8] ^= (uint8_t)(1 << (i % 8));
+        CHECK(fe_record_parse(bad, FE_RECORD_BYTES, NULL, NULL) == FE_FAIL_PARAM,
+              "record header byte %d bit %d accepted", i / 8, i % 8);
+        int ret = fe_reproduce_record(ctx, noisy, sizeof(noisy), bad, FE_RECORD_BYTES, key_rec, &k_len);
+        CHECK(ret == FE_FAIL_PARAM, "record header byte %d bit %d: reproduce ret %d", i / 8, i % 8, ret);
+    }
+
+    // 2. 길이 / NULL
+    CHECK(fe_record_parse(record, FE_RECORD_BYTES - 1, NULL, NULL) == FE_FAIL_PARAM, "short record accepted");
+    CHECK(fe_record_parse(record, FE_RECORD_BYTES + 1, NULL, NULL) == FE_FAIL_PARAM, "long record accepted");
+    CHECK(fe_record_parse(NULL, FE_RECORD_BYTES, NULL, NULL) == FE_FAIL_PARAM, "NULL record accepted");
+    CHECK(fe_reproduce_record(ctx, noisy, sizeof(noisy) - 1, record, FE_RECORD_BYTES, key_rec, &k_len)
+          == FE_FAIL_PARAM, "short input accepted");
+
+    // 3. salt / 커밋 손상: 다른 키가 나오거나 커밋이 맞지 않음 (ECC 비트는 정정 대상)
+    static const int offs[] = { 16 + FE_ECC_BYTES, FE_RECORD_BYTES - FE_KEY_LEN - 1,
+                                FE_RECORD_BYTES - FE_KEY_LEN, FE_RECORD_BYTES - 1 };
+    for (size_t j = 0; j < sizeof(offs) / sizeof(offs[0]); j++) {
+        memcpy(bad, record, FE_RECORD_BYTES);
+        bad[offs[j]] ^= 0x01;
+        int ret = fe_reproduce_record(ctx, noisy, sizeof(noisy), bad, FE_RECORD_BYTES, key_rec, &k_len);
+        CHECK(ret == FE_FAIL_DECODE, "record byte %d corrupted: ret %d", offs[j], ret);
+    }
+
+    int ret = fe_reproduce_record(ctx, noisy, sizeof(noisy), record, FE_RECORD_BYTES, key_rec, &k_len);
+    CHECK(ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0, "record genuine ret %d", ret);
+}
+
+/* ===== [다중 블록] 레코드 ===== */
+static void test_multi_record(fe_ctx *ctx) {
+    uint8_t input[MULTI_BYTES], noisy[MULTI_BYTES];
+    uint8_t record[1024], bad[1024];
+    uint8_t key_org[FE_KEY_LEN], key_rec[FE_KEY_LEN];
+    size_t r_len = sizeof(record), k_len;
+
+    rng_fill(input, sizeof(input));
+    CHECK(fe_enroll_multi(ctx, input, sizeof(input), 0, record, &r_len, key_org, &k_len) == FE_SUCCESS,
+          "fe_enroll_multi");
+    memcpy(noisy, input, sizeof(noisy));
+    flip_bits(noisy, sizeof(noisy) * 8, SYS_T / 2, NULL);
+
+    // 1. 헤더 16바이트: flags 비트(분할 방식)는 형식상 유효하므로 커밋 대조에서 실패
+    for (int i = 0; i < 16 * 8; i++) {
+        memcpy(bad, record, r_len);
+        bad[i / 8] ^= (uint8_t)(1 << (i % 8));
+        int want = (i == 7 * 8) ? FE_FAIL_DECODE : FE_FAIL_PARAM;
+        int ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy), bad, r_len, key_rec, &k_len);
+        CHECK(ret == want, "multi header byte %d bit %d: ret %d", i / 8, i % 8, ret);
+    }
+
+    // 2. 레코드 / 템플릿 길이 불일치
+    int ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy), record, r_len - 1, key_rec, &k_len);
+    CHECK(ret == FE_FAIL_PARAM, "multi short record ret %d", ret);
+    ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy), record, r_len + 1, key_rec, &k_len);
+    CHECK(ret == FE_FAIL_PARAM, "multi long record ret %d", ret);
+    ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy) - 1, record, r_len, key_rec, &k_len);
+    CHECK(ret == FE_FAIL_PARAM, "multi input length ret %d", ret);
+    ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy), NULL, r_len, key_rec, &k_len);
+    CHECK(ret == FE_FAIL_PARAM, "multi NULL record ret %d", ret);
+
+    // 3. salt / 커밋 손상
+    size_t offs[] = { r_len - FE_SALT_BYTES - FE_KEY_LEN, r_len - FE_KEY_LEN - 1, r_len - FE_KEY_LEN, r_len - 1 };
+    for (size_t j = 0; j < sizeof(offs) / sizeof(offs[0]); j++) {
+        memcpy(bad, record, r_len);
+        bad[offs[j]] ^= 0x80;
+        ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy), bad, r_len, key_rec, &k_len);
+        CHECK(ret == FE_FAIL_DECODE, "multi byte %zu corrupted: ret %d", offs[j], ret);
+    }
+
+    ret = fe_reproduce_multi(ctx, noisy, sizeof(noisy), record, r_len, key_rec, &k_len);
+    CHECK(ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0, "multi genuine ret %d", ret);
+}
+
+/* ===== [Store] 저장소 파일 ===== */
+static void test_store(fe_ctx *ctx) {
+    uint8_t inputs[STORE_ENTRIES * FE_DATA_BYTES], records[STORE_ENTRIES * FE_RECORD_BYTES];
+    uint8_t keys_org[STORE_ENTRIES * FE_KEY_LEN], keys[STORE_ENTRIES * FE_KEY_LEN];
+    int status[STORE_ENTRIES];
+    size_t k_len, len, commits_off = 0;
+    fe_store *store;
+
+    rng_fill(inputs, sizeof(inputs));
+    for (int i = 0; i < STORE_ENTRIES; i++) {
+        size_t r_len = FE_RECORD_BYTES;
+        CHECK(fe_enroll_record(ctx, inputs + i * FE_DATA_BYTES, FE_DATA_BYTES, records + i * FE_RECORD_BYTES,
+                               &r_len, keys_org + i * FE_KEY_LEN, &k_len) == FE_SUCCESS, "enroll %d", i);
+        flip_bits(inputs + i * FE_DATA_BYTES, FE_DATA_BYTES * 8, SYS_T / 2, NULL);
+    }
+    CHECK(fe_store_write(ctx, STORE_PATH, records, STORE_ENTRIES) == FE_SUCCESS, "fe_store_write");
+
+    // 헤더가 손상된 레코드는 저장하지 않음
+    records[0] ^= 0x01;
+    CHECK(fe_store_write(ctx, STORE_PATH ".bad", records, STORE_ENTRIES) == FE_FAIL_PARAM,
+          "fe_store_write accepted a bad record");
+    records[0] ^= 0x01;
+
+    uint8_t *file = read_file(STORE_PATH, &len);
+    CHECK(file != NULL && len > STORE_HDR_BYTES, "read %s", STORE_PATH);
+    if (!file) return;
+
+    store = fe_store_open(STORE_PATH);
+    CHECK(store && fe_store_count(store) == STORE_ENTRIES, "fe_store_open");
+    if (store) {
+        commits_off = STORE_HDR_BYTES + (size_t)(fe_store_commits(store) - fe_store_helpers(store));
+        fe_store_close(store);
+    }
+
+    // 1. 헤더 64바이트: 모든 비트 반전 거절
+    for (int i = 0; i < STORE_HDR_BYTES * 8; i++) {
+        file[i / 8] ^= (uint8_t)(1 << (i % 8));
+        write_file(STORE_PATH, file, len);
+        store = fe_store_open(STORE_PATH);
+        CHECK(store == NULL, "store header byte %d bit %d accepted", i / 8, i % 8);
+        fe_store_close(store);
+        file[i / 8] ^= (uint8_t)(1 << (i % 8));
+    }
+
+    // 2. 잘린 파일 / 빈 파일 / 없는 파일
+    write_file(STORE_PATH, file, len - 1);
+    CHECK(fe_store_open(STORE_PATH) == NULL, "truncated store accepted");
+    write_file(STORE_PATH, file, STORE_HDR_BYTES - 1);
+    CHECK(fe_store_open(STORE_PATH) == NULL, "store without header accepted");
+    write_file(STORE_PATH, file, 0);
+    CHECK(fe_store_open(STORE_PATH) == NULL, "empty store accepted");
+    remove(STORE_PATH);
+    CHECK(fe_store_open(STORE_PATH) == NULL, "missing store accepted");
+    CHECK(fe_store_open(NULL) == NULL, "NULL path accepted");
+
+    // 3. 항목 k의 커밋 손상: 그 항목만 FE_FAIL_DECODE
+    const int k = 3;
+    file[commits_off + k * FE_KEY_LEN] ^= 0x01;
+    write_file(STORE_PATH, file, len);
+    store = fe_store_open(STORE_PATH);
+    CHECK(store != NULL, "store with a bad commit rejected at open");
+    if (store) {
+        int ok = fe_reproduce_batch_store(ctx, store, 0, inputs, STORE_ENTRIES, keys, status);
+        CHECK(ok == STORE_ENTRIES - 1, "batch store ok %d", ok);
+        for (int i = 0; i < STORE_ENTRIES; i++) {
+            if (i == k) {
+                CHECK(status[i] == FE_FAIL_DECODE, "entry %d (bad commit) status %d", i, status[i]);
+                continue;
+            }
+            CHECK(status[i] == FE_SUCCESS && memcmp(keys + i * FE_KEY_LEN, keys_org + i * FE_KEY_LEN,
+                                                    FE_KEY_LEN) == 0, "entry %d status %d", i, status[i]);
+        }
+        CHECK(fe_reproduce_batch_store(ctx, store, 1, inputs, STORE_ENTRIES, keys, status) < 0,
+              "batch store past the end accepted");
+        fe_store_close(store);
+    }
+
+    remove(STORE_PATH);
+    free(file);
+}
+
+/* ===== [Image] BCH 테이블 이미지 ===== */
+static void test_image_buf(int encoder) {
+    struct bch_config cfg = { 0 };
+    cfg.encoder = encoder;
+    struct bch_control *bch = init_bch_cfg(GFBITS, SYS_T, 0, &cfg), *img;
+    CHECK(bch != NULL, "init_bch_cfg encoder %d", encoder);
+    if (!bch) return;
+    size_t size = bch_image_size(bch);
+    uint64_t *buf = (uint64_t *)calloc(size / 8 + 2, 8);
+    uint8_t *image = (uint8_t *)buf;
+
+    CHECK(bch_image_write(bch, image, size) == size, "bch_image_write encoder %d", encoder);
+    img = init_bch_image(image, size, GFBITS, SYS_T, 0, &cfg);
+    CHECK(img != NULL, "valid image rejected (encoder %d)", encoder);
+    free_bch(img);
+
+    // 1. 헤더 영역 (BCH_IMAGE_HDR_BYTES = 192) 모든 비트 반전
+    for (int i = 0; i < 192 * 8; i++) {
+        image[i / 8] ^= (uint8_t)(1 << (i % 8));
+        img = init_bch_image(image, size, GFBITS, SYS_T, 0, &cfg);
+        CHECK(img == NULL, "encoder %d image header byte %d bit %d accepted", encoder, i / 8, i % 8);
+        free_bch(img);
+        image[i / 8] ^= (uint8_t)(1 << (i % 8));
+    }
+
+    // 2. 본문 손상 (체크섬)
+    for (int j = 0; j < 16; j++) {
+        size_t off = 192 + (size_t)(rng_next() % (size - 192));
+        image[off] ^= 0x10;
+        img = init_bch_image(image, size, GFBITS, SYS_T, 0, &cfg);
+        CHECK(img == NULL, "encoder %d image body byte %zu accepted", encoder, off);
+        free_bch(img);
+        image[off] ^= 0x10;
+    }
+
+    // 3. 크기 / 정렬 / 다른 파라미터
+    img = init_bch_image(image, size - 8, GFBITS, SYS_T, 0, &cfg);
+    CHECK(img == NULL, "short image accepted");
+    free_bch(img);
+    img = init_bch_image(image, size + 8, GFBITS, SYS_T, 0, &cfg);
+    CHECK(img == NULL, "long image accepted");
+    free_bch(img);
+    img = init_bch_image(image, 100, GFBITS, SYS_T, 0, &cfg);
+    CHECK(img == NULL, "image smaller than its header accepted");
+    free_bch(img);
+    img = init_bch_image(image, size, GFBITS, SYS_T - 1, 0, &cfg);
+    CHECK(img == NULL, "image for another t accepted");
+    free_bch(img);
+    memmove(image + 1, image, size);
+    img = init_bch_image(image + 1, size, GFBITS, SYS_T, 0, &cfg);
+    CHECK(img == NULL, "misaligned image accepted");
+    free_bch(img);
+
+    free(buf);
+    free_bch(bch);
+}
+
+// 손상된 tables_path: 생성은 성공하고 테이블을 직접 계산
+static void test_tables_file(void) {
+    fe_ctx_params params;
+    uint8_t input[FE_DATA_BYTES], record[FE_RECORD_BYTES], key_org[FE_KEY_LEN], key_rec[FE_KEY_LEN];
+    size_t r_len = sizeof(record), k_len, len;
+
+    fe_ctx_params_default(&params);
+    params.num_threads = 1;
+    params.tables_path = TABLES_PATH;
+    fe_ctx *ctx = fe_ctx_create_ex(&params);
+    CHECK(ctx && !fe_ctx_tables_mapped(ctx), "missing tables file");
+    if (!ctx) return;
+    CHECK(fe_tables_save(ctx->bch, TABLES_PATH) == 0, "fe_tables_save");
+    rng_fill(input, sizeof(input));
+    CHECK(fe_enroll_record(ctx, input, sizeof(input), record, &r_len, key_org, &k_len) == FE_SUCCESS,
+          "enroll for tables");
+    fe_ctx_destroy(ctx);
+
+    uint8_t *file = read_file(TABLES_PATH, &len);
+    CHECK(file != NULL, "read %s", TABLES_PATH);
+    if (!file) return;
+    // magic, ecc_bits, 체크섬, off[0], 헤더 패딩, 본문
+    const size_t offs[] = { 0, 20, 40, 48, 160, len / 2, len - 1 };
+    for (size_t j = 0; j <= sizeof(offs) / sizeof(offs[0]); j++) {
+        // j == 0: 손상 없음 (매핑), 그 뒤로는 한 바이트씩 손상 (직접 계산)
+        if (j) file[offs[j - 1]] ^= 0x04;
+        write_file(TABLES_PATH, file, len);
+        if (j) file[offs[j - 1]] ^= 0x04;
+        ctx = fe_ctx_create_ex(&params);
+        CHECK(ctx != NULL, "tables case %zu: fe_ctx_create_ex", j);
+        if (!ctx) continue;
+        CHECK(fe_ctx_tables_mapped(ctx) == (j == 0), "tables case %zu: mapped %d", j,
+              fe_ctx_tables_mapped(ctx));
+        int ret = fe_reproduce_record(ctx, input, sizeof(input), record, r_len, key_rec, &k_len);
+        CHECK(ret == FE_SUCCESS && memcmp(key_rec, key_org, FE_KEY_LEN) == 0,
+              "tables case %zu: reproduce ret %d", j, ret);
+        fe_ctx_destroy(ctx);
+    }
+    write_file(TABLES_PATH, file, 64);
+    ctx = fe_ctx_create_ex(&params);
+    CHECK(ctx && !fe_ctx_tables_mapped(ctx), "truncated tables file mapped");
+    fe_ctx_destroy(ctx);
+
+    remove(TABLES_PATH);
+    free(file);
+}
+
+int main(void) {
+    fe_ctx_params params;
+    fe_ctx_params_default(&params);
+    params.num_threads = 2;
+    fe_ctx *ctx = fe_ctx_create_ex(&params);
+    CHECK(ctx != NULL, "fe_ctx_create_ex");
+    if (!ctx) return FE_TEST_RESULT("test_parse");
+
+    test_record(ctx);
+    test_multi_record(ctx);
+    test_store(ctx);
+    test_image_buf(BCH_ENC_TABLE);
+    test_image_buf(BCH_ENC_CLMUL);
+    test_tables_file();
+
+    fe_ctx_destroy(ctx);
+    return FE_TEST_RESULT("test_parse");
+}